@@ -422,6 +422,11 @@ BOCHSAPI extern logfunc_t *genlog;
 void bx_gdbstub_init(int argc, char* argv[]);
 int bx_gdbstub_check(unsigned int eip);
 #define GDBSTUB_STOP_NO_REASON   (0xac0)
+// gdb watchpoints (Z2/Z3/Z4) are checked by the memory subsystem
+extern unsigned bx_gdbstub_nr_watchpoints;
+void bx_gdbstub_check_watch(Bit32u paddr, unsigned len, unsigned rw);
+bx_bool bx_gdbstub_watch_veto(Bit32u paddr, unsigned op);
+void bx_gdbstub_paging_changed(void);
 
 #if BX_SMP_PROCESSORS!=1
 #error GDB stub was written for single processor support.  If multiprocessor support is added, then we can remove this check.
@@ -485,6 +490,7 @@ BOCHSAPI extern bx_debug_t bx_dbg;
 #define BX_READ         0
 #define BX_WRITE        1
 #define BX_RW           2
+#define BX_EXECUTE      3  // instruction fetch, only for getHostMemAddr()
 
 #define DATA_ACCESS     0
 #define CODE_ACCESS     1
@@ -496,6 +502,10 @@ BOCHSAPI extern bx_debug_t bx_dbg;
 enum PCS_OP { PCS_CLEAR, PCS_SET, PCS_TOGGLE };
 
 #include "pc_system.h"
+#include "profiler.h"
+#include "stats.h"
+#include "symbols.h"
+#include "replay.h"
 #include "plugin.h"
 #include "gui/gui.h"
 #include "gui/textconfig.h"
@@ -547,6 +557,30 @@ typedef struct {
   bx_param_bool_c *Ortc_init;
 } bx_cmosimage_options;
 
+typedef struct {
+  bx_param_bool_c *Oenabled;
+  bx_param_string_c *Odir;
+  bx_param_string_c *Olog;
+} bx_g2h_options;
+
+typedef struct {
+  bx_param_bool_c *Oenabled;
+  bx_param_num_c *Operiod;
+  bx_param_string_c *Ofile;
+  bx_param_string_c *Osymbols;
+} bx_profile_options;
+
+typedef struct {
+  bx_param_bool_c *Oenabled;
+  bx_param_num_c *Operiod;
+  bx_param_string_c *Ofile;
+} bx_stats_options;
+
+typedef struct {
+  bx_param_enum_c *Omode;
+  bx_param_string_c *Ofile;
+} bx_replay_options;
+
 typedef struct {
   bx_param_num_c   *Otime0;
   bx_param_enum_c  *Osync;
@@ -640,6 +674,7 @@ typedef struct BOCHSAPI {
   bx_param_num_c    *Ovga_update_interval;
   bx_param_num_c    *Okeyboard_serial_delay;
   bx_param_num_c    *Okeyboard_paste_delay;
+  bx_param_filename_c *Okeyboard_inject;
   bx_param_enum_c   *Okeyboard_type;
   bx_param_num_c    *Oips;
   bx_param_bool_c   *Orealtime_pit;
@@ -654,6 +689,10 @@ typedef struct BOCHSAPI {
   bx_param_bool_c   *Oi440FXSupport;
   bx_pcidev_options pcidev;
   bx_cmosimage_options   cmosimage;
+  bx_g2h_options    g2h;
+  bx_profile_options profile;
+  bx_stats_options  stats;
+  bx_replay_options replay;
   bx_clock_options  clock;
   bx_ne2k_options   ne2k;
   bx_load32bitOSImage_t load32bitOSImage;
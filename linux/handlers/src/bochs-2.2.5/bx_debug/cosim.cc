@@ -366,49 +366,74 @@ bx_bool bx_dbg_compare_sim_cpu(void)
 
 void clear_dirty_bits (void)
 {
-  int num_pages = bx_options.memory.Osize->get () * 1024 / 4;
-  for (int i = 0; i < num_pages; i++) {
-    BX_MEM(0)->dbg_dirty_pages[i] = 0;
-    BX_MEM(1)->dbg_dirty_pages[i] = 0;
-  }
+  BX_MEM(0)->dbg_clear_dirty();
+  BX_MEM(1)->dbg_clear_dirty();
 }
 
 bx_bool always_check_page[128 * 1024 / 4];
+unsigned always_check_count = 0;
 
 void bx_dbg_always_check(Bit32u page_start, bx_bool on)
 {
-  always_check_page[page_start / (4 * 1024)] = on;
+  unsigned i = page_start / (4 * 1024);
+  if (always_check_page[i] != on) {
+    always_check_page[i] = on;
+    if (on) always_check_count++;
+    else    always_check_count--;
+  }
   printf("Forced check on page %08x %s\n",
          page_start, on ? "enabled" : "disabled");
 }
 
+static bx_bool bx_dbg_compare_sim_page(Bit32u i)
+{
+  Bit32u page_start = i * 1024 * 4;
+
+  // (mch) I'm quite aware of how hackish this is. I don't care.
+  extern Bit8u* SIM1_GET_PHYS_PTR(Bit32u page_start);
+  Bit8u* sim0_page_vec = bx_mem0.vector + page_start;
+  Bit8u* sim1_page_vec = SIM1_GET_PHYS_PTR(page_start);
+
+  if (memcmp(sim0_page_vec, sim1_page_vec, 1024 * 4)) {
+    printf("COSIM ERROR  Physical page %08x differs in content\n", page_start);
+    for (int j = 0; j < 1024 * 4; j++) {
+      if (sim0_page_vec[j] != sim1_page_vec[j]) {
+        printf("%08x   %s: %02x  %s: %02x\n",
+               page_start+j, SIM_NAME0, sim0_page_vec[j], SIM_NAME1_STR, sim1_page_vec[j]);
+      }
+    }
+    return 1;
+  }
+  return 0;
+}
+
+// Only the pages written by either simulator since the last sync are
+// compared (plus the forced ones), so the cost of a check depends on the
+// guest's write set, not on the memory size.
 bx_bool bx_dbg_compare_sim_memory(void)
 {
   bx_bool ret = 0;
-  int num_pages = bx_options.memory.Osize->get () * 1024 / 4;
-
-  for (int i = 0; i < num_pages; i++) {
-    bx_bool sim0_dirty = BX_MEM(0)->dbg_dirty_pages[i];
-    bx_bool sim1_dirty = BX_MEM(1)->dbg_dirty_pages[i];
-    Bit32u page_start = i * 1024 * 4;
-
-    if ((sim0_dirty != sim1_dirty) || sim0_dirty || always_check_page[i]) {
-      // Page has been written, compare
-      // (mch) I'm quite aware of how hackish this is. I don't care.
-      extern Bit8u* SIM1_GET_PHYS_PTR(Bit32u page_start);
-      Bit8u* sim0_page_vec = bx_mem0.vector + page_start;
-      Bit8u* sim1_page_vec = SIM1_GET_PHYS_PTR(page_start);
-
-      if (memcmp(sim0_page_vec, sim1_page_vec, 1024 * 4)) {
-        printf("COSIM ERROR  Physical page %08x differs in content\n", page_start);
-        for (int j = 0; j < 1024 * 4; j++) {
-          if (sim0_page_vec[j] != sim1_page_vec[j]) {
-            printf("%08x   %s: %02x  %s: %02x\n",
-                   page_start+j, SIM_NAME0, sim0_page_vec[j], SIM_NAME1_STR, sim1_page_vec[j]);
-          }
-        }
+  Bit32u num_pages = bx_options.memory.Osize->get () * 1024 / 4;
+  Bit32u i, n;
+
+  for (n = 0; n < BX_MEM(0)->dbg_dirty_count; n++) {
+    i = BX_MEM(0)->dbg_dirty_list[n];
+    if (i < num_pages && bx_dbg_compare_sim_page(i))
+      ret = 1;
+  }
+  for (n = 0; n < BX_MEM(1)->dbg_dirty_count; n++) {
+    i = BX_MEM(1)->dbg_dirty_list[n];
+    if (BX_MEM(0)->dbg_dirty_pages[i]) continue; // already compared
+    if (i < num_pages && bx_dbg_compare_sim_page(i))
+      ret = 1;
+  }
+  if (always_check_count) {
+    for (i = 0; i < num_pages && i < 128 * 1024 / 4; i++) {
+      if (!always_check_page[i]) continue;
+      if (BX_MEM(0)->dbg_dirty_pages[i] || BX_MEM(1)->dbg_dirty_pages[i])
+        continue;
+      if (bx_dbg_compare_sim_page(i))
         ret = 1;
-      }
     }
   }
 
@@ -219,8 +219,84 @@ static struct {
 
 // some buffers for disassembly
 #if BX_DISASM
+static disassembler bx_disassemble;
 static Bit8u bx_disasm_ibuf[32];
 static char  bx_disasm_tbuf[512];
+
+#if BX_SUPPORT_ICACHE
+// With 'trace on' the same instructions are disassembled over and over,
+// so the formatted lines of instructions on iCache code pages are kept
+// by physical address.  A line stays valid as long as the write stamp
+// of its page (see cpu/icache.h) does not change.
+#define BX_DBG_DISASM_CACHE_SIZE  4096   // must be a power of 2
+#define BX_DBG_DISASM_LINE_LEN    96
+
+static struct {
+  Bit32u phy;
+  Bit32u stamp;         // 0 never matches the stamp of a code page
+  Bit32u reset_count;
+  Bit8u  mode;          // bit0: 32-bit code, bit1: 64-bit code
+  Bit8u  ilen;
+  char   line[BX_DBG_DISASM_LINE_LEN];
+} bx_dbg_disasm_cache[BX_DBG_DISASM_CACHE_SIZE];
+#endif
+
+static const char bx_dbg_hex_digits[] = "0123456789abcdef";
+
+// Disassemble the instruction at physical address 'phy' into a line of
+// the form "<instruction, padded to 25 chars> ; <opcode bytes>" and
+// return its length.
+static unsigned bx_dbg_disasm_line(BX_MEM_C *mem, Bit32u phy, bx_bool is_32,
+    bx_bool is_64, bx_address base, bx_address ip, const char **line)
+{
+  unsigned ilen;
+
+#if BX_SUPPORT_ICACHE
+  Bit8u  mode = (is_32 ? 1 : 0) | (is_64 ? 2 : 0);
+  Bit32u stamp = pageWriteStampTable.getPageWriteStamp(phy);
+  Bit32u reset_count = pageWriteStampTable.getResetCount();
+  unsigned hash = (phy ^ (phy >> 12)) & (BX_DBG_DISASM_CACHE_SIZE-1);
+
+  if (bx_dbg_disasm_cache[hash].phy == phy &&
+      bx_dbg_disasm_cache[hash].stamp == stamp &&
+      bx_dbg_disasm_cache[hash].reset_count == reset_count &&
+      bx_dbg_disasm_cache[hash].mode == mode)
+  {
+    *line = bx_dbg_disasm_cache[hash].line;
+    return bx_dbg_disasm_cache[hash].ilen;
+  }
+#endif
+
+  mem->dbg_fetch_mem(phy, 16, bx_disasm_ibuf);
+  ilen = bx_disassemble.disasm(is_32, is_64, base, ip, bx_disasm_ibuf, bx_disasm_tbuf);
+
+  char *p = bx_disasm_tbuf + strlen(bx_disasm_tbuf);
+  while (p < bx_disasm_tbuf + 25) *p++ = ' ';
+  *p++ = ' '; *p++ = ';'; *p++ = ' ';
+  for (unsigned j=0; j<ilen; j++) {
+    *p++ = bx_dbg_hex_digits[bx_disasm_ibuf[j] >> 4];
+    *p++ = bx_dbg_hex_digits[bx_disasm_ibuf[j] & 0xf];
+  }
+  *p = 0;
+
+#if BX_SUPPORT_ICACHE
+  // Writes are only tracked on pages the iCache holds code for, and only
+  // for the page the instruction starts on.
+  if ((stamp & iCachePageDataMask) && (phy & 0xfff) + ilen <= 0x1000 &&
+      p - bx_disasm_tbuf < BX_DBG_DISASM_LINE_LEN)
+  {
+    bx_dbg_disasm_cache[hash].phy = phy;
+    bx_dbg_disasm_cache[hash].stamp = stamp;
+    bx_dbg_disasm_cache[hash].reset_count = reset_count;
+    bx_dbg_disasm_cache[hash].mode = mode;
+    bx_dbg_disasm_cache[hash].ilen = ilen;
+    memcpy(bx_dbg_disasm_cache[hash].line, bx_disasm_tbuf, p - bx_disasm_tbuf + 1);
+  }
+#endif
+
+  *line = bx_disasm_tbuf;
+  return ilen;
+}
 #endif
 
 void dbg_printf (const char *fmt, ...)
@@ -406,10 +482,14 @@ process_sim2:
 #endif
 
   // (mch) Moved from main.cc
+  bx_replay.init();
   DEV_init_devices();
   DEV_reset_devices(BX_RESET_HARDWARE);
   bx_gui->init_signal_handlers ();
   bx_pc_system.start_timers();
+#if BX_SUPPORT_STATS
+  bx_stats.init();
+#endif
 
   // Just like in main.cc before set_init_done()
   if (bx_options.load32bitOSImage.OwhichOS->get ()) {
@@ -837,7 +917,7 @@ void bx_dbg_diff_memory(void)
 #else
   int num_pages = bx_options.memory.Osize->get () * 1024 / 4;
   for (int i = 0; i < num_pages; i++) {
-    BX_CPU(dbg_cpu)->dbg_dirty_pages[i] = 1;
+    BX_MEM(0)->dbg_mark_dirty(i);
   }
   if (bx_dbg_compare_sim_memory())
     printf("[diff-memory] Diff detected\n");
@@ -893,16 +973,13 @@ void bx_dbg_fast_forward(Bit32u num)
     printf("Error copying CPU data!\n");
 
   printf("Copying memory...\n");
-  int num_pages = bx_options.memory.Osize->get () * 1024 / 4;
-  for (int i = 0; i < num_pages; i++) {
-    if (BX_CPU(0)->dbg_dirty_pages[i]) {
-      Bit32u page_start = i * 1024 * 4;
-      printf("Copying page %08x\n", page_start);
-      extern Bit8u* SIM1_GET_PHYS_PTR(Bit32u page_start);
-      Bit8u* sim0_page_vec = bx_mem0.vector + page_start;
-      Bit8u* sim1_page_vec = SIM1_GET_PHYS_PTR(page_start);
-      memcpy(sim1_page_vec, sim0_page_vec, 1024 * 4);
-    }
+  for (Bit32u n = 0; n < BX_MEM(0)->dbg_dirty_count; n++) {
+    Bit32u page_start = BX_MEM(0)->dbg_dirty_list[n] * 1024 * 4;
+    printf("Copying page %08x\n", page_start);
+    extern Bit8u* SIM1_GET_PHYS_PTR(Bit32u page_start);
+    Bit8u* sim0_page_vec = bx_mem0.vector + page_start;
+    Bit8u* sim1_page_vec = SIM1_GET_PHYS_PTR(page_start);
+    memcpy(sim1_page_vec, sim0_page_vec, 1024 * 4);
   }
 
   printf("Taking async events...\n");
@@ -1321,251 +1398,67 @@ void bx_dbg_print_stack_command(int nwords)
   }
 }
 
-#if !((BX_HAVE_HASH_MAP || BX_HAVE_HASH_MAP_H) && (BX_HAVE_SET || BX_HAVE_SET_H))
-
-static char *BX_HAVE_HASH_MAP_ERR = "context not implemented because BX_HAVE_HASH_MAP=0\n";
-
-char* bx_dbg_symbolic_address(Bit32u context, Bit32u eip, Bit32u base)
-{
-  static bx_bool first = true;
-  if (first) {
-    dbg_printf ( BX_HAVE_HASH_MAP_ERR);
-    first = false;
-  }
-  return "unk. ctxt";
-}
-
-char* bx_dbg_symbolic_address_16bit(Bit32u eip, Bit32u cs)
-{
-  // just prints an error anyway
-  return bx_dbg_symbolic_address (0,0,0);
-}
+// Symbol tables are kept in symbols.cc, shared with the profiler.
 
-void bx_dbg_symbol_command(char* filename, bx_bool global, Bit32u offset)
+static void bx_dbg_strip_quotes(char **str)
 {
-  dbg_printf ( BX_HAVE_HASH_MAP_ERR);
-}
-
-void bx_dbg_info_symbols_command(char *Symbol)
-{
-  dbg_printf ( BX_HAVE_HASH_MAP_ERR);
-}
-
-int bx_dbg_lbreakpoint_symbol_command(char *Symbol)
-{
-  dbg_printf ( BX_HAVE_HASH_MAP_ERR);
-  return -1;
+  char *s = *str;
+  if (s[0] == '"') s++;
+  int len = strlen(s);
+  if (len > 0 && s[len - 1] == '"') s[len - 1] = '\0';
+  *str = s;
 }
 
 Bit32u bx_dbg_get_symbol_value(char *Symbol)
 {
-  return 0;
-}
-
-char* bx_dbg_disasm_symbolic_address(Bit32u eip, Bit32u base)
-{
-  return 0;
-}
-
-#else   /* if BX_HAVE_HASH_MAP == 1 */
-
-/* Haven't figured out how to port this code to OSF1 cxx compiler.
-   Until a more portable solution is found, at least make it easy
-   to disable the template code:  just set BX_HAVE_HASH_MAP=0
-   in config.h */
-#if BX_HAVE_HASH_MAP
-#include <hash_map>
-#elif BX_HAVE_HASH_MAP_H
-#include <hash_map.h>
-#endif
-
-#if BX_HAVE_SET
-#include <set>
-#elif BX_HAVE_SET_H
-#include <set.h>
-#endif
-
-using namespace std;
-
-struct symbol_entry_t
-{
-  symbol_entry_t (Bit32u _start = 0, char* _name = 0)
-  {
-    start = _start;
-    name = _name;
-  }
-
-  char* name;
-  Bit32u start;
-};
-
-struct lt_symbol_entry_t
-{
-  bool operator()(const symbol_entry_t* s1, const symbol_entry_t* s2) const
-  {
-    return s1->start < s2->start;
-  }
-};
-
-struct lt_rsymbol_entry_t
-{
-  bool operator()(const symbol_entry_t* s1, const symbol_entry_t* s2) const
-  {
-    return strcoll(s1->name, s2->name) < 0;
-  }
-};
-
-struct context_t
-{
-  context_t (Bit32u);
-  ~context_t();
-  static context_t* get_context(Bit32u);
-  symbol_entry_t* get_symbol_entry(Bit32u);
-  symbol_entry_t* get_symbol_entry(const char *Symbol) const;
-  void add_symbol(symbol_entry_t*);
-  const set<symbol_entry_t*,lt_symbol_entry_t>* get_all_symbols() const {return syms;}
-  const set<symbol_entry_t*,lt_rsymbol_entry_t>* get_all_rsymbols() const {return rsyms;}
-private:
-  static hash_map<int,context_t*>* map;
-  // Forvard references (find name by address)
-  set<symbol_entry_t*,lt_symbol_entry_t>* syms;
-  // Reverse references (find address by name)
-  set<symbol_entry_t*,lt_rsymbol_entry_t>* rsyms;
-  Bit32u id;
-};
-
-hash_map<int,context_t*>* context_t::map = new hash_map<int,context_t*>;
-
-context_t::context_t (Bit32u _id)
-{
-  id = _id;
-  syms = new set<symbol_entry_t*, lt_symbol_entry_t>;
-  rsyms = new set<symbol_entry_t*, lt_rsymbol_entry_t>;
-  (*map)[id] = this;
-}
-
-context_t::~context_t()
-{
- set<symbol_entry_t*>::iterator iter;
- if(syms) {
-  for(iter=syms->begin();iter!=syms->end();++iter)
-   if(*iter)
-    delete *iter;
- }
-
- if(rsyms) {
-  for(iter=rsyms->begin();iter!=rsyms->end();++iter)
-   if(*iter)
-    delete *iter;
- }
-}
-
-context_t* context_t::get_context(Bit32u i)
-{
-  return (*map)[i];
-}
-
-symbol_entry_t* context_t::get_symbol_entry(Bit32u ip)
-{
-  symbol_entry_t probe;
-  probe.start = ip;
-  // find the first symbol whose address is greater than ip.
-  if (syms->empty ()) return 0;
-  set<symbol_entry_t*>::iterator iter = syms->upper_bound(&probe);
+  bx_symbol_table_c *cntx = bx_symbol_context(0, 0);
+  Bit32u addr;
 
-  if (iter == syms->end()) { // No symbol found
+  if (!cntx) // Context not found
     return 0;
-  }
-
-  return *(--iter);
-}
-
-symbol_entry_t* context_t::get_symbol_entry(const char *Symbol) const
-{
-  symbol_entry_t probe;
-  probe.name=(char *)Symbol;
-
-  if (rsyms->empty ()) 
-   return 0;
-
-  set<symbol_entry_t*>::const_iterator iter;
-  iter=rsyms->find(&probe);
-  if(iter==rsyms->end()) // No symbol found
-   return 0;
-  return *iter;
-}
-
-void context_t::add_symbol(symbol_entry_t* sym)
-{
-  syms->insert(sym);
-  rsyms->insert(sym);
-}
-
-Bit32u bx_dbg_get_symbol_value(char *Symbol)
-{
- context_t* cntx = context_t::get_context(0);
- if(!cntx) // Context not found
-  return 0;
 
- if (Symbol[0]=='\"') Symbol++;
- int len = strlen(Symbol);
- if (Symbol[len - 1] == '\"') Symbol[len - 1] = '\0';
-
- symbol_entry_t* sym=cntx->get_symbol_entry(Symbol);
- if(!sym) // Symbol not found
-  return 0;
-
- return sym->start;
+  bx_dbg_strip_quotes(&Symbol);
+  if (!cntx->find(Symbol, &addr)) // Symbol not found
+    return 0;
+  return addr;
 }
 
 char* bx_dbg_symbolic_address(Bit32u context, Bit32u eip, Bit32u base)
 {
   static char buf[80];
-#if 0
-  // bbd: I don't see why we shouldn't allow symbol lookups on
-  // segments with a nonzero base.  I need to trace user 
-  // processes in Linux, which have a base of 0xc0000000.
-  if (base != 0) {
-    snprintf (buf, 80, "non-zero base");
+  Bit32u offset;
+
+  if (!bx_symbol_context(context, 0) && !bx_symbol_context(0, 0)) {
+    snprintf (buf, 80, "unk. ctxt");
     return buf;
   }
-#endif
-  // Look up this context
-  context_t* cntx = context_t::get_context(context);
-  if (!cntx) {
-    // Try global context
-    cntx = context_t::get_context(0);
-    if (!cntx) {
-      snprintf (buf, 80, "unk. ctxt");
-      return buf;
-    }
-  }
   // full linear address not only eip (for nonzero based segments)
-  symbol_entry_t* entr = cntx->get_symbol_entry(base+eip); 
-  if (!entr) {
+  const char *name = bx_symbol_lookup(context, base+eip, &offset);
+  if (!name) {
     snprintf (buf, 80, "no symbol");
     return buf;
   }
-  snprintf (buf, 80, "%s+%x", entr->name, (base+eip) - entr->start);
+  snprintf (buf, 80, "%s+%x", name, offset);
   return buf;
 }
 
 char* bx_dbg_disasm_symbolic_address(Bit32u eip, Bit32u base)
 {
   static char buf[80];
+  Bit32u offset;
 
   // Try global context
-  context_t* cntx = context_t::get_context(0);
+  bx_symbol_table_c *cntx = bx_symbol_context(0, 0);
   if (!cntx) {
     return 0;
   }
 
   // full linear address not only eip (for nonzero based segments)
-  symbol_entry_t* entr = cntx->get_symbol_entry(base+eip); 
-  if (!entr) {
+  const char *name = cntx->lookup(base+eip, &offset);
+  if (!name) {
     return 0;
   }
-  snprintf (buf, 80, "%s+%x", entr->name, (base+eip) - entr->start);
+  snprintf (buf, 80, "%s+%x", name, offset);
   return buf;
 }
 
@@ -1580,141 +1473,98 @@ char* bx_dbg_symbolic_address_16bit(Bit32u eip, Bit32u cs)
 
 void bx_dbg_symbol_command(char* filename, bx_bool global, Bit32u offset)
 {
-  if (filename[0] == '"')
-    filename++;
-  int len = strlen(filename);
-  if (filename[len - 1] == '"')
-    filename[len - 1] = '\0';
+  bx_dbg_strip_quotes(&filename);
 
   // Install symbols in correct context (page table)
   // The file format should be
   // address symbol (example '00002afe _StartLoseNT')
-  
-  context_t* cntx = (global) ? context_t::get_context(0)
-      : context_t::get_context((BX_CPU(dbg_cpu)->cr3) >> 12);
-
+  // or the output of nm or a System.map ('c0100000 T startup_32')
+  bx_symbol_table_c *cntx = bx_symbol_context(
+      global ? 0 : (BX_CPU(dbg_cpu)->cr3 >> 12), 1);
   if (!cntx) {
-    cntx = (global) ? new context_t(0)
-       : new context_t((BX_CPU(dbg_cpu)->cr3) >> 12);
+    dbg_printf ("Too many symbol contexts\n");
+    return;
   }
 
-  FILE* fp = fopen(filename, "rt"); // 't' is need for win32, unixes simply ignore it
-  if (!fp) {
+  int count = cntx->load(filename, offset);
+  if (count < 0) {
     dbg_printf ("Could not open symbol file '%s'\n", filename);
     return;
   }
-  char buf[200];
-  while (fgets(buf, 200, fp)) {
-    // Parse
-    char* sym_name = buf;
-    
-    for (int i = 0; i < 200 && buf[i]; i++) {
-      if (buf[i] == ' ') {
-        buf[i] = '\0';
-        sym_name = buf + i + 1;
-        break;
-      }
-    }
-    if (sym_name == buf) {
-      dbg_printf ("Syntax error '%s'\n", buf);
-      break;
-    }
-    Bit32u addr = strtoul(buf, 0, 16);
-    if (sym_name[strlen(sym_name)-1] == '\n')
-      sym_name[strlen(sym_name)-1] = '\0';
-    symbol_entry_t* sym = new symbol_entry_t(addr + offset, strdup(sym_name));
-    cntx->add_symbol(sym);
-  }
-}
-
-// chack if s1 is prefix of s2
-static bool bx_dbg_strprefix(const char *s1, const char *s2)
-{
-  if(!s1 || !s2)
-   return false;
-
-  size_t len=strlen(s1);
-
-  if(len>strlen(s2))
-   return false;
-  return strncmp(s1, s2, len)==0;
+  dbg_printf ("%d symbols loaded from '%s'\n", count, filename);
 }
 
 void bx_dbg_info_symbols_command(char *Symbol)
 {
-  context_t* cntx = context_t::get_context(0);
+  bx_symbol_table_c *cntx = bx_symbol_context(0, 0);
+  const char *name;
+  Bit32u addr;
 
   if(!cntx) {
    dbg_printf ("Global context not available\n");
    return;
   }
+  if (cntx->size () == 0) {
+   dbg_printf ("Symbols not loaded\n");
+   return;
+  }
 
   if(Symbol) {
-   const set<symbol_entry_t*,lt_rsymbol_entry_t>* rsyms;
-
-   rsyms=cntx->get_all_rsymbols();
-   if (rsyms->empty ()) {
-    dbg_printf ("Symbols not loaded\n");
-    return;
-   }
    // remove leading and trailing quotas
-   if (Symbol[0]=='\"') Symbol++;
-   int len = strlen(Symbol);
-   if (Symbol[len - 1] == '\"') Symbol[len - 1] = '\0';
-
-   symbol_entry_t probe;
-   probe.name=Symbol;
-   set<symbol_entry_t*>::const_iterator iter;
-   iter=rsyms->lower_bound(&probe);
-
-   if(iter==rsyms->end() || !bx_dbg_strprefix(Symbol, (*iter)->name))
+   bx_dbg_strip_quotes(&Symbol);
+   size_t len = strlen(Symbol);
+   int n = cntx->first_with_prefix(Symbol);
+   if (n < 0)
     dbg_printf ("No symbols found\n");
    else
-   for(;iter!=rsyms->end() && bx_dbg_strprefix(Symbol, (*iter)->name);++iter) {
-    dbg_printf ("%08x: %s\n", (*iter)->start, (*iter)->name);
+   for(; (name = cntx->get_by_name(n, &addr)) && !strncmp(Symbol, name, len); n++) {
+    dbg_printf ("%08x: %s\n", addr, name);
    }
   }
   else {
-   const set<symbol_entry_t*,lt_symbol_entry_t>* syms;
-
-   syms=cntx->get_all_symbols();
-   if (syms->empty ()) {
-    dbg_printf ("Symbols not loaded\n");
-    return;
-   }
-
-   set<symbol_entry_t*>::const_iterator iter;
-   for(iter = syms->begin();iter!=syms->end();++iter) {
-    dbg_printf ("%08x: %s\n", (*iter)->start, (*iter)->name);
+   for(unsigned n = 0; (name = cntx->get(n, &addr)); n++) {
+    dbg_printf ("%08x: %s\n", addr, name);
    }
   }
 }
 
 int bx_dbg_lbreakpoint_symbol_command(char *Symbol)
 {
- context_t* cntx = context_t::get_context(0);
+ bx_symbol_table_c *cntx = bx_symbol_context(0, 0);
+ Bit32u addr;
+
  if(!cntx) {
   dbg_printf ("Global context not available\n");
   return -1;
  }
- if (Symbol[0]=='\"') Symbol++;
- int len = strlen(Symbol);
- if (Symbol[len - 1] == '\"') Symbol[len - 1] = '\0';
+ bx_dbg_strip_quotes(&Symbol);
 
- const symbol_entry_t* sym=cntx->get_symbol_entry(Symbol);
- if(sym)
-  return bx_dbg_lbreakpoint_command(bkRegular, sym->start);
+ if(cntx->find(Symbol, &addr))
+  return bx_dbg_lbreakpoint_command(bkRegular, addr);
  dbg_printf ("Symbol not found\n");
  return -1;
 }
-#endif
 
 int num_write_watchpoints = 0;
 int num_read_watchpoints = 0;
 Bit32u write_watchpoint[MAX_WRITE_WATCHPOINTS];
 Bit32u read_watchpoint[MAX_READ_WATCHPOINTS];
+Bit32u write_watchpoint_pages[BX_DBG_PAGE_FILTER_BITS/32];
+Bit32u read_watchpoint_pages[BX_DBG_PAGE_FILTER_BITS/32];
 bx_bool watchpoint_continue = 0;
 
+static void bx_dbg_watchpoints_changed(void)
+{
+  int i;
+
+  memset(write_watchpoint_pages, 0, sizeof(write_watchpoint_pages));
+  memset(read_watchpoint_pages, 0, sizeof(read_watchpoint_pages));
+  for (i = 0; i < num_write_watchpoints; i++)
+    BX_DBG_PAGE_FILTER_SET(write_watchpoint_pages, write_watchpoint[i] >> 12);
+  for (i = 0; i < num_read_watchpoints; i++)
+    BX_DBG_PAGE_FILTER_SET(read_watchpoint_pages, read_watchpoint[i] >> 12);
+}
+
 void bx_dbg_watch(int read, Bit32u address)
 {
   if (read == -1) {
@@ -1742,6 +1592,7 @@ void bx_dbg_watch(int read, Bit32u address)
         return;
       }
       read_watchpoint[num_read_watchpoints++] = address;
+      bx_dbg_watchpoints_changed();
       dbg_printf ("Read watchpoint at %08x inserted\n", address);
     } else {
       if (num_write_watchpoints == MAX_WRITE_WATCHPOINTS) {
@@ -1749,6 +1600,7 @@ void bx_dbg_watch(int read, Bit32u address)
         return;
       }
       write_watchpoint[num_write_watchpoints++] = address;
+      bx_dbg_watchpoints_changed();
       dbg_printf ("Write watchpoint at %08x inserted\n", address);
     }
   }
@@ -1759,6 +1611,7 @@ void bx_dbg_unwatch(int read, Bit32u address)
   if (read == -1) {
     // unwatch all
     num_read_watchpoints = num_write_watchpoints = 0;
+    bx_dbg_watchpoints_changed();
     dbg_printf ("All watchpoints removed\n");
   } else {
     if (read) {
@@ -1916,8 +1769,6 @@ void bx_dbg_stepN_command(bx_dbg_icount_t count)
   bx_dbg_print_guard_results();
 }
 
-static disassembler bx_disassemble;
-
 void bx_dbg_disassemble_current (int which_cpu, int print_time)
 {
   Bit32u phy;
@@ -1933,16 +1784,14 @@ void bx_dbg_disassemble_current (int which_cpu, int print_time)
   BX_CPU(which_cpu)->dbg_xlate_linear2phy(BX_CPU(which_cpu)->guard_found.laddr, &phy, &valid);
 
   if (valid) {
-    unsigned ilen;
-
-    BX_CPU(which_cpu)->mem->dbg_fetch_mem(phy, 16, bx_disasm_ibuf);
-
+    const char *line;
     unsigned cpu_mode = BX_CPU(which_cpu)->get_cpu_mode();
 
-    ilen = bx_disassemble.disasm(BX_CPU(which_cpu)->guard_found.is_32bit_code, 
+    bx_dbg_disasm_line(BX_CPU(which_cpu)->mem, phy,
+      BX_CPU(which_cpu)->guard_found.is_32bit_code,
       cpu_mode == BX_MODE_LONG_64 /* is_64 */,
-      BX_CPU(which_cpu)->get_segment_base(BX_SEG_REG_CS), 
-      BX_CPU(which_cpu)->guard_found.eip, bx_disasm_ibuf, bx_disasm_tbuf);
+      BX_CPU(which_cpu)->get_segment_base(BX_SEG_REG_CS),
+      BX_CPU(which_cpu)->guard_found.eip, &line);
 
     // Note: it would be nice to display only the modified registers here, the easy
     // way out I have thought of would be to keep a prev_eax, prev_ebx, etc copies
@@ -1973,28 +1822,31 @@ void bx_dbg_disassemble_current (int which_cpu, int print_time)
     BX_CPU(which_cpu)->getB_RF (),
     BX_CPU(which_cpu)->getB_VM ());
 
+    // every dbg_printf() allocates an output buffer, so print the whole
+    // line at once
+    char cpu_str[40];
     if (print_time)
-      dbg_printf ("(%u).[" FMT_LL "d] ", which_cpu, bx_pc_system.time_ticks());
+      sprintf (cpu_str, "(%u).[" FMT_LL "d]", which_cpu, bx_pc_system.time_ticks());
     else
-      dbg_printf ("(%u) ", which_cpu);
+      sprintf (cpu_str, "(%u)", which_cpu);
     if (BX_CPU(which_cpu)->get_cpu_mode() == BX_MODE_IA32_PROTECTED) { // 16bit & 32bit protected mode
-      dbg_printf ("[0x%08x] %04x:%08x (%s): ", 
+      dbg_printf ("%s [0x%08x] %04x:%08x (%s): %s\n",
+        cpu_str,
 	phy,
         (unsigned) BX_CPU(which_cpu)->guard_found.cs,
         (unsigned) BX_CPU(which_cpu)->guard_found.eip,
-        bx_dbg_symbolic_address((BX_CPU(which_cpu)->cr3) >> 12, BX_CPU(which_cpu)->guard_found.eip, BX_CPU(which_cpu)->get_segment_base(BX_SEG_REG_CS)));
+        bx_dbg_symbolic_address((BX_CPU(which_cpu)->cr3) >> 12, BX_CPU(which_cpu)->guard_found.eip, BX_CPU(which_cpu)->get_segment_base(BX_SEG_REG_CS)),
+        line);
       }
     else { // Real & V86 mode
-      dbg_printf ("[0x%08x] %04x:%04x (%s): ", 
+      dbg_printf ("%s [0x%08x] %04x:%04x (%s): %s\n",
+        cpu_str,
 	phy,
         (unsigned) BX_CPU(which_cpu)->guard_found.cs,
         (unsigned) BX_CPU(which_cpu)->guard_found.eip,
-        bx_dbg_symbolic_address_16bit(BX_CPU(which_cpu)->guard_found.eip, BX_CPU(which_cpu)->sregs[BX_SEG_REG_CS].selector.value));
+        bx_dbg_symbolic_address_16bit(BX_CPU(which_cpu)->guard_found.eip, BX_CPU(which_cpu)->sregs[BX_SEG_REG_CS].selector.value),
+        line);
       }
-    dbg_printf ("%-25s ; ", bx_disasm_tbuf);
-    for (unsigned j=0; j<ilen; j++)
-      dbg_printf ("%02x", (unsigned) bx_disasm_ibuf[j]);
-    dbg_printf ("\n");
   }
   else {
     dbg_printf ("(%u).[" FMT_LL "d] ??? (physical address not available)\n", which_cpu, bx_pc_system.time_ticks());
@@ -2082,11 +1934,19 @@ for (sim=0; sim<BX_SMP_PROCESSORS; sim++) {
 
 void bx_dbg_breakpoint_changed(void)
 {
+  unsigned i;
+
+  memset(&bx_guard.iaddr.filter, 0, sizeof(bx_guard.iaddr.filter));
+
 #if BX_DBG_SUPPORT_VIR_BPOINT
   if (bx_guard.iaddr.num_virtual)
     bx_guard.guard_for |= BX_DBG_GUARD_IADDR_VIR;
   else
     bx_guard.guard_for &= ~BX_DBG_GUARD_IADDR_VIR;
+  for (i=0; i<bx_guard.iaddr.num_virtual; i++) {
+    if (bx_guard.iaddr.vir[i].enabled)
+      BX_DBG_PAGE_FILTER_SET(bx_guard.iaddr.filter.vir, bx_guard.iaddr.vir[i].eip >> 12);
+  }
 #endif
 
 #if BX_DBG_SUPPORT_LIN_BPOINT
@@ -2094,6 +1954,10 @@ void bx_dbg_breakpoint_changed(void)
     bx_guard.guard_for |= BX_DBG_GUARD_IADDR_LIN;
   else
     bx_guard.guard_for &= ~BX_DBG_GUARD_IADDR_LIN;
+  for (i=0; i<bx_guard.iaddr.num_linear; i++) {
+    if (bx_guard.iaddr.lin[i].enabled)
+      BX_DBG_PAGE_FILTER_SET(bx_guard.iaddr.filter.lin, bx_guard.iaddr.lin[i].addr >> 12);
+  }
 #endif
 
 #if BX_DBG_SUPPORT_PHY_BPOINT
@@ -2101,6 +1965,10 @@ void bx_dbg_breakpoint_changed(void)
     bx_guard.guard_for |= BX_DBG_GUARD_IADDR_PHY;
   else
     bx_guard.guard_for &= ~BX_DBG_GUARD_IADDR_PHY;
+  for (i=0; i<bx_guard.iaddr.num_physical; i++) {
+    if (bx_guard.iaddr.phy[i].enabled)
+      BX_DBG_PAGE_FILTER_SET(bx_guard.iaddr.filter.phy, bx_guard.iaddr.phy[i].addr & 0xfff);
+  }
 #endif
 }
 
@@ -2268,7 +2136,7 @@ int bx_dbg_vbreakpoint_command(BreakpointKind bk, Bit32u cs, Bit32u eip)
   int BpId = (int)bx_guard.iaddr.vir[bx_guard.iaddr.num_virtual].bpoint_id;
   bx_guard.iaddr.vir[bx_guard.iaddr.num_virtual].enabled=1;
   bx_guard.iaddr.num_virtual++;
-  bx_guard.guard_for |= BX_DBG_GUARD_IADDR_VIR;
+  bx_dbg_breakpoint_changed();
   return BpId;
 
 #else
@@ -2297,7 +2165,7 @@ int bx_dbg_lbreakpoint_command(BreakpointKind bk, Bit32u laddress)
   bx_guard.iaddr.lin[bx_guard.iaddr.num_linear].bpoint_id = BpId;
   bx_guard.iaddr.lin[bx_guard.iaddr.num_linear].enabled=1;
   bx_guard.iaddr.num_linear++;
-  bx_guard.guard_for |= BX_DBG_GUARD_IADDR_LIN;
+  bx_dbg_breakpoint_changed();
   return BpId;
 
 #else
@@ -2326,7 +2194,7 @@ int bx_dbg_pbreakpoint_command(BreakpointKind bk, Bit32u paddress)
   int BpId = (int)bx_guard.iaddr.phy[bx_guard.iaddr.num_physical].bpoint_id;
   bx_guard.iaddr.phy[bx_guard.iaddr.num_physical].enabled=1;
   bx_guard.iaddr.num_physical++;
-  bx_guard.guard_for |= BX_DBG_GUARD_IADDR_PHY;
+  bx_dbg_breakpoint_changed();
   return BpId;
 #else
   dbg_printf ("Error: physical breakpoint support not compiled in.\n");
@@ -3273,19 +3141,13 @@ void bx_dbg_disassemble_command(const char *format, bx_num_range range)
           if (BX_CPU(dbg_cpu)->sregs[BX_SEG_REG_CS].cache.u.segment.d_b)
             dis_size = 32;
         }
-        BX_MEM(0)->dbg_fetch_mem(paddr, 16, bx_disasm_ibuf);
-        ilen = bx_disassemble.disasm(dis_size==32, dis_size==64,
-          0, (Bit32u)range.from, bx_disasm_ibuf, bx_disasm_tbuf);
+        const char *line;
+        ilen = bx_dbg_disasm_line(BX_MEM(0), paddr, dis_size==32, dis_size==64,
+          0, (Bit32u)range.from, &line);
 
         char *Sym=bx_dbg_disasm_symbolic_address((Bit32u)range.from, 0);
 
-        dbg_printf ("%08x: ", (unsigned) range.from);
-        dbg_printf ("(%20s): ", Sym?Sym:"");
-        dbg_printf ("%-25s ; ", bx_disasm_tbuf);
-
-        for (unsigned j=0; j<ilen; j++)
-          dbg_printf ("%02x", (unsigned) bx_disasm_ibuf[j]);
-        dbg_printf ("\n");
+        dbg_printf ("%08x: (%20s): %s\n", (unsigned) range.from, Sym?Sym:"", line);
     }
     else {
       dbg_printf ("??? (physical address not available)\n");
@@ -3398,17 +3260,22 @@ void bx_dbg_crc_command(Bit32u addr1, Bit32u addr2)
 #endif
 }
 
+static int bx_dbg_page_cmp(const void *a, const void *b)
+{
+  Bit32u pa = *(const Bit32u *) a, pb = *(const Bit32u *) b;
+  return (pa < pb) ? -1 : (pa > pb) ? 1 : 0;
+}
+
 void bx_dbg_info_dirty_command(void)
 {
-  unsigned char *page_tbl = BX_MEM(0)->dbg_dirty_pages;
-  unsigned page_tbl_size  = BX_MEM(0)->dbg_count_dirty_pages ();
+  Bit32u *list = BX_MEM(0)->dbg_dirty_list;
+  Bit32u count = BX_MEM(0)->dbg_dirty_count;
 
-  for (unsigned i=0; i<page_tbl_size; i++) {
-    if (page_tbl[i]) {
-      dbg_printf ("0x%x\n", i);
-      page_tbl[i] = 0; // reset to clean
-    }
+  qsort(list, count, sizeof(Bit32u), bx_dbg_page_cmp);
+  for (Bit32u n=0; n<count; n++) {
+    dbg_printf ("0x%x\n", list[n]);
   }
+  BX_MEM(0)->dbg_clear_dirty(); // reset to clean
 }
 
 void bx_dbg_print_descriptor (unsigned char desc[8], int verbose)
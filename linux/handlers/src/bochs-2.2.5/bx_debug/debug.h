@@ -184,6 +184,16 @@ void bx_dbg_info_ivt_command(bx_num_range);
 // the rest for C++
 #ifdef __cplusplus
 
+// Page filters keep the breakpoint and watchpoint lists out of the
+// per-instruction and per-access paths: a bit is set for each page
+// (modulo BX_DBG_PAGE_FILTER_BITS) holding an enabled breakpoint, and
+// the lists are only searched when the bit for the current page is set.
+#define BX_DBG_PAGE_FILTER_BITS 4096
+#define BX_DBG_PAGE_FILTER_SET(map, idx) \
+  ((map)[((idx) & (BX_DBG_PAGE_FILTER_BITS-1)) >> 5] |= ((Bit32u) 1 << ((idx) & 31)))
+#define BX_DBG_PAGE_FILTER_HIT(map, idx) \
+  ((map)[((idx) & (BX_DBG_PAGE_FILTER_BITS-1)) >> 5] & ((Bit32u) 1 << ((idx) & 31)))
+
 // (mch) Read/write watchpoint hack
 #define MAX_WRITE_WATCHPOINTS 16
 #define MAX_READ_WATCHPOINTS 16
@@ -191,6 +201,9 @@ extern int num_write_watchpoints;
 extern Bit32u write_watchpoint[MAX_WRITE_WATCHPOINTS];
 extern int num_read_watchpoints;
 extern Bit32u read_watchpoint[MAX_READ_WATCHPOINTS];
+// page filters for the watchpoints, indexed by physical address >> 12
+extern Bit32u write_watchpoint_pages[BX_DBG_PAGE_FILTER_BITS/32];
+extern Bit32u read_watchpoint_pages[BX_DBG_PAGE_FILTER_BITS/32];
 
 typedef enum {
       STOP_NO_REASON = 0, STOP_TIME_BREAK_POINT, STOP_READ_WATCH_POINT,
@@ -293,6 +306,15 @@ typedef struct {
       bx_bool enabled;
     } phy[BX_DBG_MAX_PHY_BPOINTS];
 #endif
+
+    // rebuilt by bx_dbg_breakpoint_changed()
+    struct {
+      Bit32u vir[BX_DBG_PAGE_FILTER_BITS/32]; // indexed by eip >> 12
+      Bit32u lin[BX_DBG_PAGE_FILTER_BITS/32]; // indexed by laddr >> 12
+      // physical breakpoints are filtered by their offset in the page,
+      // which is known before the instruction address is translated
+      Bit32u phy[BX_DBG_PAGE_FILTER_BITS/32]; // indexed by addr & 0xfff
+    } filter;
   } iaddr;
 
   bx_dbg_icount_t icount; // stop after completing this many instructions
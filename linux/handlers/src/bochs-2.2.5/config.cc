@@ -1011,14 +1011,23 @@ void bx_init_options ()
                 strdup(name), 
                 strdup(descr), 
                 "", BX_PATHNAME_LEN);
-        deplist = new bx_list_c (BXP_NULL, 2);
+        sprintf (name, "Fast UART mode for COM%d", i+1);
+        sprintf (descr, "Transmit characters immediately instead of at the programmed baud rate");
+        bx_options.com[i].Ofast = new bx_param_bool_c (
+                BXP_COMx_FAST(i+1),
+                strdup(name), 
+                strdup(descr), 
+                0);
+        deplist = new bx_list_c (BXP_NULL, 3);
         deplist->add (bx_options.com[i].Omode);
         deplist->add (bx_options.com[i].Odev);
+        deplist->add (bx_options.com[i].Ofast);
         bx_options.com[i].Oenabled->set_dependent_list (deplist);
         // add to menu
         *par_ser_ptr++ = bx_options.com[i].Oenabled;
         *par_ser_ptr++ = bx_options.com[i].Omode;
         *par_ser_ptr++ = bx_options.com[i].Odev;
+        *par_ser_ptr++ = bx_options.com[i].Ofast;
   }
 
   // usb hubs
@@ -1613,6 +1622,10 @@ void bx_init_options ()
       "Approximate time in microseconds between attemps to paste characters to the keyboard controller.",
       1000, BX_MAX_BIT32U,
       100000);
+  bx_options.Okeyboard_inject = new bx_param_filename_c (BXP_KBD_INJECT_PATH,
+      "Keyboard inject file",
+      "Pathname of a file or named pipe whose contents are typed into the guest as fast as it reads the keyboard.",
+      "", BX_PATHNAME_LEN);
   bx_options.cmosimage.Oenabled = new bx_param_bool_c (BXP_CMOSIMAGE_ENABLED,
       "Use a CMOS image",
       "Controls the usage of a CMOS image",
@@ -1629,6 +1642,74 @@ void bx_init_options ()
   deplist->add (bx_options.cmosimage.Opath);
   deplist->add (bx_options.cmosimage.Ortc_init);
   bx_options.cmosimage.Oenabled->set_dependent_list (deplist);
+  bx_options.g2h.Oenabled = new bx_param_bool_c (BXP_G2H_ENABLED,
+      "Enable guest to host channel",
+      "Controls whether the paravirtual guest to host channel at port 0x2000 is installed",
+      0);
+  bx_options.g2h.Odir = new bx_param_filename_c (BXP_G2H_DIR,
+      "Guest to host share directory",
+      "Host directory whose files the guest may read and write through the channel",
+      "", BX_PATHNAME_LEN);
+  bx_options.g2h.Olog = new bx_param_filename_c (BXP_G2H_LOG,
+      "Guest report log",
+      "Pathname of the file that receives guest reports and timing markers",
+      "", BX_PATHNAME_LEN);
+  deplist = new bx_list_c (BXP_NULL, 2);
+  deplist->add (bx_options.g2h.Odir);
+  deplist->add (bx_options.g2h.Olog);
+  bx_options.g2h.Oenabled->set_dependent_list (deplist);
+  bx_options.profile.Oenabled = new bx_param_bool_c (BXP_PROFILE_ENABLED,
+      "Enable guest profiler",
+      "Controls whether guest EIP, CPL and CR3 are sampled and reported on exit",
+      0);
+  bx_options.profile.Operiod = new bx_param_num_c (BXP_PROFILE_PERIOD,
+      "Profiler sampling period",
+      "Mean number of instructions between two samples",
+      100, BX_MAX_BIT32U,
+      100000);
+  bx_options.profile.Ofile = new bx_param_filename_c (BXP_PROFILE_FILE,
+      "Profile report",
+      "Pathname of the folded stack report written on exit",
+      "profile.folded", BX_PATHNAME_LEN);
+  bx_options.profile.Osymbols = new bx_param_filename_c (BXP_PROFILE_SYMBOLS,
+      "Profiler symbols",
+      "Pathname of a System.map or nm output used to name the samples",
+      "", BX_PATHNAME_LEN);
+  deplist = new bx_list_c (BXP_NULL, 3);
+  deplist->add (bx_options.profile.Operiod);
+  deplist->add (bx_options.profile.Ofile);
+  deplist->add (bx_options.profile.Osymbols);
+  bx_options.profile.Oenabled->set_dependent_list (deplist);
+  bx_options.stats.Oenabled = new bx_param_bool_c (BXP_STATS_ENABLED,
+      "Dump self-profiling counters",
+      "Controls whether the emulator's own counters are written as JSON",
+      0);
+  bx_options.stats.Operiod = new bx_param_num_c (BXP_STATS_PERIOD,
+      "Counter dump period",
+      "Number of instructions between two dumps, 0 to dump only on exit",
+      0, BX_MAX_BIT32U,
+      100000000);
+  bx_options.stats.Ofile = new bx_param_filename_c (BXP_STATS_FILE,
+      "Counter dump file",
+      "Pathname of the file the counters are appended to, one JSON object per line",
+      "stats.json", BX_PATHNAME_LEN);
+  deplist = new bx_list_c (BXP_NULL, 2);
+  deplist->add (bx_options.stats.Operiod);
+  deplist->add (bx_options.stats.Ofile);
+  bx_options.stats.Oenabled->set_dependent_list (deplist);
+  bx_options.replay.Omode = new bx_param_enum_c (BXP_REPLAY_MODE,
+      "Record/replay mode",
+      "Record the host input of a run, or replay a recorded run",
+      (char **) replay_mode_names,
+      BX_REPLAY_MODE_NONE,
+      BX_REPLAY_MODE_NONE);
+  bx_options.replay.Ofile = new bx_param_filename_c (BXP_REPLAY_FILE,
+      "Record/replay log",
+      "Pathname of the host input log",
+      "bochs.rpl", BX_PATHNAME_LEN);
+  deplist = new bx_list_c (BXP_NULL, 1);
+  deplist->add (bx_options.replay.Ofile);
+  bx_options.replay.Omode->set_dependent_list (deplist);
 
   // Keyboard mapping
   bx_options.keyboard.OuseMapping = new bx_param_bool_c(BXP_KEYBOARD_USEMAPPING,
@@ -1668,6 +1749,7 @@ void bx_init_options ()
   bx_param_c *keyboard_init_list[] = {
       bx_options.Okeyboard_serial_delay,
       bx_options.Okeyboard_paste_delay,
+      bx_options.Okeyboard_inject,
       bx_options.keyboard.OuseMapping,
       bx_options.keyboard.Okeymap,
       bx_options.Okeyboard_type,
@@ -1681,6 +1763,18 @@ void bx_init_options ()
       bx_options.cmosimage.Oenabled,
       bx_options.cmosimage.Opath,
       bx_options.cmosimage.Ortc_init,
+      bx_options.g2h.Oenabled,
+      bx_options.g2h.Odir,
+      bx_options.g2h.Olog,
+      bx_options.profile.Oenabled,
+      bx_options.profile.Operiod,
+      bx_options.profile.Ofile,
+      bx_options.profile.Osymbols,
+      bx_options.stats.Oenabled,
+      bx_options.stats.Operiod,
+      bx_options.stats.Ofile,
+      bx_options.replay.Omode,
+      bx_options.replay.Ofile,
       SIM->get_param (BXP_CLOCK),
       SIM->get_param (BXP_LOAD32BITOS),
       NULL
@@ -1786,6 +1880,7 @@ void bx_reset_options ()
     bx_options.com[i].Oenabled->reset();
     bx_options.com[i].Omode->reset();
     bx_options.com[i].Odev->reset();
+    bx_options.com[i].Ofast->reset();
   }
   for (i=0; i<BX_N_PARALLEL_PORTS; i++) {
     bx_options.par[i].Oenabled->reset();
@@ -1852,6 +1947,7 @@ void bx_reset_options ()
   // keyboard
   bx_options.Okeyboard_serial_delay->reset();
   bx_options.Okeyboard_paste_delay->reset();
+  bx_options.Okeyboard_inject->reset();
   bx_options.keyboard.OuseMapping->reset();
   bx_options.keyboard.Okeymap->reset();
   bx_options.Okeyboard_type->reset();
@@ -1877,6 +1973,24 @@ void bx_reset_options ()
   bx_options.cmosimage.Opath->reset();
   bx_options.cmosimage.Ortc_init->reset();
   bx_options.Otext_snapshot_check->reset();
+
+  // guest to host channel
+  bx_options.g2h.Oenabled->reset();
+  bx_options.g2h.Odir->reset();
+  bx_options.g2h.Olog->reset();
+
+  // guest profiler
+  bx_options.profile.Oenabled->reset();
+  bx_options.profile.Operiod->reset();
+  bx_options.profile.Ofile->reset();
+  bx_options.profile.Osymbols->reset();
+
+  // self-profiling counters
+  bx_options.stats.Oenabled->reset();
+  bx_options.stats.Operiod->reset();
+  bx_options.stats.Ofile->reset();
+  bx_options.replay.Omode->reset();
+  bx_options.replay.Ofile->reset();
 }
 
 int
@@ -2720,6 +2834,15 @@ static Bit32s parse_line_formatted(char *context, int num_params, char *params[]
     if (bx_options.Okeyboard_paste_delay->get () < 1000) {
       PARSE_ERR (("%s: keyboard_paste_delay not big enough!", context));
     }
+  } else if (!strcmp(params[0], "keyboard_inject")) {
+    if (num_params != 2) {
+      PARSE_ERR(("%s: keyboard_inject directive: wrong # args.", context));
+    }
+    if (!strncmp(params[1], "file=", 5)) {
+      bx_options.Okeyboard_inject->set (&params[1][5]);
+    } else {
+      PARSE_ERR(("%s: keyboard_inject directive malformed.", context));
+    }
   } else if (!strcmp(params[0], "floppy_command_delay")) {
     PARSE_WARN(("%s: floppy_command_delay is deprecated (now using hardware timing).", context));
   } else if (!strcmp(params[0], "ips")) {
@@ -2843,6 +2966,8 @@ static Bit32s parse_line_formatted(char *context, int num_params, char *params[]
       } else if (!strncmp(params[i], "dev=", 4)) {
         bx_options.com[idx].Odev->set (&params[i][4]);
         bx_options.com[idx].Oenabled->set (1);
+      } else if (!strncmp(params[i], "fast=", 5)) {
+        bx_options.com[idx].Ofast->set (atol(&params[i][5]));
       } else {
         PARSE_ERR(("%s: unknown parameter for com%d ignored.", context, idx+1));
       }
@@ -2947,6 +3072,58 @@ static Bit32s parse_line_formatted(char *context, int num_params, char *params[]
     if (strlen(bx_options.cmosimage.Opath->getptr()) > 0) {
       bx_options.cmosimage.Oenabled->set (1);
     }
+  } else if (!strcmp(params[0], "guest2host")) {
+    for (i=1; i<num_params; i++) {
+      if (!strncmp(params[i], "enabled=", 8)) {
+        bx_options.g2h.Oenabled->set (atol(&params[i][8]));
+      } else if (!strncmp(params[i], "dir=", 4)) {
+        bx_options.g2h.Odir->set (&params[i][4]);
+      } else if (!strncmp(params[i], "log=", 4)) {
+        bx_options.g2h.Olog->set (&params[i][4]);
+      } else {
+        PARSE_ERR(("%s: unknown parameter for guest2host ignored.", context));
+      }
+    }
+  } else if (!strcmp(params[0], "profile")) {
+    for (i=1; i<num_params; i++) {
+      if (!strncmp(params[i], "enabled=", 8)) {
+        bx_options.profile.Oenabled->set (atol(&params[i][8]));
+      } else if (!strncmp(params[i], "period=", 7)) {
+        bx_options.profile.Operiod->set (atol(&params[i][7]));
+      } else if (!strncmp(params[i], "file=", 5)) {
+        bx_options.profile.Ofile->set (&params[i][5]);
+      } else if (!strncmp(params[i], "symbols=", 8)) {
+        bx_options.profile.Osymbols->set (&params[i][8]);
+      } else {
+        PARSE_ERR(("%s: unknown parameter for profile ignored.", context));
+      }
+    }
+  } else if (!strcmp(params[0], "stats")) {
+#if !BX_SUPPORT_STATS
+    PARSE_WARN(("%s: Bochs is not compiled with BX_SUPPORT_STATS, ignoring 'stats'", context));
+#endif
+    for (i=1; i<num_params; i++) {
+      if (!strncmp(params[i], "enabled=", 8)) {
+        bx_options.stats.Oenabled->set (atol(&params[i][8]));
+      } else if (!strncmp(params[i], "period=", 7)) {
+        bx_options.stats.Operiod->set (atol(&params[i][7]));
+      } else if (!strncmp(params[i], "file=", 5)) {
+        bx_options.stats.Ofile->set (&params[i][5]);
+      } else {
+        PARSE_ERR(("%s: unknown parameter for stats ignored.", context));
+      }
+    }
+  } else if (!strcmp(params[0], "replay")) {
+    for (i=1; i<num_params; i++) {
+      if (!strncmp(params[i], "mode=", 5)) {
+        if (!bx_options.replay.Omode->set_by_name (&params[i][5]))
+          PARSE_ERR(("%s: replay mode '%s' not available", context, &params[i][5]));
+      } else if (!strncmp(params[i], "file=", 5)) {
+        bx_options.replay.Ofile->set (&params[i][5]);
+      } else {
+        PARSE_ERR(("%s: unknown parameter for replay ignored.", context));
+      }
+    }
   } else if (!strcmp(params[0], "clock")) {
     for (i=1; i<num_params; i++) {
       if (!strncmp(params[i], "sync=", 5)) {
@@ -3393,6 +3570,7 @@ bx_write_serial_options (FILE *fp, bx_serial_options *opt, int n)
   if (opt->Oenabled->get ()) {
     fprintf (fp, ", mode=%s", opt->Omode->get_choice(opt->Omode->get()));
     fprintf (fp, ", dev=\"%s\"", opt->Odev->getptr ());
+    fprintf (fp, ", fast=%d", opt->Ofast->get ());
   }
   fprintf (fp, "\n");
   return 0;
@@ -3638,6 +3816,8 @@ bx_write_configuration (char *rc, int overwrite)
   fprintf (fp, "vga: extension=%s\n", bx_options.Ovga_extension->getptr ());
   fprintf (fp, "keyboard_serial_delay: %u\n", bx_options.Okeyboard_serial_delay->get ());
   fprintf (fp, "keyboard_paste_delay: %u\n", bx_options.Okeyboard_paste_delay->get ());
+  if (strlen (bx_options.Okeyboard_inject->getptr ()) > 0)
+    fprintf (fp, "keyboard_inject: file=%s\n", bx_options.Okeyboard_inject->getptr ());
   fprintf (fp, "ips: %u\n", bx_options.Oips->get ());
   fprintf (fp, "text_snapshot_check: %d\n", bx_options.Otext_snapshot_check->get ());
   fprintf (fp, "mouse: enabled=%d\n", bx_options.Omouse_enabled->get ());
@@ -3657,10 +3837,30 @@ bx_write_configuration (char *rc, int overwrite)
   fprintf (fp, "user_shortcut: keys=%s\n", bx_options.Ouser_shortcut->getptr ());
   if (strlen (bx_options.cmosimage.Opath->getptr ()) > 0) {
     fprintf (fp, "cmosimage: file=%s, ", bx_options.cmosimage.Opath->getptr());
-    fprintf (fp, "rtc_init=%s", bx_options.cmosimage.Ortc_init->get()?"image":"time0");
+    fprintf (fp, "rtc_init=%s\n", bx_options.cmosimage.Ortc_init->get()?"image":"time0");
   } else {
     fprintf (fp, "# no cmosimage\n");
   }
+  if (bx_options.g2h.Oenabled->get ()) {
+    fprintf (fp, "guest2host: enabled=1, dir=%s, log=%s\n",
+      bx_options.g2h.Odir->getptr (), bx_options.g2h.Olog->getptr ());
+  }
+  if (bx_options.profile.Oenabled->get ()) {
+    fprintf (fp, "profile: enabled=1, period=%u, file=%s",
+      bx_options.profile.Operiod->get (), bx_options.profile.Ofile->getptr ());
+    if (strlen (bx_options.profile.Osymbols->getptr ()) > 0)
+      fprintf (fp, ", symbols=%s", bx_options.profile.Osymbols->getptr ());
+    fprintf (fp, "\n");
+  }
+  if (bx_options.stats.Oenabled->get ()) {
+    fprintf (fp, "stats: enabled=1, period=%u, file=%s\n",
+      bx_options.stats.Operiod->get (), bx_options.stats.Ofile->getptr ());
+  }
+  if (bx_options.replay.Omode->get () != BX_REPLAY_MODE_NONE) {
+    fprintf (fp, "replay: mode=%s, file=%s\n",
+      replay_mode_names[bx_options.replay.Omode->get ()],
+      bx_options.replay.Ofile->getptr ());
+  }
   fclose (fp);
   return 0;
 }
@@ -59,6 +59,12 @@
 // one space for each processor to have an ID, starting with 0.
 #define BX_IOAPIC_DEFAULT_ID 1
 
+// With several processors main.cc runs each of them for a quantum of
+// instructions in turn.  The quantum starts at BX_SMP_QUANTUM_MIN and
+// doubles up to BX_SMP_QUANTUM_MAX while no processor waits for another.
+#define BX_SMP_QUANTUM_MIN 5
+#define BX_SMP_QUANTUM_MAX 640
+
 #define BX_ADDRESS_SPACES 1
 // controls how many instances of BX_MEM_C are created.  For
 // SMP, use several processors with one shared memory space.
@@ -117,6 +123,23 @@
 #define        SIGALRM         14
 #endif
 
+// Self-profiling counters
+// Count iCache and TLB hits and misses, physical memory slow path
+// accesses, port I/O and timer callbacks per device, exceptions per
+// vector and async events.  The counters are visible in the parameter
+// tree (BXP_STATS) and can be dumped periodically with the 'stats'
+// option in your '.bochsrc'.  Set to 0 to remove them from the hot paths.
+
+#define BX_SUPPORT_STATS 1
+
+// CPU benchmarks
+// Compile in BX_CPU_C::decodeBench() and BX_CPU_C::simdBench(), which
+// bochs runs instead of the simulation when BXDECODEBENCH names a file
+// of x86 code or BXSIMDBENCH is set in the environment.  Only for
+// measuring the emulator itself.
+
+#define BX_SUPPORT_CPU_BENCH 0
+
 // Paging Options:
 // ---------------
 // Support Paging mechanism.
@@ -143,7 +166,10 @@
 #define BX_TLB_MASK ((BX_TLB_SIZE-1) << 12)
 #define BX_TLB_INDEX_OF(lpf) (((lpf) & BX_TLB_MASK) >> 12)
 
-#define BX_USE_QUICK_TLB_INVALIDATE 0
+// BX_USE_QUICK_TLB_INVALIDATE: tag TLB entries with a generation number
+//   so that a TLB flush (CR3 load, task switch) is a decrement instead
+//   of a walk over all BX_TLB_SIZE entries.
+#define BX_USE_QUICK_TLB_INVALIDATE 1
 
 // Compile in support for DMA & FLOPPY IO.  You'll need this
 // if you plan to use the floppy drive emulation.  But if
@@ -748,7 +774,11 @@ typedef
 #define BX_SupportGuest2HostTLB 1
 #define BX_SupportRepeatSpeedups 1
 #define BX_SupportHostAsms 1
-#define BX_SupportHostAsmsFpu 0
+// Do x87 add, subtract, multiply and divide with host double arithmetic
+// when the result is the same as the 80 bit softfloat result: operands
+// that are doubles, round to nearest and either precision control set to
+// double or an exact result.  Needs a gcc host with SSE2.
+#define BX_SupportHostAsmsFpu 1
 
 #define BX_SUPPORT_ICACHE 1
 
@@ -279,6 +279,8 @@ BX_CPU_C::v2h_read_byte(bx_address laddr, unsigned pl)
       bx_hostpageaddr_t hostPageAddr = tlbEntry->hostPageAddr;
       Bit32u pageOffset = laddr & 0xfff;
       Bit8u *hostAddr = (Bit8u*) (hostPageAddr | pageOffset);
+      BX_INSTR_LIN_READ(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 1);
+      BX_STATS_INC(tlb_hits);
       return hostAddr;
     }
   }
@@ -304,6 +306,9 @@ BX_CPU_C::v2h_write_byte(bx_address laddr, unsigned pl)
 #if BX_SUPPORT_ICACHE
       pageWriteStampTable.decWriteStamp(tlbEntry->ppf);
 #endif
+      BX_DBG_DIRTY_PAGE(tlbEntry->ppf >> 12);
+      BX_INSTR_LIN_WRITE(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 1);
+      BX_STATS_INC(tlb_hits);
       return hostAddr;
     }
   }
@@ -326,6 +331,8 @@ BX_CPU_C::v2h_read_word(bx_address laddr, unsigned pl)
       if (accessBits & (1<<pl)) { // Read this pl OK.
         bx_hostpageaddr_t hostPageAddr = tlbEntry->hostPageAddr;
         Bit16u *hostAddr = (Bit16u*) (hostPageAddr | pageOffset);
+        BX_INSTR_LIN_READ(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 2);
+        BX_STATS_INC(tlb_hits);
         return hostAddr;
       }
     }
@@ -353,6 +360,9 @@ BX_CPU_C::v2h_write_word(bx_address laddr, unsigned pl)
 #if BX_SUPPORT_ICACHE
         pageWriteStampTable.decWriteStamp(tlbEntry->ppf);
 #endif
+        BX_DBG_DIRTY_PAGE(tlbEntry->ppf >> 12);
+        BX_INSTR_LIN_WRITE(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 2);
+        BX_STATS_INC(tlb_hits);
         return hostAddr;
       }
     }
@@ -376,6 +386,8 @@ BX_CPU_C::v2h_read_dword(bx_address laddr, unsigned pl)
       if (accessBits & (1<<pl)) { // Read this pl OK.
         bx_hostpageaddr_t hostPageAddr = tlbEntry->hostPageAddr;
         Bit32u *hostAddr = (Bit32u*) (hostPageAddr | pageOffset);
+        BX_INSTR_LIN_READ(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 4);
+        BX_STATS_INC(tlb_hits);
         return hostAddr;
       }
     }
@@ -403,6 +415,9 @@ BX_CPU_C::v2h_write_dword(bx_address laddr, unsigned pl)
 #if BX_SUPPORT_ICACHE
         pageWriteStampTable.decWriteStamp(tlbEntry->ppf);
 #endif
+        BX_DBG_DIRTY_PAGE(tlbEntry->ppf >> 12);
+        BX_INSTR_LIN_WRITE(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 4);
+        BX_STATS_INC(tlb_hits);
         return hostAddr;
       }
     }
@@ -426,6 +441,8 @@ BX_CPU_C::v2h_read_qword(bx_address laddr, unsigned pl)
       if (accessBits & (1<<pl)) { // Read this pl OK.
         bx_hostpageaddr_t hostPageAddr = tlbEntry->hostPageAddr;
         Bit64u *hostAddr = (Bit64u*) (hostPageAddr | pageOffset);
+        BX_INSTR_LIN_READ(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 8);
+        BX_STATS_INC(tlb_hits);
         return hostAddr;
       }
     }
@@ -453,6 +470,9 @@ BX_CPU_C::v2h_write_qword(bx_address laddr, unsigned pl)
 #if BX_SUPPORT_ICACHE
         pageWriteStampTable.decWriteStamp(tlbEntry->ppf);
 #endif
+        BX_DBG_DIRTY_PAGE(tlbEntry->ppf >> 12);
+        BX_INSTR_LIN_WRITE(BX_CPU_ID, laddr, tlbEntry->ppf | pageOffset, 8);
+        BX_STATS_INC(tlb_hits);
         return hostAddr;
       }
     }
@@ -69,30 +69,6 @@ void flushICaches(void)
   pageWriteStampTable.resetWriteStamps();
 }
 
-#define InstrumentICACHE 0
-
-#if InstrumentICACHE
-static unsigned iCacheLookups=0;
-static unsigned iCacheMisses=0;
-
-#define InstrICache_StatsMask 0xffffff
-
-#define InstrICache_Stats() {\
-  if ((iCacheLookups & InstrICache_StatsMask) == 0) { \
-    BX_INFO(("ICACHE lookups: %u, misses: %u, hit rate = %6.2f%% ", \
-          iCacheLookups, \
-          iCacheMisses,  \
-          (iCacheLookups-iCacheMisses) * 100.0 / iCacheLookups)); \
-    iCacheLookups = iCacheMisses = 0; \
-  } \
-}
-#define InstrICache_Increment(v) (v)++
-
-#else
-#define InstrICache_Stats()
-#define InstrICache_Increment(v)
-#endif
-
 #endif
 
 // notes:
@@ -102,11 +78,13 @@ static unsigned iCacheMisses=0;
 // run.  This is used only when simulating multiple processors.
 // 
 // If maximum instructions have been executed, return.  A count less
-// than zero means run forever.
+// than zero means run forever.  A processor spinning on PAUSE gives up
+// the rest of its quantum.
 #define CHECK_MAX_INSTRUCTIONS(count) \
   if (count >= 0) {                   \
     count--; if (count == 0) return;  \
-  }
+  }                                   \
+  if (BX_CPU_THIS_PTR spin_wait) return;
 
 #if BX_SMP_PROCESSORS==1
 #  define BX_TICK1_IF_SINGLE_PROCESSOR() BX_TICK1()
@@ -134,7 +112,7 @@ void BX_CPU_C::cpu_loop(Bit32s max_instr_count)
   BX_CPU_THIS_PTR stop_reason = STOP_NO_REASON;
 #endif
 
-  if (setjmp( BX_CPU_THIS_PTR jmp_buf_env )) 
+  if (BX_SETJMP( BX_CPU_THIS_PTR jmp_buf_env )) 
   { 
     // only from exception function can we get here ...
     BX_INSTR_NEW_INSTRUCTION(BX_CPU_ID);
@@ -212,16 +190,12 @@ void BX_CPU_C::cpu_loop(Bit32s max_instr_count)
 
   Bit32u pageWriteStamp = *(BX_CPU_THIS_PTR currPageWriteStampPtr);
 
-#if BX_SUPPORT_ICACHE
-  InstrICache_Increment(iCacheLookups);
-  InstrICache_Stats();
-#endif
-
   if ((cache_entry->pAddr == pAddr) &&
       (cache_entry->writeStamp == pageWriteStamp))
   {
     // iCache hit. Instruction is already decoded and stored in the
     // instruction cache.
+    BX_STATS_INC(icache_hits);
 
 #if BX_INSTRUMENTATION
     // An instruction was found in the iCache.
@@ -244,7 +218,7 @@ void BX_CPU_C::cpu_loop(Bit32s max_instr_count)
 #if BX_SUPPORT_ICACHE
     // The entry will be marked valid if fetchdecode will succeed
     cache_entry->writeStamp = ICacheWriteStampInvalid;
-    InstrICache_Increment(iCacheMisses);
+    BX_STATS_INC(icache_misses);
 #endif
 
 #if BX_SUPPORT_X86_64
@@ -500,6 +474,8 @@ unsigned BX_CPU_C::handleAsyncEvent(void)
   // This area is where we process special conditions and events.
   //
 
+  BX_STATS_INC(async_events);
+
   if (BX_CPU_THIS_PTR debug_trap & 0x80000000) {
     // I made up the bitmask above to mean HALT state.
 #if BX_SMP_PROCESSORS==1
@@ -762,7 +738,7 @@ void BX_CPU_C::prefetch(void)
   BX_CPU_THIS_PTR eipPageWindowSize = 4096; // FIXME:
   BX_CPU_THIS_PTR pAddrA20Page = pAddr & 0xfffff000;
   BX_CPU_THIS_PTR eipFetchPtr =
-       BX_CPU_THIS_PTR mem->getHostMemAddr(BX_CPU_THIS, BX_CPU_THIS_PTR pAddrA20Page, BX_READ);
+       BX_CPU_THIS_PTR mem->getHostMemAddr(BX_CPU_THIS, BX_CPU_THIS_PTR pAddrA20Page, BX_EXECUTE);
 
   // Sanity checks
   if ( !BX_CPU_THIS_PTR eipFetchPtr ) {
@@ -877,7 +853,7 @@ extern unsigned int dbg_show_mask;
 
 bx_bool BX_CPU_C::dbg_is_begin_instr_bpoint(Bit32u cs, Bit32u eip, Bit32u laddr, Bit32u is_32)
 { 
-  Bit64u tt = bx_pc_system.time_ticks();
+  Bit64u tt;
 
   //fprintf (stderr, "begin_instr_bp: checking cs:eip %04x:%08x\n", cs, eip);
   BX_CPU_THIS_PTR guard_found.cs  = cs;
@@ -905,9 +881,13 @@ bx_bool BX_CPU_C::dbg_is_begin_instr_bpoint(Bit32u cs, Bit32u eip, Bit32u laddr,
   }
 
   // see if debugger is looking for iaddr breakpoint of any type
+  // (the page filters rule out nearly all instructions before the
+  // breakpoint lists have to be searched)
   if (bx_guard.guard_for & BX_DBG_GUARD_IADDR_ALL) {
 #if BX_DBG_SUPPORT_VIR_BPOINT
-    if (bx_guard.guard_for & BX_DBG_GUARD_IADDR_VIR) {
+    if ((bx_guard.guard_for & BX_DBG_GUARD_IADDR_VIR) &&
+        BX_DBG_PAGE_FILTER_HIT(bx_guard.iaddr.filter.vir, eip >> 12)) {
+      tt = bx_pc_system.time_ticks();
       if ((BX_CPU_THIS_PTR guard_found.icount!=0) ||
           (tt != BX_CPU_THIS_PTR guard_found.time_tick))
       {
@@ -925,7 +905,9 @@ bx_bool BX_CPU_C::dbg_is_begin_instr_bpoint(Bit32u cs, Bit32u eip, Bit32u laddr,
     }
 #endif
 #if BX_DBG_SUPPORT_LIN_BPOINT
-    if (bx_guard.guard_for & BX_DBG_GUARD_IADDR_LIN) {
+    if ((bx_guard.guard_for & BX_DBG_GUARD_IADDR_LIN) &&
+        BX_DBG_PAGE_FILTER_HIT(bx_guard.iaddr.filter.lin, laddr >> 12)) {
+      tt = bx_pc_system.time_ticks();
       if ((BX_CPU_THIS_PTR guard_found.icount!=0) ||
           (tt != BX_CPU_THIS_PTR guard_found.time_tick))
       {
@@ -942,9 +924,11 @@ bx_bool BX_CPU_C::dbg_is_begin_instr_bpoint(Bit32u cs, Bit32u eip, Bit32u laddr,
     }
 #endif
 #if BX_DBG_SUPPORT_PHY_BPOINT
-    if (bx_guard.guard_for & BX_DBG_GUARD_IADDR_PHY) {
+    if ((bx_guard.guard_for & BX_DBG_GUARD_IADDR_PHY) &&
+        BX_DBG_PAGE_FILTER_HIT(bx_guard.iaddr.filter.phy, laddr & 0xfff)) {
       Bit32u phy;
       bx_bool valid;
+      tt = bx_pc_system.time_ticks();
       dbg_xlate_linear2phy(BX_CPU_THIS_PTR guard_found.laddr,
                               &phy, &valid);
       // The "guard_found.icount!=0" condition allows you to step or
@@ -1019,7 +1003,7 @@ void BX_CPU_C::dbg_take_irq(void)
   // NOTE: similar code in ::cpu_loop()
 
   if ( BX_CPU_INTR && BX_CPU_THIS_PTR get_IF () ) {
-    if ( setjmp(BX_CPU_THIS_PTR jmp_buf_env) == 0 ) {
+    if ( BX_SETJMP(BX_CPU_THIS_PTR jmp_buf_env) == 0 ) {
       // normal return from setjmp setup
       vector = DEV_pic_iac(); // may set INTR with next interrupt
       BX_CPU_THIS_PTR errorno = 0;
@@ -1035,7 +1019,7 @@ void BX_CPU_C::dbg_force_interrupt(unsigned vector)
   // Used to force slave simulator to take an interrupt, without
   // regard to IF
 
-  if ( setjmp(BX_CPU_THIS_PTR jmp_buf_env) == 0 ) {
+  if ( BX_SETJMP(BX_CPU_THIS_PTR jmp_buf_env) == 0 ) {
     // normal return from setjmp setup
     BX_CPU_THIS_PTR errorno = 0;
     BX_CPU_THIS_PTR EXT   = 1; // external event
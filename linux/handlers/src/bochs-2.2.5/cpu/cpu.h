@@ -31,6 +31,20 @@
 
 #include <setjmp.h>
 
+// Exceptions unwind to cpu_loop() with a longjmp.  Saving and restoring
+// the signal mask is not needed for that; on hosts where setjmp() saves
+// it (the BSDs, MacOS X, Solaris) it would cost a system call for every
+// setjmp and every guest fault, so use sigsetjmp() without the mask.
+#if defined(WIN32) && !defined(__CYGWIN__)
+typedef jmp_buf bx_jmp_buf;
+#define BX_SETJMP(env)          setjmp(env)
+#define BX_LONGJMP(env, val)    longjmp(env, val)
+#else
+typedef sigjmp_buf bx_jmp_buf;
+#define BX_SETJMP(env)          sigsetjmp(env, 0)
+#define BX_LONGJMP(env, val)    siglongjmp(env, val)
+#endif
+
 #include "cpu/lazy_flags.h"
 #include "cpu/hostasm.h"
 
@@ -862,7 +876,7 @@ public:
 
   // Note this is the highest field, and thus needs no masking.
   // DON'T PUT ANY FIELDS HIGHER THAN THIS ONE WITHOUT ADDING A MASK.
-  BX_CPP_INLINE unsigned ilen(void) {
+  BX_CPP_INLINE unsigned ilen(void) const {
     return metaInfo >> 23;
   }
   BX_CPP_INLINE void setILen(unsigned ilen) {
@@ -899,6 +913,29 @@ typedef struct {
 } bx_TLB_entry;
 #endif  // #if BX_USE_TLB
 
+#if BX_SUPPORT_STATS
+// Per CPU self-profiling counters.  Only the owning CPU updates them;
+// they are published as shadow parameters under BXP_STATS by stats.cc.
+typedef struct {
+  Bit64u icache_hits;
+  Bit64u icache_misses;
+  Bit64u tlb_hits;        // including the guest-to-host TLB fast paths
+  Bit64u tlb_misses;
+  Bit64u tlb_flushes;
+  Bit64u tlb_invlpg;
+  Bit64u phys_reads;      // BX_MEM_C::readPhysicalPage() slow path
+  Bit64u phys_writes;     // BX_MEM_C::writePhysicalPage() slow path
+  Bit64u async_events;
+  Bit64u exceptions[32];
+} bx_cpu_stats_t;
+
+#define BX_STATS_INC(field) (BX_CPU_THIS_PTR stats.field++)
+#define BX_CPU_STATS_INC(cpu, field) ((cpu)->stats.field++)
+#else
+#define BX_STATS_INC(field)
+#define BX_CPU_STATS_INC(cpu, field)
+#endif
+
 #if BX_SUPPORT_X86_64
 
 #ifdef BX_BIG_ENDIAN
@@ -1125,6 +1162,10 @@ public: // for now...
   volatile bx_bool async_event;
   volatile bx_bool INTR;
   volatile bx_bool kill_bochs_request;
+#if BX_SMP_PROCESSORS > 1
+  // set by PAUSE, the processor spins waiting for another one
+  bx_bool spin_wait;
+#endif
 
   /* wether this CPU is the BSP always set for UP */
   bx_bool bsp;
@@ -1149,7 +1190,7 @@ public: // for now...
 // <TAG-CLASS-CPU-END>
 
   // for exceptions
-  jmp_buf jmp_buf_env;
+  bx_jmp_buf jmp_buf_env;
   Bit8u curr_exception[2];
 
   bx_segment_reg_t save_cs;
@@ -1221,6 +1262,10 @@ public: // for now...
   bxICache_c iCache  BX_CPP_AlignN(32);
 #endif
 
+#if BX_SUPPORT_STATS
+  bx_cpu_stats_t stats;
+#endif
+
 
   struct {
     bx_address  rm_addr; // The address offset after resolution.
@@ -2464,6 +2509,13 @@ public: // for now...
   BX_SMF void SYSENTER(bxInstruction_c *);
   BX_SMF void SYSEXIT(bxInstruction_c *);
 
+  BX_SMF void initOpcodeMap(void);
+#if BX_SUPPORT_CPU_BENCH
+  BX_SMF void decodeBench(const char *path);
+#if BX_SUPPORT_MMX && (BX_SUPPORT_SSE >= 2)
+  BX_SMF void simdBench(void);
+#endif
+#endif
   BX_SMF unsigned fetchDecode(Bit8u *, bxInstruction_c *, unsigned);
 #if BX_SUPPORT_X86_64
   BX_SMF unsigned fetchDecode64(Bit8u *, bxInstruction_c *, unsigned);
@@ -2620,6 +2672,13 @@ public: // for now...
   // now for some ancillary functions...
   BX_SMF void cpu_loop(Bit32s max_instr_count);
   BX_SMF unsigned handleAsyncEvent(void);
+#if BX_SMP_PROCESSORS > 1
+  // halted, and cpu_loop() would return at once (see handleAsyncEvent)
+  BX_CPP_INLINE bx_bool is_halted_idle(void) {
+    return (BX_CPU_THIS_PTR debug_trap & 0x80000000) &&
+           !(BX_CPU_INTR && BX_CPU_THIS_PTR get_IF());
+  }
+#endif
   BX_SMF void boundaryFetch(Bit8u *fetchPtr, unsigned remainingInPage, bxInstruction_c *i);
   BX_SMF void prefetch(void);
   // revalidate_prefetch_q is now a no-op, due to the newer EIP window
@@ -2764,6 +2823,7 @@ public: // for now...
   BX_SMF void init_v8086_mode(void);
   BX_SMF void task_switch_load_selector(bx_segment_reg_t *seg,
                  bx_selector_t *selector, Bit16u raw_selector, Bit8u cs_rpl);
+  BX_SMF Bit8u* tss_host_addr(Bit32u laddr, unsigned len, unsigned rw);
   BX_SMF void task_switch(bx_selector_t *selector, bx_descriptor_t *descriptor,
                      unsigned source, Bit32u dword1, Bit32u dword2);
   BX_SMF void get_SS_ESP_from_TSS(unsigned pl, Bit16u *ss, Bit32u *esp);
@@ -2799,6 +2859,7 @@ public: // for now...
   BX_SMF bx_bool fetch_raw_descriptor2(bx_selector_t *selector,
                          Bit32u *dword1, Bit32u *dword2) BX_CPP_AttrRegparmN(3);
   BX_SMF void    load_seg_reg(bx_segment_reg_t *seg, Bit16u new_value) BX_CPP_AttrRegparmN(2);
+  BX_SMF void    set_seg_access_ok(bx_segment_reg_t *seg) BX_CPP_AttrRegparmN(1);
 #if BX_SUPPORT_X86_64
   BX_SMF  void   fetch_raw_descriptor64(bx_selector_t *selector,
                          Bit32u *dword1, Bit32u *dword2, Bit32u *dword3, unsigned exception_no);
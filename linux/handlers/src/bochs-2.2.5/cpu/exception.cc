@@ -818,7 +818,7 @@ void BX_CPU_C::exception(unsigned vector, Bit16u error_code, bx_bool is_INT)
 #if BX_DEBUGGER
   if (bx_guard.special_unwind_stack) {
     BX_INFO (("exception() returning early because special_unwind_stack is set"));
-    longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+    BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
   }
 #endif
 
@@ -827,6 +827,7 @@ void BX_CPU_C::exception(unsigned vector, Bit16u error_code, bx_bool is_INT)
 //#endif
 
   BX_INSTR_EXCEPTION(BX_CPU_ID, vector);
+  BX_STATS_INC(exceptions[vector & 0x1f]);
 
   BX_DEBUG(("exception(%02x h)", (unsigned) vector));
 
@@ -852,7 +853,7 @@ void BX_CPU_C::exception(unsigned vector, Bit16u error_code, bx_bool is_INT)
 #if BX_DEBUGGER
     bx_guard.special_unwind_stack = true;
 #endif
-    longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+    BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
   }
 
   /* careful not to get here with curr_exception[1]==DOUBLE_FAULT */
@@ -871,7 +872,7 @@ void BX_CPU_C::exception(unsigned vector, Bit16u error_code, bx_bool is_INT)
 #if BX_DEBUGGER
     bx_guard.special_unwind_stack = true;
 #endif
-    longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+    BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
   }
 
   /* ??? this is not totally correct, should be done depending on
@@ -1023,7 +1024,7 @@ void BX_CPU_C::exception(unsigned vector, Bit16u error_code, bx_bool is_INT)
   if (!real_mode()) {
     BX_CPU_THIS_PTR interrupt(vector, 0, push_error, error_code);
     BX_CPU_THIS_PTR errorno = 0; // error resolved
-    longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+    BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
   }
   else // real mode
 #endif
@@ -1031,6 +1032,6 @@ void BX_CPU_C::exception(unsigned vector, Bit16u error_code, bx_bool is_INT)
     // not INT, no error code pushed
     BX_CPU_THIS_PTR interrupt(vector, 0, 0, 0);
     BX_CPU_THIS_PTR errorno = 0; // error resolved
-    longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+    BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
   }
 }
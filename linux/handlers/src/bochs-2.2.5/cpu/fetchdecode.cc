@@ -1493,6 +1493,167 @@ static BxOpcodeInfo_t BxOpcodeInfo[512*2] = {
   /* 0F FF */  { 0, &BX_CPU_C::BxError }
   };
 
+/* ***************************************************************** */
+/* Flattened opcode map, built once from the tables above.           */
+/* ***************************************************************** */
+
+// fetchDecode() used to walk the group tables through AnotherArray for
+// every instruction, one dependent load per level.  Instead, each of the
+// 1024 opcodes gets a 16 byte BxOpcodeMap entry which is all that is
+// needed for opcodes without groups.  The variants of an opcode with
+// groups are laid out contiguously in BxOpcodeFlat, and picked with one
+// index computation over the parts of the instruction the groups look
+// at: nnn, rm, mod==11b and the SSE prefix.  A stride of 0 means the
+// opcode does not depend on that part.
+
+#define BX_OPMAP_NNN   0
+#define BX_OPMAP_RM    1
+#define BX_OPMAP_MOD   2
+#define BX_OPMAP_SSE   3
+
+#define BX_OPMAP_MAX_FLAT 4096
+
+typedef struct BxOpcodeMap_t {
+  Bit16u Attr;       // attributes of the opcode byte itself
+  Bit16u Index;      // first variant in BxOpcodeFlat
+  Bit8u  Stride[4];  // indexed by BX_OPMAP_xxx
+  BxExecutePtr_t ExecutePtr; // opcodes without groups only
+} BxOpcodeMap_t;
+
+typedef struct BxOpcodeFlat_t {
+  Bit16u         Attr;  // all attributes along the group chain
+  BxExecutePtr_t ExecutePtr;
+} BxOpcodeFlat_t;
+
+static BxOpcodeMap_t BxOpcodeMap[512*2];
+static BxOpcodeFlat_t BxOpcodeFlat[BX_OPMAP_MAX_FLAT];
+static unsigned BxOpcodeFlatSize = 0;
+
+static const unsigned BxOpcodeMapRange[4] = { 8, 8, 2, 4 };
+
+// Walk the group tables of opcode 'b1' the way the decoder did.  Sets the
+// bits of the key parts that were looked at in *used, and returns 0 for
+// an unknown group type.
+static bx_bool BxResolveOpcode(unsigned b1, unsigned offset,
+                   const unsigned *key, unsigned *used, BxOpcodeFlat_t *flat)
+{
+  BxOpcodeInfo_t *OpcodeInfoPtr = &(BxOpcodeInfo[b1+offset]);
+  unsigned attr = OpcodeInfoPtr->Attr;
+
+  while(attr & BxGroupX)
+  {
+    Bit32u Group = attr & BxGroupX;
+    attr &= ~BxGroupX;
+
+    switch(Group) {
+      case BxGroupN:
+        *used |= 1 << BX_OPMAP_NNN;
+        OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[key[BX_OPMAP_NNN]]);
+        break;
+      case BxPrefixSSE:
+        *used |= 1 << BX_OPMAP_SSE;
+        OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[key[BX_OPMAP_SSE]]);
+        break;
+      case BxSplitMod11b:
+        *used |= 1 << BX_OPMAP_MOD;
+        OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[key[BX_OPMAP_MOD]]);
+        break;
+#if BX_SUPPORT_FPU
+      case BxFPGroup:
+        *used |= (1 << BX_OPMAP_MOD) | (1 << BX_OPMAP_NNN);
+        if (! key[BX_OPMAP_MOD])
+          OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[key[BX_OPMAP_NNN]]);
+        else {
+          *used |= 1 << BX_OPMAP_RM;
+          int index = (b1-0xD8)*64 + key[BX_OPMAP_NNN]*8 + key[BX_OPMAP_RM];
+          OpcodeInfoPtr = &(BxOpcodeInfo_FloatingPoint[index]);
+        }
+        break;
+#endif
+      default:
+        return 0;
+    }
+
+    attr |= OpcodeInfoPtr->Attr;
+  }
+
+  flat->Attr = attr;
+  flat->ExecutePtr = OpcodeInfoPtr->ExecutePtr;
+  return 1;
+}
+
+  void
+BX_CPU_C::initOpcodeMap(void)
+{
+  BxOpcodeFlat_t variant[512];
+  unsigned key[4], part, n, i;
+
+  if (BxOpcodeFlatSize != 0) return; // shared by all processors
+
+  for (unsigned op=0; op<512*2; op++) {
+    unsigned b1 = op & 0x1ff, offset = op & 0x200;
+    unsigned used = 0, size = 1;
+
+    BxOpcodeMap[op].Attr = BxOpcodeInfo[op].Attr;
+    BxOpcodeMap[op].ExecutePtr = BxOpcodeInfo[op].ExecutePtr;
+    if (! (BxOpcodeInfo[op].Attr & BxGroupX)) continue;
+
+    // find out which parts of the instruction the opcode depends on
+    for (n=0; n<512; n++) {
+      unsigned k = n;
+      for (part=0; part<4; part++) {
+        key[part] = k % BxOpcodeMapRange[part];
+        k /= BxOpcodeMapRange[part];
+      }
+      if (! BxResolveOpcode(b1, offset, key, &used, &variant[0]))
+        BX_PANIC(("fetchdecode: Unknown opcode group, opcode 0x%03x", b1));
+    }
+
+    for (part=0; part<4; part++) {
+      if (used & (1 << part)) {
+        BxOpcodeMap[op].Stride[part] = size;
+        size *= BxOpcodeMapRange[part];
+      }
+      else
+        BxOpcodeMap[op].Stride[part] = 0;
+    }
+
+    // lay out the variants, with the first part varying fastest
+    for (n=0; n<size; n++) {
+      unsigned k = n;
+      for (part=0; part<4; part++) {
+        if (BxOpcodeMap[op].Stride[part]) {
+          key[part] = k % BxOpcodeMapRange[part];
+          k /= BxOpcodeMapRange[part];
+        }
+        else
+          key[part] = 0;
+      }
+      BxResolveOpcode(b1, offset, key, &used, &variant[n]);
+    }
+
+    // the 16 and 32 bit halves share most of their variants
+    for (i=0; i+size <= BxOpcodeFlatSize; i++) {
+      for (n=0; n<size; n++) {
+        if (BxOpcodeFlat[i+n].Attr != variant[n].Attr ||
+            BxOpcodeFlat[i+n].ExecutePtr != variant[n].ExecutePtr) break;
+      }
+      if (n == size) break;
+    }
+    if (i+size > BxOpcodeFlatSize) {
+      i = BxOpcodeFlatSize;
+      if (i+size > BX_OPMAP_MAX_FLAT)
+        BX_PANIC(("fetchdecode: opcode map overflow"));
+      for (n=0; n<size; n++)
+        BxOpcodeFlat[i+n] = variant[n];
+      BxOpcodeFlatSize += size;
+    }
+    BxOpcodeMap[op].Index = i;
+  }
+
+  BX_DEBUG(("fetchdecode: opcode map uses %u entries", BxOpcodeFlatSize));
+}
+
   unsigned
 BX_CPU_C::fetchDecode(Bit8u *iptr, bxInstruction_c *instruction,
                       unsigned remain)
@@ -1526,7 +1687,7 @@ fetch_b1:
 
 another_byte:
   offset = os_32 << 9; // * 512
-  attr = BxOpcodeInfo[b1+offset].Attr;
+  attr = BxOpcodeMap[b1+offset].Attr;
   instruction->setRepAttr(attr & (BxRepeatable | BxRepeatableZF));
 
   if (attr & BxAnother) {
@@ -1784,55 +1945,28 @@ get_32bit_displ:
 modrm_done:
 
     // Resolve ExecutePtr and additional opcode Attr
-    BxOpcodeInfo_t *OpcodeInfoPtr = &(BxOpcodeInfo[b1+offset]);
-    while(attr & BxGroupX) 
-    {
-       Bit32u Group = attr & BxGroupX;
-       attr &= ~BxGroupX;
-      
-       switch(Group) {
-         case BxGroupN:
-             OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[nnn]);
-             break;
-         case BxPrefixSSE:
-         {
-             /* For SSE opcodes, look into another 4 entries table 
-                      with the opcode prefixes (NONE, 0x66, 0xF2, 0xF3) */
-             int op = sse_prefix_index[sse_prefix];
-             if (op < 0) {
-                 BX_INFO(("fetchdecode: SSE opcode with two or more prefixes"));
-                 UndefinedOpcode(instruction);
-             }
-             OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[op]);
-             break;
-         }
-         case BxSplitMod11b:
-             /* For high frequency opcodes, two variants of the instruction are
-              * implemented; one for the mod=11b case (Reg-Reg), and one for
-              * the other cases (Reg-Mem).  If this is one of those cases,
-              * we need to dereference to get to the execute pointer.
-              */
-             OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[mod==0xc0]);
-             break;
-#if BX_SUPPORT_FPU
-         case BxFPGroup:
-             if (mod != 0xc0)  // mod != 11b
-                OpcodeInfoPtr = &(OpcodeInfoPtr->AnotherArray[nnn]);
-             else {
-                int index = (b1-0xD8)*64 + (0x3f & b2);
-                OpcodeInfoPtr = &(BxOpcodeInfo_FloatingPoint[index]);
-             }
-             break;
-#endif
-         default:
-             BX_PANIC(("fetchdecode: Unknown opcode group"));
-       }
-
-       /* get additional attributes from group table */
-       attr |= OpcodeInfoPtr->Attr;
+    BxOpcodeMap_t *OpcodeMapPtr = &(BxOpcodeMap[b1+offset]);
+    if (attr & BxGroupX) {
+      unsigned index = OpcodeMapPtr->Index +
+                       nnn * OpcodeMapPtr->Stride[BX_OPMAP_NNN] +
+                       rm  * OpcodeMapPtr->Stride[BX_OPMAP_RM] +
+             (mod == 0xc0) * OpcodeMapPtr->Stride[BX_OPMAP_MOD];
+      if (OpcodeMapPtr->Stride[BX_OPMAP_SSE]) {
+        /* For SSE opcodes, look into another 4 entries table 
+                 with the opcode prefixes (NONE, 0x66, 0xF2, 0xF3) */
+        int op = sse_prefix_index[sse_prefix];
+        if (op < 0) {
+          BX_INFO(("fetchdecode: SSE opcode with two or more prefixes"));
+          UndefinedOpcode(instruction);
+        }
+        index += op * OpcodeMapPtr->Stride[BX_OPMAP_SSE];
+      }
+      attr = BxOpcodeFlat[index].Attr;
+      instruction->execute = BxOpcodeFlat[index].ExecutePtr;
     }
+    else
+      instruction->execute = OpcodeMapPtr->ExecutePtr;
 
-    instruction->execute = OpcodeInfoPtr->ExecutePtr;
     instruction->setRepAttr(attr & (BxRepeatable | BxRepeatableZF));
   }
   else {
@@ -1840,7 +1974,7 @@ modrm_done:
     // Note that a 2-byte opcode (0F XX) will jump to before
     // the if() above after fetching the 2nd byte, so this path is
     // taken in all cases if a modrm byte is NOT required.
-    instruction->execute = BxOpcodeInfo[b1+offset].ExecutePtr;
+    instruction->execute = BxOpcodeMap[b1+offset].ExecutePtr;
     instruction->IxForm.opcodeReg = b1 & 7;
   }
 
@@ -1998,3 +2132,183 @@ BX_CPU_C::BxResolveError(bxInstruction_c *i)
 {
   BX_PANIC(("BxResolveError: instruction with op1=0x%x", i->b1()));
 }
+
+#if BX_SUPPORT_CPU_BENCH
+
+/* ***************************************************************** */
+/* Decoder benchmark                                                 */
+/* ***************************************************************** */
+
+// Run by bx_init_hardware() when BXDECODEBENCH names a file of x86 code
+// in the environment, for example the a.out binaries of the Linux 0.12
+// root disk concatenated.  First every variant of the flattened opcode
+// map is compared with the group chain walk it replaced.  Then the file
+// is decoded as 32 bit code front to back, with warm caches and with the
+// caches evicted every BX_DECODE_BENCH_CHUNK instructions as after an
+// iCache purge, and the group lookup of those instructions is timed on
+// its own, flattened map against chain walk.
+
+#define BX_DECODE_BENCH_PASSES 5
+#define BX_DECODE_BENCH_CHUNK  32
+#define BX_DECODE_BENCH_CHUNKS 10000     // timed with cold caches
+#define BX_DECODE_BENCH_EVICT  (32 << 20)
+
+static Bit8u *bx_decode_bench_evict_buf;
+unsigned bx_decode_bench_sink;
+
+static void bx_decode_bench_evict(void)
+{
+  for (unsigned n=0; n<BX_DECODE_BENCH_EVICT; n+=64)
+    bx_decode_bench_evict_buf[n]++;
+}
+
+  void
+BX_CPU_C::decodeBench(const char *path)
+{
+  bxInstruction_c i;
+  BxOpcodeFlat_t ref;
+  unsigned key[4], used, part, n, op;
+  unsigned long checked = 0, mismatches = 0;
+
+  // the flattened map against the chain walk, for every opcode and key
+  for (op=0; op<512*2; op++) {
+    if (! (BxOpcodeInfo[op].Attr & BxGroupX)) continue;
+    for (n=0; n<512; n++) {
+      unsigned k = n, index = BxOpcodeMap[op].Index;
+      for (part=0; part<4; part++) {
+        key[part] = k % BxOpcodeMapRange[part];
+        k /= BxOpcodeMapRange[part];
+        index += key[part] * BxOpcodeMap[op].Stride[part];
+      }
+      used = 0;
+      BxResolveOpcode(op & 0x1ff, op & 0x200, key, &used, &ref);
+      checked++;
+      if (BxOpcodeFlat[index].Attr != ref.Attr ||
+          BxOpcodeFlat[index].ExecutePtr != ref.ExecutePtr) {
+        if (mismatches++ < 10)
+          fprintf(stderr, "decode bench: opcode 0x%03x key %u/%u/%u/%u differs\n",
+            op, key[0], key[1], key[2], key[3]);
+      }
+    }
+  }
+  fprintf(stderr, "decode bench: map check, %lu variants, %lu mismatches\n",
+    checked, mismatches);
+
+  FILE *fp = fopen(path, "rb");
+  if (fp == NULL) {
+    BX_PANIC(("decode bench: can't open '%s'", path));
+    return;
+  }
+  fseek(fp, 0, SEEK_END);
+  unsigned long len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  // padded with NOPs so that the last instruction never runs short
+  Bit8u *buf = new Bit8u[len + 16];
+  memset(buf + len, 0x90, 16);
+  if (fread(buf, 1, len, fp) != len) {
+    BX_PANIC(("decode bench: can't read '%s'", path));
+  }
+  fclose(fp);
+
+  // Decoding raises #UD for some byte sequences, e.g. SSE opcodes with
+  // two prefixes.  Those are replaced by NOPs, so that the timed loops
+  // below never leave through the exception path.
+  volatile unsigned long fault_off = 0, patched = 0;
+  if (BX_SETJMP(BX_CPU_THIS_PTR jmp_buf_env)) {
+    BX_CPU_THIS_PTR errorno = 0;
+    buf[fault_off++] = 0x90;
+    patched++;
+  }
+  BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS].cache.u.segment.d_b = 1;
+  while (fault_off < len) {
+    fault_off += fetchDecode(buf + fault_off, &i, 15) ? i.ilen() : 1;
+  }
+
+  unsigned long off;
+
+  // warm: the whole file, several times over
+  unsigned long insns = 0, ngroup = 0;
+  Bit64u t0 = bx_get_realtime64_usec();
+  for (unsigned pass=0; pass<BX_DECODE_BENCH_PASSES; pass++) {
+    for (off=0; off<len; insns++)
+      off += fetchDecode(buf + off, &i, 15) ? i.ilen() : 1;
+  }
+  Bit64u warm = bx_get_realtime64_usec() - t0;
+
+  // the opcode and key of every instruction that goes through a group
+  Bit16u *gop = new Bit16u[insns / BX_DECODE_BENCH_PASSES];
+  Bit8u *gkey = new Bit8u[insns / BX_DECODE_BENCH_PASSES];
+  for (off=0; off<len; ) {
+    if (fetchDecode(buf + off, &i, 15)) {
+      op = i.b1() + (i.os32L() ? 512 : 0);
+      if (BxOpcodeInfo[op].Attr & BxGroupX) {
+        gop[ngroup] = op;
+        gkey[ngroup++] = (i.nnn() & 7) | ((i.rm() & 7) << 3) | (i.modC0() ? 0x40 : 0);
+      }
+      off += i.ilen();
+    }
+    else off++;
+  }
+
+  // cold: evict the caches before every chunk of instructions and time
+  // only the decoding.  A chunk is shorter than the clock resolution, but
+  // the evictions take long enough to make the rounding even out.
+  bx_decode_bench_evict_buf = new Bit8u[BX_DECODE_BENCH_EVICT];
+  memset(bx_decode_bench_evict_buf, 0, BX_DECODE_BENCH_EVICT);
+  unsigned long cold_insns = 0, chunks = 0;
+  Bit64u cold = 0;
+  for (off=0; off<len && chunks<BX_DECODE_BENCH_CHUNKS; chunks++) {
+    bx_decode_bench_evict();
+    t0 = bx_get_realtime64_usec();
+    for (n=0; n<BX_DECODE_BENCH_CHUNK && off<len; n++, cold_insns++)
+      off += fetchDecode(buf + off, &i, 15) ? i.ilen() : 1;
+    cold += bx_get_realtime64_usec() - t0;
+  }
+
+  // group lookup alone, both ways; the SSE prefix is taken as none
+  unsigned sink = 0;
+  Bit64u flat = 0, chain = 0;
+  for (unsigned pass=0; pass<BX_DECODE_BENCH_PASSES; pass++) {
+    t0 = bx_get_realtime64_usec();
+    for (unsigned long g=0; g<ngroup; g++) {
+      BxOpcodeMap_t *OpcodeMapPtr = &(BxOpcodeMap[gop[g]]);
+      unsigned index = OpcodeMapPtr->Index +
+                       (gkey[g] & 7) * OpcodeMapPtr->Stride[BX_OPMAP_NNN] +
+                ((gkey[g] >> 3) & 7) * OpcodeMapPtr->Stride[BX_OPMAP_RM] +
+                 (gkey[g] >> 6)      * OpcodeMapPtr->Stride[BX_OPMAP_MOD];
+      sink += BxOpcodeFlat[index].Attr;
+    }
+    flat += bx_get_realtime64_usec() - t0;
+    t0 = bx_get_realtime64_usec();
+    for (unsigned long g=0; g<ngroup; g++) {
+      key[BX_OPMAP_NNN] = gkey[g] & 7;
+      key[BX_OPMAP_RM]  = (gkey[g] >> 3) & 7;
+      key[BX_OPMAP_MOD] = gkey[g] >> 6;
+      key[BX_OPMAP_SSE] = 0;
+      BxResolveOpcode(gop[g] & 0x1ff, gop[g] & 0x200, key, &used, &ref);
+      sink += ref.Attr;
+    }
+    chain += bx_get_realtime64_usec() - t0;
+  }
+
+  fprintf(stderr, "decode bench: %s, %lu bytes, %lu patched to NOP\n",
+    path, len, (unsigned long) patched);
+  fprintf(stderr, "decode bench: warm, %lu insns, %.2f ns/insn\n",
+    insns, warm * 1000.0 / insns);
+  fprintf(stderr, "decode bench: cold, %lu insns, %.2f ns/insn\n",
+    cold_insns, cold * 1000.0 / cold_insns);
+  if (ngroup) {
+    fprintf(stderr, "decode bench: group lookup, %lu insns, flat %.2f ns, chain walk %.2f ns\n",
+      ngroup * BX_DECODE_BENCH_PASSES,
+      flat * 1000.0 / (ngroup * BX_DECODE_BENCH_PASSES),
+      chain * 1000.0 / (ngroup * BX_DECODE_BENCH_PASSES));
+  }
+  bx_decode_bench_sink = sink;
+
+  delete [] bx_decode_bench_evict_buf;
+  delete [] gkey;
+  delete [] gop;
+  delete [] buf;
+}
+
+#endif // BX_SUPPORT_CPU_BENCH
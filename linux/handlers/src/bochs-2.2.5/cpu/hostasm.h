@@ -661,4 +661,128 @@ asmShr32(Bit32u &result_32, Bit32u op1_32, unsigned count, Bit32u &flags32)
 
 #endif // (defined(_M_IX86) && defined(_MSC_VER) && BX_SupportHostAsms)
 
+// gcc on i386 or x86-64 hosts with SSE2: single SSE arithmetic instructions.
+// The host MXCSR is loaded with round to nearest, all exceptions masked,
+// no DAZ/FTZ and clear flags; the flags raised by the instruction are
+// returned in the layout of the MXCSR and float_exception_flag_t.  The
+// callers in sse_pfp.cc decide when the result equals softfloat's.
+#if ((defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__) && \
+     defined(__SSE2__) && BX_SupportHostAsms && BX_SUPPORT_SSE)
+
+#define BX_HostAsm_SSE
+
+#define BX_HOSTASM_SSE_OP(name, mov, op)                 \
+  static inline Bit32u                                   \
+name(void *dst, const void *src)                         \
+{                                                        \
+  Bit32u csr = 0x1f80;                                   \
+  asm volatile (                                         \
+    "ldmxcsr %0            \n\t"                          \
+    mov " (%1), %%xmm0     \n\t"                          \
+    mov " (%2), %%xmm1     \n\t"                          \
+    op  " %%xmm1, %%xmm0   \n\t"                          \
+    mov " %%xmm0, (%1)     \n\t"                          \
+    "stmxcsr %0"                                         \
+    : "+m" (csr)                                         \
+    : "r" (dst), "r" (src)                               \
+    : "xmm0", "xmm1", "memory"                           \
+    );                                                   \
+  return csr & 0x3f;                                     \
+}
+
+BX_HOSTASM_SSE_OP(asmAddps, "movups", "addps")
+BX_HOSTASM_SSE_OP(asmSubps, "movups", "subps")
+BX_HOSTASM_SSE_OP(asmMulps, "movups", "mulps")
+BX_HOSTASM_SSE_OP(asmDivps, "movups", "divps")
+BX_HOSTASM_SSE_OP(asmAddss, "movss",  "addss")
+BX_HOSTASM_SSE_OP(asmSubss, "movss",  "subss")
+BX_HOSTASM_SSE_OP(asmMulss, "movss",  "mulss")
+BX_HOSTASM_SSE_OP(asmDivss, "movss",  "divss")
+BX_HOSTASM_SSE_OP(asmAddpd, "movupd", "addpd")
+BX_HOSTASM_SSE_OP(asmSubpd, "movupd", "subpd")
+BX_HOSTASM_SSE_OP(asmMulpd, "movupd", "mulpd")
+BX_HOSTASM_SSE_OP(asmDivpd, "movupd", "divpd")
+BX_HOSTASM_SSE_OP(asmAddsd, "movsd",  "addsd")
+BX_HOSTASM_SSE_OP(asmSubsd, "movsd",  "subsd")
+BX_HOSTASM_SSE_OP(asmMulsd, "movsd",  "mulsd")
+BX_HOSTASM_SSE_OP(asmDivsd, "movsd",  "divsd")
+
+#endif // gcc on i386/x86-64 with SSE2
+
+// gcc hosts that do double arithmetic in SSE2 registers: every operation
+// is rounded once to 53 bits with the default round to nearest of the
+// MXCSR, there is no extended intermediate precision as with the x87.
+// Used for the x87 fast paths in fpu_arith.cc.
+#if (defined(__GNUC__) && defined(__SSE2_MATH__) && \
+     BX_SupportHostAsms && BX_SupportHostAsmsFpu)
+#define BX_HostAsm_Double
+#endif
+
+// gcc on i386 or x86-64 hosts with SSE2: packed integer MMX and SSE2
+// instructions done with the matching host instruction.  MMX registers
+// are loaded into the low half of an XMM register with the high half
+// zeroed, so only PACK and PUNPCKH need more than the plain intrinsic.
+// Without BX_HostAsm_SIMD the scalar code in mmx.cc and sse.cc is used.
+#if ((defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__) && \
+     defined(__SSE2__) && BX_SupportHostAsms && (BX_SUPPORT_MMX || BX_SUPPORT_SSE))
+
+#include <emmintrin.h>
+
+#define BX_HostAsm_SIMD
+
+#define BX_HOSTSIMD_LOAD64(reg)   _mm_loadl_epi64((const __m128i *) &(reg))
+#define BX_HOSTSIMD_LOAD128(reg)  _mm_loadu_si128((const __m128i *) &(reg))
+
+// result = op(op1, op2), any of them may be the same register
+#define BX_HOSTSIMD_MMX(result, op, op1, op2)                            \
+  _mm_storel_epi64((__m128i *) &(result),                                \
+    op(BX_HOSTSIMD_LOAD64(op1), BX_HOSTSIMD_LOAD64(op2)))
+#define BX_HOSTSIMD_XMM(result, op, op1, op2)                            \
+  _mm_storeu_si128((__m128i *) &(result),                                \
+    op(BX_HOSTSIMD_LOAD128(op1), BX_HOSTSIMD_LOAD128(op2)))
+
+// shifts by an immediate count, which is not a compile time constant here
+#define BX_HOSTSIMD_MMX_SHIFT(result, op, op1, shift)                    \
+  _mm_storel_epi64((__m128i *) &(result),                                \
+    op(BX_HOSTSIMD_LOAD64(op1), _mm_cvtsi32_si128(shift)))
+#define BX_HOSTSIMD_XMM_SHIFT(result, op, op1, shift)                    \
+  _mm_storeu_si128((__m128i *) &(result),                                \
+    op(BX_HOSTSIMD_LOAD128(op1), _mm_cvtsi32_si128(shift)))
+
+// MMX packs take the low half of the result from op1 and the high half
+// from op2, so both are put into one register and packed together
+static inline __m128i bx_mmx_packs_epi16(__m128i a, __m128i b)
+{
+  return _mm_packs_epi16(_mm_unpacklo_epi64(a, b), a);
+}
+
+static inline __m128i bx_mmx_packs_epi32(__m128i a, __m128i b)
+{
+  return _mm_packs_epi32(_mm_unpacklo_epi64(a, b), a);
+}
+
+static inline __m128i bx_mmx_packus_epi16(__m128i a, __m128i b)
+{
+  return _mm_packus_epi16(_mm_unpacklo_epi64(a, b), a);
+}
+
+// MMX PUNPCKH interleaves the high halves of 64 bit operands, which is the
+// upper half of the SSE2 PUNPCKL result
+static inline __m128i bx_mmx_unpackhi_epi8(__m128i a, __m128i b)
+{
+  return _mm_srli_si128(_mm_unpacklo_epi8(a, b), 8);
+}
+
+static inline __m128i bx_mmx_unpackhi_epi16(__m128i a, __m128i b)
+{
+  return _mm_srli_si128(_mm_unpacklo_epi16(a, b), 8);
+}
+
+static inline __m128i bx_mmx_unpackhi_epi32(__m128i a, __m128i b)
+{
+  return _mm_srli_si128(_mm_unpacklo_epi32(a, b), 8);
+}
+
+#endif // gcc on i386/x86-64 with SSE2
+
 #endif // BX_HOSTASM_H
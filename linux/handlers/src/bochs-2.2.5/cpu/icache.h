@@ -46,10 +46,11 @@ class bxPageWriteStampTable
 
   Bit32u *pageWriteStampTable;
   Bit32u  memSizeInBytes;
+  Bit32u  resetCount;     // bumped whenever all stamps are reset
 
 public:
-  bxPageWriteStampTable(): pageWriteStampTable(NULL), memSizeInBytes(0) {}
-  bxPageWriteStampTable(Bit32u memSize) { alloc(memSize); }
+  bxPageWriteStampTable(): pageWriteStampTable(NULL), memSizeInBytes(0), resetCount(0) {}
+  bxPageWriteStampTable(Bit32u memSize): resetCount(0) { alloc(memSize); }
  ~bxPageWriteStampTable() { delete [] pageWriteStampTable; }
 
   BX_CPP_INLINE void alloc(Bit32u memSize)
@@ -94,6 +95,11 @@ public:
     }
   }
 
+  // Stamps restart from ICacheWriteStampMax after a reset, so a stamp
+  // saved by someone else than the iCache is only meaningful together
+  // with the reset count it was taken under.
+  BX_CPP_INLINE Bit32u getResetCount(void) const { return resetCount; }
+
   BX_CPP_INLINE void resetWriteStamps(void);
 };
 
@@ -102,6 +108,7 @@ BX_CPP_INLINE void bxPageWriteStampTable::resetWriteStamps(void)
   for (Bit32u i=0; i<(memSizeInBytes>>12); i++) {
     pageWriteStampTable[i] = ICacheWriteStampInvalid;
   }
+  resetCount++;
 }
 
 extern bxPageWriteStampTable pageWriteStampTable;
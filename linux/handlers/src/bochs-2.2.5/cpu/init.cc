@@ -195,6 +195,9 @@ void BX_CPU_C::initialize(BX_MEM_C *addrspace)
   _16bit_index_reg[6] = (Bit16u*) &empty_register;
   _16bit_index_reg[7] = (Bit16u*) &empty_register;
 
+  // flattened opcode tables for fetchDecode()
+  initOpcodeMap();
+
 // <TAG-INIT-CPU-START>
   // for decoding instructions: access to seg reg's via index number
   sreg_mod00_rm16[0] = BX_SEG_REG_DS;
@@ -284,6 +287,10 @@ void BX_CPU_C::initialize(BX_MEM_C *addrspace)
   mem = addrspace;
   sprintf (name, "CPU %d", which_cpu());
 
+#if BX_SUPPORT_STATS
+  memset(&stats, 0, sizeof(stats));
+#endif
+
 #if BX_WITH_WX
   static bx_bool first_time = 1;
   if (first_time) {
@@ -858,6 +865,9 @@ void BX_CPU_C::reset(unsigned source)
   BX_CPU_THIS_PTR async_event=2;
 #endif
   BX_CPU_THIS_PTR kill_bochs_request = 0;
+#if BX_SMP_PROCESSORS > 1
+  BX_CPU_THIS_PTR spin_wait = 0;
+#endif
 
   BX_INSTR_RESET(BX_CPU_ID);
 }
@@ -146,7 +146,7 @@ void BX_CPU_C::INSW_YvDX(bxInstruction_c *i)
 
 #if BX_SupportRepeatSpeedups
 #if (BX_DEBUGGER == 0)
-#if (defined(__i386__) && __i386__)
+#if (defined(__i386__) && __i386__) || (defined(__x86_64__) && __x86_64__)
     /* If conditions are right, we can transfer IO to physical memory
      * in a batch, rather than one instruction at a time.
      */
@@ -299,7 +299,7 @@ void BX_CPU_C::INSW_YvDX(bxInstruction_c *i)
 
 noAcceleration:
 
-#endif  // __i386__
+#endif  // __i386__ || __x86_64__
 #endif  // (BX_DEBUGGER == 0)
 #endif  // #if BX_SupportRepeatSpeedups
 
@@ -316,7 +316,7 @@ noAcceleration:
 
 #if BX_SupportRepeatSpeedups
 #if (BX_DEBUGGER == 0)
-#if (defined(__i386__) && __i386__)
+#if (defined(__i386__) && __i386__) || (defined(__x86_64__) && __x86_64__)
 doIncr:
 #endif
 #endif
@@ -450,7 +450,7 @@ void BX_CPU_C::OUTSW_DXXv(bxInstruction_c *i)
 
 #if BX_SupportRepeatSpeedups
 #if (BX_DEBUGGER == 0)
-#if (defined(__i386__) && __i386__)
+#if (defined(__i386__) && __i386__) || (defined(__x86_64__) && __x86_64__)
     /* If conditions are right, we can transfer IO to physical memory
      * in a batch, rather than one instruction at a time.
      */
@@ -603,7 +603,7 @@ void BX_CPU_C::OUTSW_DXXv(bxInstruction_c *i)
 
 noAcceleration:
 
-#endif // __i386__
+#endif // __i386__ || __x86_64__
 #endif  // (BX_DEBUGGER == 0)
 #endif  // #if BX_SupportRepeatSpeedups
 
@@ -615,7 +615,7 @@ noAcceleration:
 
 #if BX_SupportRepeatSpeedups
 #if (BX_DEBUGGER == 0)
-#if (defined(__i386__) && __i386__)
+#if (defined(__i386__) && __i386__) || (defined(__x86_64__) && __x86_64__)
 doIncr:
 #endif
 #endif
@@ -131,6 +131,9 @@ void BX_CPU_C::PUNPCKLBW_PqQd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_unpacklo_epi8, op1, op2);
+#else
   MMXUB7(result) = MMXUB3(op2);
   MMXUB6(result) = MMXUB3(op1);
   MMXUB5(result) = MMXUB2(op2);
@@ -139,6 +142,7 @@ void BX_CPU_C::PUNPCKLBW_PqQd(bxInstruction_c *i)
   MMXUB2(result) = MMXUB1(op1);
   MMXUB1(result) = MMXUB0(op2);
   MMXUB0(result) = MMXUB0(op1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -165,10 +169,14 @@ void BX_CPU_C::PUNPCKLWD_PqQd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_unpacklo_epi16, op1, op2);
+#else
   MMXUW3(result) = MMXUW1(op2);
   MMXUW2(result) = MMXUW1(op1);
   MMXUW1(result) = MMXUW0(op2);
   MMXUW0(result) = MMXUW0(op1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -195,7 +203,11 @@ void BX_CPU_C::PUNPCKLDQ_PqQd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_unpacklo_epi32, op1, op2);
+#else
   MMXUD1(op1) = MMXUD0(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -222,6 +234,9 @@ void BX_CPU_C::PACKSSWB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, bx_mmx_packs_epi16, op1, op2);
+#else
   MMXSB0(result) = SaturateWordSToByteS(MMXSW0(op1));
   MMXSB1(result) = SaturateWordSToByteS(MMXSW1(op1));
   MMXSB2(result) = SaturateWordSToByteS(MMXSW2(op1));
@@ -230,6 +245,7 @@ void BX_CPU_C::PACKSSWB_PqQq(bxInstruction_c *i)
   MMXSB5(result) = SaturateWordSToByteS(MMXSW1(op2));
   MMXSB6(result) = SaturateWordSToByteS(MMXSW2(op2));
   MMXSB7(result) = SaturateWordSToByteS(MMXSW3(op2));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -256,6 +272,9 @@ void BX_CPU_C::PCMPGTB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_cmpgt_epi8, op1, op2);
+#else
   MMXUB0(op1) = (MMXSB0(op1) > MMXSB0(op2)) ? 0xff : 0;
   MMXUB1(op1) = (MMXSB1(op1) > MMXSB1(op2)) ? 0xff : 0;
   MMXUB2(op1) = (MMXSB2(op1) > MMXSB2(op2)) ? 0xff : 0;
@@ -264,6 +283,7 @@ void BX_CPU_C::PCMPGTB_PqQq(bxInstruction_c *i)
   MMXUB5(op1) = (MMXSB5(op1) > MMXSB5(op2)) ? 0xff : 0;
   MMXUB6(op1) = (MMXSB6(op1) > MMXSB6(op2)) ? 0xff : 0;
   MMXUB7(op1) = (MMXSB7(op1) > MMXSB7(op2)) ? 0xff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -290,10 +310,14 @@ void BX_CPU_C::PCMPGTW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_cmpgt_epi16, op1, op2);
+#else
   MMXUW0(op1) = (MMXSW0(op1) > MMXSW0(op2)) ? 0xffff : 0;
   MMXUW1(op1) = (MMXSW1(op1) > MMXSW1(op2)) ? 0xffff : 0;
   MMXUW2(op1) = (MMXSW2(op1) > MMXSW2(op2)) ? 0xffff : 0;
   MMXUW3(op1) = (MMXSW3(op1) > MMXSW3(op2)) ? 0xffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -320,8 +344,12 @@ void BX_CPU_C::PCMPGTD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_cmpgt_epi32, op1, op2);
+#else
   MMXUD0(op1) = (MMXSD0(op1) > MMXSD0(op2)) ? 0xffffffff : 0;
   MMXUD1(op1) = (MMXSD1(op1) > MMXSD1(op2)) ? 0xffffffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -348,6 +376,9 @@ void BX_CPU_C::PACKUSWB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, bx_mmx_packus_epi16, op1, op2);
+#else
   MMXUB0(result) = SaturateWordSToByteU(MMXSW0(op1));
   MMXUB1(result) = SaturateWordSToByteU(MMXSW1(op1));
   MMXUB2(result) = SaturateWordSToByteU(MMXSW2(op1));
@@ -356,6 +387,7 @@ void BX_CPU_C::PACKUSWB_PqQq(bxInstruction_c *i)
   MMXUB5(result) = SaturateWordSToByteU(MMXSW1(op2));
   MMXUB6(result) = SaturateWordSToByteU(MMXSW2(op2));
   MMXUB7(result) = SaturateWordSToByteU(MMXSW3(op2));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -382,6 +414,9 @@ void BX_CPU_C::PUNPCKHBW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, bx_mmx_unpackhi_epi8, op1, op2);
+#else
   MMXUB7(result) = MMXUB7(op2);
   MMXUB6(result) = MMXUB7(op1);
   MMXUB5(result) = MMXUB6(op2);
@@ -390,6 +425,7 @@ void BX_CPU_C::PUNPCKHBW_PqQq(bxInstruction_c *i)
   MMXUB2(result) = MMXUB5(op1);
   MMXUB1(result) = MMXUB4(op2);
   MMXUB0(result) = MMXUB4(op1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -416,10 +452,14 @@ void BX_CPU_C::PUNPCKHWD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, bx_mmx_unpackhi_epi16, op1, op2);
+#else
   MMXUW3(result) = MMXUW3(op2);
   MMXUW2(result) = MMXUW3(op1);
   MMXUW1(result) = MMXUW2(op2);
   MMXUW0(result) = MMXUW2(op1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -446,8 +486,12 @@ void BX_CPU_C::PUNPCKHDQ_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, bx_mmx_unpackhi_epi32, op1, op2);
+#else
   MMXUD1(result) = MMXUD1(op2);
   MMXUD0(result) = MMXUD1(op1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -474,10 +518,14 @@ void BX_CPU_C::PACKSSDW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, bx_mmx_packs_epi32, op1, op2);
+#else
   MMXSW0(result) = SaturateDwordSToWordS(MMXSD0(op1));
   MMXSW1(result) = SaturateDwordSToWordS(MMXSD1(op1));
   MMXSW2(result) = SaturateDwordSToWordS(MMXSD0(op2));
   MMXSW3(result) = SaturateDwordSToWordS(MMXSD1(op2));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -603,6 +651,9 @@ void BX_CPU_C::PCMPEQB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_cmpeq_epi8, op1, op2);
+#else
   MMXUB0(op1) = (MMXUB0(op1) == MMXUB0(op2)) ? 0xff : 0;
   MMXUB1(op1) = (MMXUB1(op1) == MMXUB1(op2)) ? 0xff : 0;
   MMXUB2(op1) = (MMXUB2(op1) == MMXUB2(op2)) ? 0xff : 0;
@@ -611,6 +662,7 @@ void BX_CPU_C::PCMPEQB_PqQq(bxInstruction_c *i)
   MMXUB5(op1) = (MMXUB5(op1) == MMXUB5(op2)) ? 0xff : 0;
   MMXUB6(op1) = (MMXUB6(op1) == MMXUB6(op2)) ? 0xff : 0;
   MMXUB7(op1) = (MMXUB7(op1) == MMXUB7(op2)) ? 0xff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -637,10 +689,14 @@ void BX_CPU_C::PCMPEQW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_cmpeq_epi16, op1, op2);
+#else
   MMXUW0(op1) = (MMXUW0(op1) == MMXUW0(op2)) ? 0xffff : 0;
   MMXUW1(op1) = (MMXUW1(op1) == MMXUW1(op2)) ? 0xffff : 0;
   MMXUW2(op1) = (MMXUW2(op1) == MMXUW2(op2)) ? 0xffff : 0;
   MMXUW3(op1) = (MMXUW3(op1) == MMXUW3(op2)) ? 0xffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -667,8 +723,12 @@ void BX_CPU_C::PCMPEQD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_cmpeq_epi32, op1, op2);
+#else
   MMXUD0(op1) = (MMXUD0(op1) == MMXUD0(op2)) ? 0xffffffff : 0;
   MMXUD1(op1) = (MMXUD1(op1) == MMXUD1(op2)) ? 0xffffffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -809,6 +869,9 @@ void BX_CPU_C::PSRLW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_srl_epi16, op1, op2);
+#else
   if(MMXUQ(op2) > 15) MMXUQ(op1) = 0;
   else
   {
@@ -819,6 +882,7 @@ void BX_CPU_C::PSRLW_PqQq(bxInstruction_c *i)
     MMXUW2(op1) >>= shift;
     MMXUW3(op1) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -845,6 +909,9 @@ void BX_CPU_C::PSRLD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_srl_epi32, op1, op2);
+#else
   if(MMXUQ(op2) > 31) MMXUQ(op1) = 0;
   else
   {
@@ -853,6 +920,7 @@ void BX_CPU_C::PSRLD_PqQq(bxInstruction_c *i)
     MMXUD0(op1) >>= shift;
     MMXUD1(op1) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -879,12 +947,16 @@ void BX_CPU_C::PSRLQ_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_srl_epi64, op1, op2);
+#else
   if(MMXUQ(op2) > 63) {
     MMXUQ(op1) = 0;
   }
   else {
     MMXUQ(op1) >>= MMXUB0(op2);
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -911,7 +983,11 @@ void BX_CPU_C::PADDQ_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_add_epi64, op1, op2);
+#else
   MMXUQ(op1) += MMXUQ(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -938,6 +1014,9 @@ void BX_CPU_C::PMULLW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_mullo_epi16, op1, op2);
+#else
   Bit32u product1 = Bit32u(MMXUW0(op1)) * Bit32u(MMXUW0(op2));
   Bit32u product2 = Bit32u(MMXUW1(op1)) * Bit32u(MMXUW1(op2));
   Bit32u product3 = Bit32u(MMXUW2(op1)) * Bit32u(MMXUW2(op2));
@@ -947,6 +1026,7 @@ void BX_CPU_C::PMULLW_PqQq(bxInstruction_c *i)
   MMXUW1(result) = product2 & 0xffff;
   MMXUW2(result) = product3 & 0xffff;
   MMXUW3(result) = product4 & 0xffff;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -965,6 +1045,9 @@ void BX_CPU_C::PMOVMSKB_GdPRq(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit32u result = 0;
 
+#if defined(BX_HostAsm_SIMD)
+  result = _mm_movemask_epi8(BX_HOSTSIMD_LOAD64(op));
+#else
   if(MMXUB0(op) & 0x80) result |= 0x01; 
   if(MMXUB1(op) & 0x80) result |= 0x02;
   if(MMXUB2(op) & 0x80) result |= 0x04;
@@ -973,6 +1056,7 @@ void BX_CPU_C::PMOVMSKB_GdPRq(bxInstruction_c *i)
   if(MMXUB5(op) & 0x80) result |= 0x20;
   if(MMXUB6(op) & 0x80) result |= 0x40;
   if(MMXUB7(op) & 0x80) result |= 0x80;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_32BIT_REGZ(i->nnn(), result);
@@ -1000,6 +1084,9 @@ void BX_CPU_C::PSUBUSB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_subs_epu8, op1, op2);
+#else
   MMXUQ(result) = 0;
 
   if(MMXUB0(op1) > MMXUB0(op2)) MMXUB0(result) = MMXUB0(op1) - MMXUB0(op2);
@@ -1010,6 +1097,7 @@ void BX_CPU_C::PSUBUSB_PqQq(bxInstruction_c *i)
   if(MMXUB5(op1) > MMXUB5(op2)) MMXUB5(result) = MMXUB5(op1) - MMXUB5(op2);
   if(MMXUB6(op1) > MMXUB6(op2)) MMXUB6(result) = MMXUB6(op1) - MMXUB6(op2);
   if(MMXUB7(op1) > MMXUB7(op2)) MMXUB7(result) = MMXUB7(op1) - MMXUB7(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1036,12 +1124,16 @@ void BX_CPU_C::PSUBUSW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_subs_epu16, op1, op2);
+#else
   MMXUQ(result) = 0;
 
   if(MMXUW0(op1) > MMXUW0(op2)) MMXUW0(result) = MMXUW0(op1) - MMXUW0(op2);
   if(MMXUW1(op1) > MMXUW1(op2)) MMXUW1(result) = MMXUW1(op1) - MMXUW1(op2);
   if(MMXUW2(op1) > MMXUW2(op2)) MMXUW2(result) = MMXUW2(op1) - MMXUW2(op2);
   if(MMXUW3(op1) > MMXUW3(op2)) MMXUW3(result) = MMXUW3(op1) - MMXUW3(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1068,6 +1160,9 @@ void BX_CPU_C::PMINUB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_min_epu8, op1, op2);
+#else
   if(MMXUB0(op2) < MMXUB0(op1)) MMXUB0(op1) = MMXUB0(op2);
   if(MMXUB1(op2) < MMXUB1(op1)) MMXUB1(op1) = MMXUB1(op2);
   if(MMXUB2(op2) < MMXUB2(op1)) MMXUB2(op1) = MMXUB2(op2);
@@ -1076,6 +1171,7 @@ void BX_CPU_C::PMINUB_PqQq(bxInstruction_c *i)
   if(MMXUB5(op2) < MMXUB5(op1)) MMXUB5(op1) = MMXUB5(op2);
   if(MMXUB6(op2) < MMXUB6(op1)) MMXUB6(op1) = MMXUB6(op2);
   if(MMXUB7(op2) < MMXUB7(op1)) MMXUB7(op1) = MMXUB7(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1102,7 +1198,11 @@ void BX_CPU_C::PAND_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_and_si128, op1, op2);
+#else
   MMXUQ(op1) &= MMXUQ(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1129,6 +1229,9 @@ void BX_CPU_C::PADDUSB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_adds_epu8, op1, op2);
+#else
   MMXUB0(result) = SaturateWordSToByteU(Bit16s(MMXUB0(op1)) + Bit16s(MMXUB0(op2)));
   MMXUB1(result) = SaturateWordSToByteU(Bit16s(MMXUB1(op1)) + Bit16s(MMXUB1(op2)));
   MMXUB2(result) = SaturateWordSToByteU(Bit16s(MMXUB2(op1)) + Bit16s(MMXUB2(op2)));
@@ -1137,6 +1240,7 @@ void BX_CPU_C::PADDUSB_PqQq(bxInstruction_c *i)
   MMXUB5(result) = SaturateWordSToByteU(Bit16s(MMXUB5(op1)) + Bit16s(MMXUB5(op2)));
   MMXUB6(result) = SaturateWordSToByteU(Bit16s(MMXUB6(op1)) + Bit16s(MMXUB6(op2)));
   MMXUB7(result) = SaturateWordSToByteU(Bit16s(MMXUB7(op1)) + Bit16s(MMXUB7(op2)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1163,10 +1267,14 @@ void BX_CPU_C::PADDUSW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_adds_epu16, op1, op2);
+#else
   MMXUW0(result) = SaturateDwordSToWordU(Bit32s(MMXUW0(op1)) + Bit32s(MMXUW0(op2)));
   MMXUW1(result) = SaturateDwordSToWordU(Bit32s(MMXUW1(op1)) + Bit32s(MMXUW1(op2)));
   MMXUW2(result) = SaturateDwordSToWordU(Bit32s(MMXUW2(op1)) + Bit32s(MMXUW2(op2)));
   MMXUW3(result) = SaturateDwordSToWordU(Bit32s(MMXUW3(op1)) + Bit32s(MMXUW3(op2)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1193,6 +1301,9 @@ void BX_CPU_C::PMAXUB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_max_epu8, op1, op2);
+#else
   if(MMXUB0(op2) > MMXUB0(op1)) MMXUB0(op1) = MMXUB0(op2);
   if(MMXUB1(op2) > MMXUB1(op1)) MMXUB1(op1) = MMXUB1(op2);
   if(MMXUB2(op2) > MMXUB2(op1)) MMXUB2(op1) = MMXUB2(op2);
@@ -1201,6 +1312,7 @@ void BX_CPU_C::PMAXUB_PqQq(bxInstruction_c *i)
   if(MMXUB5(op2) > MMXUB5(op1)) MMXUB5(op1) = MMXUB5(op2);
   if(MMXUB6(op2) > MMXUB6(op1)) MMXUB6(op1) = MMXUB6(op2);
   if(MMXUB7(op2) > MMXUB7(op1)) MMXUB7(op1) = MMXUB7(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1227,7 +1339,11 @@ void BX_CPU_C::PANDN_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_andnot_si128, op1, op2);
+#else
   MMXUQ(op1) = ~(MMXUQ(op1)) & MMXUQ(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1254,6 +1370,9 @@ void BX_CPU_C::PAVGB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_avg_epu8, op1, op2);
+#else
   MMXUB0(op1) = (MMXUB0(op1) + MMXUB0(op2) + 1) >> 1;
   MMXUB1(op1) = (MMXUB1(op1) + MMXUB1(op2) + 1) >> 1;
   MMXUB2(op1) = (MMXUB2(op1) + MMXUB2(op2) + 1) >> 1;
@@ -1262,6 +1381,7 @@ void BX_CPU_C::PAVGB_PqQq(bxInstruction_c *i)
   MMXUB5(op1) = (MMXUB5(op1) + MMXUB5(op2) + 1) >> 1;
   MMXUB6(op1) = (MMXUB6(op1) + MMXUB6(op2) + 1) >> 1;
   MMXUB7(op1) = (MMXUB7(op1) + MMXUB7(op2) + 1) >> 1;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1288,6 +1408,9 @@ void BX_CPU_C::PSRAW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_sra_epi16, op1, op2);
+#else
   if(!MMXUQ(op2)) {
     BX_WRITE_MMX_REG(i->nnn(), op1);
     return;
@@ -1312,6 +1435,7 @@ void BX_CPU_C::PSRAW_PqQq(bxInstruction_c *i)
     if(MMXUW2(op1) & 0x8000) MMXUW2(result) |= (0xffff << (16 - shift));
     if(MMXUW3(op1) & 0x8000) MMXUW3(result) |= (0xffff << (16 - shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1338,6 +1462,9 @@ void BX_CPU_C::PSRAD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_sra_epi32, op1, op2);
+#else
   if(!MMXUQ(op2)) {
     BX_WRITE_MMX_REG(i->nnn(), op1);
     return;
@@ -1359,6 +1486,7 @@ void BX_CPU_C::PSRAD_PqQq(bxInstruction_c *i)
     if(MMXUD1(op1) & 0x80000000) 
        MMXUD1(result) |= (0xffffffff << (32 - shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1385,10 +1513,14 @@ void BX_CPU_C::PAVGW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_avg_epu16, op1, op2);
+#else
   MMXUW0(op1) = (MMXUW0(op1) + MMXUW0(op2) + 1) >> 1;
   MMXUW1(op1) = (MMXUW1(op1) + MMXUW1(op2) + 1) >> 1;
   MMXUW2(op1) = (MMXUW2(op1) + MMXUW2(op2) + 1) >> 1;
   MMXUW3(op1) = (MMXUW3(op1) + MMXUW3(op2) + 1) >> 1;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1415,6 +1547,9 @@ void BX_CPU_C::PMULHUW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_mulhi_epu16, op1, op2);
+#else
   Bit32u product1 = Bit32u(MMXUW0(op1)) * Bit32u(MMXUW0(op2));
   Bit32u product2 = Bit32u(MMXUW1(op1)) * Bit32u(MMXUW1(op2));
   Bit32u product3 = Bit32u(MMXUW2(op1)) * Bit32u(MMXUW2(op2));
@@ -1424,6 +1559,7 @@ void BX_CPU_C::PMULHUW_PqQq(bxInstruction_c *i)
   MMXUW1(result) = (Bit16u)(product2 >> 16);
   MMXUW2(result) = (Bit16u)(product3 >> 16);
   MMXUW3(result) = (Bit16u)(product4 >> 16);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1450,6 +1586,9 @@ void BX_CPU_C::PMULHW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_mulhi_epi16, op1, op2);
+#else
   Bit32s product1 = Bit32s(MMXSW0(op1)) * Bit32s(MMXSW0(op2));
   Bit32s product2 = Bit32s(MMXSW1(op1)) * Bit32s(MMXSW1(op2));
   Bit32s product3 = Bit32s(MMXSW2(op1)) * Bit32s(MMXSW2(op2));
@@ -1459,6 +1598,7 @@ void BX_CPU_C::PMULHW_PqQq(bxInstruction_c *i)
   MMXUW1(result) = Bit16u(product2 >> 16);
   MMXUW2(result) = Bit16u(product3 >> 16);
   MMXUW3(result) = Bit16u(product4 >> 16);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1505,6 +1645,9 @@ void BX_CPU_C::PSUBSB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_subs_epi8, op1, op2);
+#else
   MMXSB0(result) = SaturateWordSToByteS(Bit16s(MMXSB0(op1)) - Bit16s(MMXSB0(op2)));
   MMXSB1(result) = SaturateWordSToByteS(Bit16s(MMXSB1(op1)) - Bit16s(MMXSB1(op2)));
   MMXSB2(result) = SaturateWordSToByteS(Bit16s(MMXSB2(op1)) - Bit16s(MMXSB2(op2)));
@@ -1513,6 +1656,7 @@ void BX_CPU_C::PSUBSB_PqQq(bxInstruction_c *i)
   MMXSB5(result) = SaturateWordSToByteS(Bit16s(MMXSB5(op1)) - Bit16s(MMXSB5(op2)));
   MMXSB6(result) = SaturateWordSToByteS(Bit16s(MMXSB6(op1)) - Bit16s(MMXSB6(op2)));
   MMXSB7(result) = SaturateWordSToByteS(Bit16s(MMXSB7(op1)) - Bit16s(MMXSB7(op2)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1539,10 +1683,14 @@ void BX_CPU_C::PSUBSW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_subs_epi16, op1, op2);
+#else
   MMXSW0(result) = SaturateDwordSToWordS(Bit32s(MMXSW0(op1)) - Bit32s(MMXSW0(op2)));
   MMXSW1(result) = SaturateDwordSToWordS(Bit32s(MMXSW1(op1)) - Bit32s(MMXSW1(op2)));
   MMXSW2(result) = SaturateDwordSToWordS(Bit32s(MMXSW2(op1)) - Bit32s(MMXSW2(op2)));
   MMXSW3(result) = SaturateDwordSToWordS(Bit32s(MMXSW3(op1)) - Bit32s(MMXSW3(op2)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1569,10 +1717,14 @@ void BX_CPU_C::PMINSW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_min_epi16, op1, op2);
+#else
   if(MMXSW0(op2) < MMXSW0(op1)) MMXSW0(op1) = MMXSW0(op2);
   if(MMXSW1(op2) < MMXSW1(op1)) MMXSW1(op1) = MMXSW1(op2);
   if(MMXSW2(op2) < MMXSW2(op1)) MMXSW2(op1) = MMXSW2(op2);
   if(MMXSW3(op2) < MMXSW3(op1)) MMXSW3(op1) = MMXSW3(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1599,7 +1751,11 @@ void BX_CPU_C::POR_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_or_si128, op1, op2);
+#else
   MMXUQ(op1) |= MMXUQ(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1626,6 +1782,9 @@ void BX_CPU_C::PADDSB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_adds_epi8, op1, op2);
+#else
   MMXSB0(result) = SaturateWordSToByteS(Bit16s(MMXSB0(op1)) + Bit16s(MMXSB0(op2)));
   MMXSB1(result) = SaturateWordSToByteS(Bit16s(MMXSB1(op1)) + Bit16s(MMXSB1(op2)));
   MMXSB2(result) = SaturateWordSToByteS(Bit16s(MMXSB2(op1)) + Bit16s(MMXSB2(op2)));
@@ -1634,6 +1793,7 @@ void BX_CPU_C::PADDSB_PqQq(bxInstruction_c *i)
   MMXSB5(result) = SaturateWordSToByteS(Bit16s(MMXSB5(op1)) + Bit16s(MMXSB5(op2)));
   MMXSB6(result) = SaturateWordSToByteS(Bit16s(MMXSB6(op1)) + Bit16s(MMXSB6(op2)));
   MMXSB7(result) = SaturateWordSToByteS(Bit16s(MMXSB7(op1)) + Bit16s(MMXSB7(op2)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1660,10 +1820,14 @@ void BX_CPU_C::PADDSW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_adds_epi16, op1, op2);
+#else
   MMXSW0(result) = SaturateDwordSToWordS(Bit32s(MMXSW0(op1)) + Bit32s(MMXSW0(op2)));
   MMXSW1(result) = SaturateDwordSToWordS(Bit32s(MMXSW1(op1)) + Bit32s(MMXSW1(op2)));
   MMXSW2(result) = SaturateDwordSToWordS(Bit32s(MMXSW2(op1)) + Bit32s(MMXSW2(op2)));
   MMXSW3(result) = SaturateDwordSToWordS(Bit32s(MMXSW3(op1)) + Bit32s(MMXSW3(op2)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1690,10 +1854,14 @@ void BX_CPU_C::PMAXSW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_max_epi16, op1, op2);
+#else
   if(MMXSW0(op2) > MMXSW0(op1)) MMXSW0(op1) = MMXSW0(op2);
   if(MMXSW1(op2) > MMXSW1(op1)) MMXSW1(op1) = MMXSW1(op2);
   if(MMXSW2(op2) > MMXSW2(op1)) MMXSW2(op1) = MMXSW2(op2);
   if(MMXSW3(op2) > MMXSW3(op1)) MMXSW3(op1) = MMXSW3(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1720,7 +1888,11 @@ void BX_CPU_C::PXOR_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_xor_si128, op1, op2);
+#else
   MMXUQ(op1) ^= MMXUQ(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1747,6 +1919,9 @@ void BX_CPU_C::PSLLW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sll_epi16, op1, op2);
+#else
   if(MMXUQ(op2) > 15) MMXUQ(op1) = 0;
   else
   {
@@ -1757,6 +1932,7 @@ void BX_CPU_C::PSLLW_PqQq(bxInstruction_c *i)
     MMXUW2(op1) <<= shift;
     MMXUW3(op1) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1783,6 +1959,9 @@ void BX_CPU_C::PSLLD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sll_epi32, op1, op2);
+#else
   if(MMXUQ(op2) > 31) MMXUQ(op1) = 0;
   else
   {
@@ -1791,6 +1970,7 @@ void BX_CPU_C::PSLLD_PqQq(bxInstruction_c *i)
     MMXUD0(op1) <<= shift;
     MMXUD1(op1) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1817,12 +1997,16 @@ void BX_CPU_C::PSLLQ_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sll_epi64, op1, op2);
+#else
   if(MMXUQ(op2) > 63) {
     MMXUQ(op1) = 0;
   }
   else {
     MMXUQ(op1) <<= MMXUB0(op2);
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -1849,7 +2033,11 @@ void BX_CPU_C::PMULUDQ_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_mul_epu32, op1, op2);
+#else
   MMXUQ(result) = Bit64u(MMXUD0(op1)) * Bit64u(MMXUD0(op2));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1876,6 +2064,9 @@ void BX_CPU_C::PMADDWD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(result, _mm_madd_epi16, op1, op2);
+#else
   if(MMXUD0(op1) == 0x80008000 && MMXUD0(op2) == 0x80008000) {
     MMXUD0(result) = 0x80000000;
   }
@@ -1889,6 +2080,7 @@ void BX_CPU_C::PMADDWD_PqQq(bxInstruction_c *i)
   else {
     MMXUD1(result) = Bit32s(MMXSW2(op1))*Bit32s(MMXSW2(op2)) + Bit32s(MMXSW3(op1))*Bit32s(MMXSW3(op2));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), result);
@@ -1905,7 +2097,6 @@ void BX_CPU_C::PSADBW_PqQq(bxInstruction_c *i)
   BX_CPU_THIS_PTR prepareMMX();
 
   BxPackedMmxRegister op1 = BX_READ_MMX_REG(i->nnn()), op2;
-  Bit16u temp = 0;
 
   /* op2 is a register or memory reference */
   if (i->modC0()) {
@@ -1916,6 +2107,11 @@ void BX_CPU_C::PSADBW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sad_epu8, op1, op2);
+#else
+  Bit16u temp = 0;
+
   temp += abs(MMXUB0(op1) - MMXUB0(op2));
   temp += abs(MMXUB1(op1) - MMXUB1(op2));
   temp += abs(MMXUB2(op1) - MMXUB2(op2));
@@ -1925,7 +2121,8 @@ void BX_CPU_C::PSADBW_PqQq(bxInstruction_c *i)
   temp += abs(MMXUB6(op1) - MMXUB6(op2));
   temp += abs(MMXUB7(op1) - MMXUB7(op2));
 
-  MMXUW0(op1) = (Bit64u) temp;
+  MMXUQ(op1) = (Bit64u) temp;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2004,6 +2201,9 @@ void BX_CPU_C::PSUBB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sub_epi8, op1, op2);
+#else
   MMXUB0(op1) -= MMXUB0(op2);
   MMXUB1(op1) -= MMXUB1(op2);
   MMXUB2(op1) -= MMXUB2(op2);
@@ -2012,6 +2212,7 @@ void BX_CPU_C::PSUBB_PqQq(bxInstruction_c *i)
   MMXUB5(op1) -= MMXUB5(op2);
   MMXUB6(op1) -= MMXUB6(op2);
   MMXUB7(op1) -= MMXUB7(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2038,10 +2239,14 @@ void BX_CPU_C::PSUBW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sub_epi16, op1, op2);
+#else
   MMXUW0(op1) -= MMXUW0(op2);
   MMXUW1(op1) -= MMXUW1(op2);
   MMXUW2(op1) -= MMXUW2(op2);
   MMXUW3(op1) -= MMXUW3(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2068,8 +2273,12 @@ void BX_CPU_C::PSUBD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sub_epi32, op1, op2);
+#else
   MMXUD0(op1) -= MMXUD0(op2);
   MMXUD1(op1) -= MMXUD1(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2096,7 +2305,11 @@ void BX_CPU_C::PSUBQ_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_sub_epi64, op1, op2);
+#else
   MMXUQ(op1) -= MMXUQ(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2123,6 +2336,9 @@ void BX_CPU_C::PADDB_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_add_epi8, op1, op2);
+#else
   MMXUB0(op1) += MMXUB0(op2);
   MMXUB1(op1) += MMXUB1(op2);
   MMXUB2(op1) += MMXUB2(op2);
@@ -2131,6 +2347,7 @@ void BX_CPU_C::PADDB_PqQq(bxInstruction_c *i)
   MMXUB5(op1) += MMXUB5(op2);
   MMXUB6(op1) += MMXUB6(op2);
   MMXUB7(op1) += MMXUB7(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2157,10 +2374,14 @@ void BX_CPU_C::PADDW_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_add_epi16, op1, op2);
+#else
   MMXUW0(op1) += MMXUW0(op2);
   MMXUW1(op1) += MMXUW1(op2);
   MMXUW2(op1) += MMXUW2(op2);
   MMXUW3(op1) += MMXUW3(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2187,8 +2408,12 @@ void BX_CPU_C::PADDD_PqQq(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX(op1, _mm_add_epi32, op1, op2);
+#else
   MMXUD0(op1) += MMXUD0(op2);
   MMXUD1(op1) += MMXUD1(op2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->nnn(), op1);
@@ -2207,6 +2432,9 @@ void BX_CPU_C::PSRLW_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(op, _mm_srl_epi16, op, shift);
+#else
   if(shift > 15) MMXUQ(op) = 0;
   else
   {
@@ -2215,6 +2443,7 @@ void BX_CPU_C::PSRLW_PqIb(bxInstruction_c *i)
     MMXUW2(op) >>= shift;
     MMXUW3(op) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), op);
@@ -2233,8 +2462,11 @@ void BX_CPU_C::PSRAW_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm()), result;
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(result, _mm_sra_epi16, op, shift);
+#else
   if(shift == 0) {
-    BX_WRITE_MMX_REG(i->nnn(), op);
+    BX_WRITE_MMX_REG(i->rm(), op);
     return;
   }
 
@@ -2255,6 +2487,7 @@ void BX_CPU_C::PSRAW_PqIb(bxInstruction_c *i)
     if(MMXUW2(op) & 0x8000) MMXUW2(result) |= (0xffff << (16 - shift));
     if(MMXUW3(op) & 0x8000) MMXUW3(result) |= (0xffff << (16 - shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), result);
@@ -2273,6 +2506,9 @@ void BX_CPU_C::PSLLW_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(op, _mm_sll_epi16, op, shift);
+#else
   if(shift > 15) MMXUQ(op) = 0;
   else
   {
@@ -2281,6 +2517,7 @@ void BX_CPU_C::PSLLW_PqIb(bxInstruction_c *i)
     MMXUW2(op) <<= shift;
     MMXUW3(op) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), op);
@@ -2299,12 +2536,16 @@ void BX_CPU_C::PSRLD_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(op, _mm_srl_epi32, op, shift);
+#else
   if(shift > 31) MMXUQ(op) = 0;
   else
   {
     MMXUD0(op) >>= shift;
     MMXUD1(op) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), op);
@@ -2323,8 +2564,11 @@ void BX_CPU_C::PSRAD_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm()), result;
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(result, _mm_sra_epi32, op, shift);
+#else
   if(shift == 0) {
-    BX_WRITE_MMX_REG(i->nnn(), op);
+    BX_WRITE_MMX_REG(i->rm(), op);
     return;
   }
 
@@ -2342,6 +2586,7 @@ void BX_CPU_C::PSRAD_PqIb(bxInstruction_c *i)
     if(MMXUD1(op) & 0x80000000) 
        MMXUD1(result) |= (0xffffffff << (32 - shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), result);
@@ -2360,12 +2605,16 @@ void BX_CPU_C::PSLLD_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(op, _mm_sll_epi32, op, shift);
+#else
   if(shift > 31) MMXUQ(op) = 0;
   else
   {
     MMXUD0(op) <<= shift;
     MMXUD1(op) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), op);
@@ -2384,12 +2633,16 @@ void BX_CPU_C::PSRLQ_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(op, _mm_srl_epi64, op, shift);
+#else
   if(shift > 63) {
     MMXUQ(op) = 0;
   }
   else {
     MMXUQ(op) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), op);
@@ -2408,12 +2661,16 @@ void BX_CPU_C::PSLLQ_PqIb(bxInstruction_c *i)
   BxPackedMmxRegister op = BX_READ_MMX_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_MMX_SHIFT(op, _mm_sll_epi64, op, shift);
+#else
   if(shift > 63) {
     MMXUQ(op) = 0;
   }
   else {
     MMXUQ(op) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_MMX_REG(i->rm(), op);
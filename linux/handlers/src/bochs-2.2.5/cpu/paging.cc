@@ -384,43 +384,8 @@ static unsigned priv_check[BX_PRIV_CHECK_SIZE];
 #define PAGE_DIRECTORY_NX_BIT (BX_CONST64(0x8000000000000000))
 
 
-// === TLB Instrumentation section ==============================
-
-// Note: this is an approximation of what Peter Tattam had.
-
-#define InstrumentTLB 0
-
-#if InstrumentTLB
-static unsigned tlbLookups=0;
-static unsigned tlbMisses=0;
-static unsigned tlbGlobalFlushes=0;
-static unsigned tlbNonGlobalFlushes=0;
-static unsigned tlbEntryFlushes=0;
-static unsigned tlbEntryInvlpg=0;
-
-#define InstrTLB_StatsMask 0xfffff
-
-#define InstrTLB_Stats() {\
-  if ((tlbLookups & InstrTLB_StatsMask) == 0) { \
-    BX_INFO(("TLB lookup:%8d miss:%8d %6.2f%% flush:%8d %6.2f%%", \
-          tlbLookups, \
-          tlbMisses, \
-          tlbMisses * 100.0 / tlbLookups, \
-          (tlbGlobalFlushes+tlbNonGlobalFlushes), \
-          (tlbGlobalFlushes+tlbNonGlobalFlushes) * 100.0 / tlbLookups \
-          )); \
-    tlbLookups = tlbMisses = tlbGlobalFlushes = tlbNonGlobalFlushes = 0; \
-    } \
-  }
-#define InstrTLB_Increment(v) (v)++
-
-#else
-#define InstrTLB_Stats()
-#define InstrTLB_Increment(v)
-#endif
-
-// ==============================================================
-
+// TLB hits, misses and flushes are counted in the per CPU stats
+// (BX_STATS_INC, see cpu.h).
 
   void BX_CPP_AttrRegparmN(2)
 BX_CPU_C::pagingCR0Changed(Bit32u oldCR0, Bit32u newCR0)
@@ -536,14 +501,29 @@ BX_CPU_C::TLB_init(void)
   void
 BX_CPU_C::TLB_flush(bx_bool invalidateGlobal)
 {
-#if InstrumentTLB
-  if (invalidateGlobal)
-    InstrTLB_Increment(tlbGlobalFlushes);
-  else
-    InstrTLB_Increment(tlbNonGlobalFlushes);
+  BX_STATS_INC(tlb_flushes);
+
+#if BX_GDBSTUB
+  if (bx_gdbstub_nr_watchpoints)
+    bx_gdbstub_paging_changed();
 #endif
 
 #if BX_USE_TLB
+#if BX_USE_QUICK_TLB_INVALIDATE
+  // Entries are tagged with the generation in the low bits of lpf, so
+  // stepping the generation drops them all at once.  Global entries
+  // carry the old tag too; while CR4.PGE keeps them alive a non-global
+  // flush has to walk the table instead.
+#if BX_SUPPORT_GLOBAL_PAGES
+  if (invalidateGlobal || !BX_CPU_THIS_PTR cr4.get_PGE())
+#endif
+  {
+    if (--BX_CPU_THIS_PTR TLB.tlb_invalidate > 0) return;
+    // Generations used up, start over with a clean table.
+    BX_CPU_THIS_PTR TLB.tlb_invalidate = BX_MAX_TLB_INVALIDATE;
+    invalidateGlobal = 1;
+  }
+#endif
   for (unsigned i=0; i<BX_TLB_SIZE; i++) {
     // To be conscious of the native cache line usage, only
     // write to (invalidate) entries which need it.
@@ -554,7 +534,6 @@ BX_CPU_C::TLB_flush(bx_bool invalidateGlobal)
 #endif
       {
         tlbEntry->lpf = BX_INVALID_TLB_ENTRY;
-        InstrTLB_Increment(tlbEntryFlushes); // A TLB entry flush occurred.
       }
     }
   }
@@ -622,8 +601,12 @@ void BX_CPU_C::INVLPG(bxInstruction_c* i)
   laddr = BX_CPU_THIS_PTR get_segment_base(i->seg()) + RMAddr(i);
   Bit32u TLB_index = BX_TLB_INDEX_OF(laddr);
   BX_CPU_THIS_PTR TLB.entry[TLB_index].lpf = BX_INVALID_TLB_ENTRY;
-  InstrTLB_Increment(tlbEntryInvlpg);
+  BX_STATS_INC(tlb_invlpg);
 #endif // BX_USE_TLB
+#if BX_GDBSTUB
+  if (bx_gdbstub_nr_watchpoints)
+    bx_gdbstub_paging_changed();
+#endif
 
   BX_INSTR_TLB_CNTRL(BX_CPU_ID, BX_INSTR_INVLPG, 0);
 
@@ -647,9 +630,6 @@ BX_CPU_C::translate_linear(bx_address laddr, unsigned pl, unsigned rw, unsigned
   Bit32u TLB_index;
 #endif
 
-  InstrTLB_Increment(tlbLookups);
-  InstrTLB_Stats();
-
   // note - we assume physical memory < 4gig so for brevity & speed, we'll use
   // 32 bit entries although cr3 is expanded to 64 bits.
   Bit32u ppf, poffset, paddress;
@@ -675,8 +655,10 @@ BX_CPU_C::translate_linear(bx_address laddr, unsigned pl, unsigned rw, unsigned
       paddress   = tlbEntry->ppf | poffset;
       accessBits = tlbEntry->accessBits;
 
-      if (accessBits & (0x10 << ((isWrite<<1) | pl)))
+      if (accessBits & (0x10 << ((isWrite<<1) | pl))) {
+        BX_STATS_INC(tlb_hits);
         return(paddress);
+      }
 
       // The current access does not have permission according to the info
       // in our TLB cache entry.  Re-walk the page tables, in case there is
@@ -685,7 +667,7 @@ BX_CPU_C::translate_linear(bx_address laddr, unsigned pl, unsigned rw, unsigned
     }
 #endif
 
-    InstrTLB_Increment(tlbMisses);
+    BX_STATS_INC(tlb_misses);
 
 #if BX_SUPPORT_X86_64
     if (BX_CPU_THIS_PTR msr.lma)
@@ -870,8 +852,10 @@ BX_CPU_C::translate_linear(bx_address laddr, unsigned pl, unsigned rw, unsigned
       paddress   = tlbEntry->ppf | poffset;
       accessBits = tlbEntry->accessBits;
 
-      if (accessBits & (0x10 << ((isWrite<<1) | pl)))
+      if (accessBits & (0x10 << ((isWrite<<1) | pl))) {
+        BX_STATS_INC(tlb_hits);
         return(paddress);
+      }
 
       // The current access does not have permission according to the info
       // in our TLB cache entry.  Re-walk the page tables, in case there is
@@ -880,7 +864,7 @@ BX_CPU_C::translate_linear(bx_address laddr, unsigned pl, unsigned rw, unsigned
     }
 #endif
 
-    InstrTLB_Increment(tlbMisses);
+    BX_STATS_INC(tlb_misses);
 
     Bit32u pde, pde_addr;
 
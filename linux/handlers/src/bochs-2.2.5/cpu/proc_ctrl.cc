@@ -47,6 +47,12 @@ void BX_CPU_C::UndefinedOpcode(bxInstruction_c *i)
 void BX_CPU_C::NOP(bxInstruction_c *i)
 {
   // No operation.
+#if BX_SMP_PROCESSORS > 1
+  // F3 90 is PAUSE, found in spin-wait loops: let the other
+  // processors run.
+  if (i->repUsedValue() == 3)
+    BX_CPU_THIS_PTR spin_wait = 1;
+#endif
 }
 
 void BX_CPU_C::PREFETCH(bxInstruction_c *i)
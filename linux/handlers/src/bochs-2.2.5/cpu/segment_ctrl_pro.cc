@@ -98,6 +98,7 @@ BX_CPU_C::load_seg_reg(bx_segment_reg_t *seg, Bit16u new_value)
       BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].selector    = ss_selector;
       BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].cache       = descriptor;
       BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].cache.valid = 1;
+      set_seg_access_ok(&BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS]);
 
       /* now set accessed bit in descriptor */
       dword2 |= 0x0100;
@@ -173,6 +174,7 @@ BX_CPU_C::load_seg_reg(bx_segment_reg_t *seg, Bit16u new_value)
       seg->selector    = selector;
       seg->cache       = descriptor;
       seg->cache.valid = 1;
+      set_seg_access_ok(seg);
 
       /* now set accessed bit in descriptor                   */
       /* wmr: don't bother if it's already set (thus allowing */ 
@@ -218,6 +220,7 @@ BX_CPU_C::load_seg_reg(bx_segment_reg_t *seg, Bit16u new_value)
   seg->cache.u.segment.base = new_value << 4;
   seg->cache.segment = 1; /* regular segment */
   seg->cache.p = 1; /* present */
+  set_seg_access_ok(seg);
 
   if (seg == &BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS]) {
     seg->cache.u.segment.executable = 1; /* code segment */
@@ -471,6 +474,43 @@ BX_CPU_C::load_ss(bx_selector_t *selector, bx_descriptor_t *descriptor, Bit8u cp
   if ( !BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].cache.valid ) {
     BX_PANIC(("load_ss(): invalid selector/descriptor passed."));
   }
+
+  set_seg_access_ok(&BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS]);
+}
+
+// read_virtual_checks() and write_virtual_checks() mark a segment with
+// SegAccessROK/WOK on the first access, after which the accessors only
+// compare the offset against the limit.  Loading the segment register
+// clears the bits again, and Linux reloads DS, ES, FS and SS on every
+// system call and interrupt, so set them right away for the segments
+// the checks would accept.
+  void BX_CPP_AttrRegparmN(1)
+BX_CPU_C::set_seg_access_ok(bx_segment_reg_t *seg)
+{
+#if BX_SUPPORT_X86_64
+  if (BX_CPU_THIS_PTR cpu_mode == BX_MODE_LONG_64) return;
+#endif
+  // Limit should accomodate at least a dword, see write_virtual_checks()
+  if (seg->cache.u.segment.limit_scaled < 7) return;
+
+  if (! protected_mode()) {
+    seg->cache.valid |= SegAccessROK | SegAccessWOK;
+    return;
+  }
+
+  if (seg->cache.valid==0 || seg->cache.p==0 || seg->cache.segment==0)
+    return;
+
+  switch (seg->cache.type) {
+    case 2: case 3: /* read/write */
+      seg->cache.valid |= SegAccessROK | SegAccessWOK;
+      break;
+    case 0: case 1: /* read only */
+    case 10: case 11: /* execute/read */
+    case 14: case 15: /* execute/read-only, conforming */
+      seg->cache.valid |= SegAccessROK;
+      break;
+  }
 }
 
 #if BX_CPU_LEVEL >= 2
@@ -478,6 +518,10 @@ BX_CPU_C::load_ss(bx_selector_t *selector, bx_descriptor_t *descriptor, Bit8u cp
 BX_CPU_C::fetch_raw_descriptor(bx_selector_t *selector,
                         Bit32u *dword1, Bit32u *dword2, unsigned exception_no)
 {
+  Bit64u raw_descriptor;
+
+  // Read the descriptor as one quadword instead of two dwords; this
+  // is one address translation less on every selector load.
   if (selector->ti == 0) { /* GDT */
     if ((selector->index*8 + 7) > BX_CPU_THIS_PTR gdtr.limit) {
       BX_ERROR(("fetch_raw_descriptor: GDT: index (%x)%x > limit (%x)",
@@ -485,10 +529,8 @@ BX_CPU_C::fetch_raw_descriptor(bx_selector_t *selector,
           BX_CPU_THIS_PTR gdtr.limit));
       exception(exception_no, selector->value & 0xfffc, 0);
     }
-    access_linear(BX_CPU_THIS_PTR gdtr.base + selector->index*8,     4, 0,
-      BX_READ, dword1);
-    access_linear(BX_CPU_THIS_PTR gdtr.base + selector->index*8 + 4, 4, 0,
-      BX_READ, dword2);
+    access_linear(BX_CPU_THIS_PTR gdtr.base + selector->index*8, 8, 0,
+      BX_READ, &raw_descriptor);
   }
   else { /* LDT */
     if (BX_CPU_THIS_PTR ldtr.cache.valid==0) {
@@ -501,23 +543,25 @@ BX_CPU_C::fetch_raw_descriptor(bx_selector_t *selector,
           BX_CPU_THIS_PTR ldtr.cache.u.ldt.limit));
       exception(exception_no, selector->value & 0xfffc, 0);
     }
-    access_linear(BX_CPU_THIS_PTR ldtr.cache.u.ldt.base + selector->index*8,     4, 0,
-      BX_READ, dword1);
-    access_linear(BX_CPU_THIS_PTR ldtr.cache.u.ldt.base + selector->index*8 + 4, 4, 0,
-      BX_READ, dword2);
+    access_linear(BX_CPU_THIS_PTR ldtr.cache.u.ldt.base + selector->index*8, 8, 0,
+      BX_READ, &raw_descriptor);
   }
+  *dword1 = (Bit32u) raw_descriptor;
+  *dword2 = (Bit32u) (raw_descriptor >> 32);
 }
 
   bx_bool BX_CPP_AttrRegparmN(3)
 BX_CPU_C::fetch_raw_descriptor2(bx_selector_t *selector, Bit32u *dword1, Bit32u *dword2)
 {
+  Bit64u raw_descriptor;
+
   if (selector->ti == 0) { /* GDT */
     if ((selector->index*8 + 7) > BX_CPU_THIS_PTR gdtr.limit)
       return(0);
-    access_linear(BX_CPU_THIS_PTR gdtr.base + selector->index*8,     4, 0,
-      BX_READ, dword1);
-    access_linear(BX_CPU_THIS_PTR gdtr.base + selector->index*8 + 4, 4, 0,
-      BX_READ, dword2);
+    access_linear(BX_CPU_THIS_PTR gdtr.base + selector->index*8, 8, 0,
+      BX_READ, &raw_descriptor);
+    *dword1 = (Bit32u) raw_descriptor;
+    *dword2 = (Bit32u) (raw_descriptor >> 32);
     return(1);
   }
   else { /* LDT */
@@ -527,10 +571,10 @@ BX_CPU_C::fetch_raw_descriptor2(bx_selector_t *selector, Bit32u *dword1, Bit32u
     }
     if ((selector->index*8 + 7) > BX_CPU_THIS_PTR ldtr.cache.u.ldt.limit)
       return(0);
-    access_linear(BX_CPU_THIS_PTR ldtr.cache.u.ldt.base + selector->index*8,     4, 0,
-      BX_READ, dword1);
-    access_linear(BX_CPU_THIS_PTR ldtr.cache.u.ldt.base + selector->index*8 + 4, 4, 0,
-      BX_READ, dword2);
+    access_linear(BX_CPU_THIS_PTR ldtr.cache.u.ldt.base + selector->index*8, 8, 0,
+      BX_READ, &raw_descriptor);
+    *dword1 = (Bit32u) raw_descriptor;
+    *dword2 = (Bit32u) (raw_descriptor >> 32);
     return(1);
   }
 }
@@ -0,0 +1,276 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+
+#define NEED_CPU_REG_SHORTCUTS 1
+#include "bochs.h"
+#define LOG_THIS BX_CPU_THIS_PTR
+
+#if BX_SUPPORT_CPU_BENCH && BX_SUPPORT_MMX && (BX_SUPPORT_SSE >= 2)
+
+/* ***************************************************************** */
+/* Packed integer MMX/SSE2 benchmark                                 */
+/* ***************************************************************** */
+
+// Run by bx_init_hardware() when BXSIMDBENCH is set in the environment.
+// Every instruction below is decoded in its MMX (0F xx) and its SSE2
+// (66 0F xx) register form and then:
+//
+// - executed on BX_SIMD_BENCH_TRIALS random operands, hashing each
+//   result.  The hashes depend only on the emulated semantics, so a
+//   build with the host SSE2 code (BX_HostAsm_SIMD) and one without
+//   must print the same ones.
+// - timed over BX_SIMD_BENCH_ITERATIONS calls of its execute method,
+//   best of BX_SIMD_BENCH_RUNS.  Destinations are mm0-mm3/xmm0-xmm3 and
+//   sources mm4-mm7/xmm4-xmm7, so the inputs stay the same while the
+//   results keep changing.
+//
+// The times are printed per instruction and averaged per class.
+
+#define BX_SIMD_BENCH_TRIALS     1000
+#define BX_SIMD_BENCH_ITERATIONS 1000000
+#define BX_SIMD_BENCH_RUNS       3
+
+#define BX_SIMD_BENCH_COUNT 0x01 // source operand is a shift count
+#define BX_SIMD_BENCH_IMM   0x02 // shift by Ib, register in rm
+#define BX_SIMD_BENCH_GPR   0x04 // result in a general register
+
+typedef struct {
+  const char *cls;
+  const char *name;
+  Bit8u opcode;   // the byte after 0F
+  Bit8u nnn;      // opcode extension of shifts by Ib
+  unsigned flags;
+} bx_simd_bench_t;
+
+static const bx_simd_bench_t bx_simd_bench[] = {
+  { "add/sub",      "PADDB",     0xfc, 0, 0 },
+  { "add/sub",      "PADDW",     0xfd, 0, 0 },
+  { "add/sub",      "PADDD",     0xfe, 0, 0 },
+  { "add/sub",      "PADDQ",     0xd4, 0, 0 },
+  { "add/sub",      "PSUBB",     0xf8, 0, 0 },
+  { "add/sub",      "PSUBW",     0xf9, 0, 0 },
+  { "add/sub",      "PSUBD",     0xfa, 0, 0 },
+  { "add/sub",      "PSUBQ",     0xfb, 0, 0 },
+  { "saturating",   "PADDSB",    0xec, 0, 0 },
+  { "saturating",   "PADDSW",    0xed, 0, 0 },
+  { "saturating",   "PADDUSB",   0xdc, 0, 0 },
+  { "saturating",   "PADDUSW",   0xdd, 0, 0 },
+  { "saturating",   "PSUBSB",    0xe8, 0, 0 },
+  { "saturating",   "PSUBSW",    0xe9, 0, 0 },
+  { "saturating",   "PSUBUSB",   0xd8, 0, 0 },
+  { "saturating",   "PSUBUSW",   0xd9, 0, 0 },
+  { "compare",      "PCMPEQB",   0x74, 0, 0 },
+  { "compare",      "PCMPEQW",   0x75, 0, 0 },
+  { "compare",      "PCMPEQD",   0x76, 0, 0 },
+  { "compare",      "PCMPGTB",   0x64, 0, 0 },
+  { "compare",      "PCMPGTW",   0x65, 0, 0 },
+  { "compare",      "PCMPGTD",   0x66, 0, 0 },
+  { "logical",      "PAND",      0xdb, 0, 0 },
+  { "logical",      "PANDN",     0xdf, 0, 0 },
+  { "logical",      "POR",       0xeb, 0, 0 },
+  { "logical",      "PXOR",      0xef, 0, 0 },
+  { "min/max/avg",  "PMINUB",    0xda, 0, 0 },
+  { "min/max/avg",  "PMAXUB",    0xde, 0, 0 },
+  { "min/max/avg",  "PMINSW",    0xea, 0, 0 },
+  { "min/max/avg",  "PMAXSW",    0xee, 0, 0 },
+  { "min/max/avg",  "PAVGB",     0xe0, 0, 0 },
+  { "min/max/avg",  "PAVGW",     0xe3, 0, 0 },
+  { "multiply",     "PMULLW",    0xd5, 0, 0 },
+  { "multiply",     "PMULHW",    0xe5, 0, 0 },
+  { "multiply",     "PMULHUW",   0xe4, 0, 0 },
+  { "multiply",     "PMULUDQ",   0xf4, 0, 0 },
+  { "multiply",     "PMADDWD",   0xf5, 0, 0 },
+  { "multiply",     "PSADBW",    0xf6, 0, 0 },
+  { "pack/unpack",  "PACKSSWB",  0x63, 0, 0 },
+  { "pack/unpack",  "PACKSSDW",  0x6b, 0, 0 },
+  { "pack/unpack",  "PACKUSWB",  0x67, 0, 0 },
+  { "pack/unpack",  "PUNPCKLBW", 0x60, 0, 0 },
+  { "pack/unpack",  "PUNPCKLWD", 0x61, 0, 0 },
+  { "pack/unpack",  "PUNPCKLDQ", 0x62, 0, 0 },
+  { "pack/unpack",  "PUNPCKHBW", 0x68, 0, 0 },
+  { "pack/unpack",  "PUNPCKHWD", 0x69, 0, 0 },
+  { "pack/unpack",  "PUNPCKHDQ", 0x6a, 0, 0 },
+  { "shift",        "PSRLW",     0xd1, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSRLD",     0xd2, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSRLQ",     0xd3, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSRAW",     0xe1, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSRAD",     0xe2, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSLLW",     0xf1, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSLLD",     0xf2, 0, BX_SIMD_BENCH_COUNT },
+  { "shift",        "PSLLQ",     0xf3, 0, BX_SIMD_BENCH_COUNT },
+  { "shift Ib",     "PSRLW",     0x71, 2, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSRAW",     0x71, 4, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSLLW",     0x71, 6, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSRLD",     0x72, 2, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSRAD",     0x72, 4, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSLLD",     0x72, 6, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSRLQ",     0x73, 2, BX_SIMD_BENCH_IMM },
+  { "shift Ib",     "PSLLQ",     0x73, 6, BX_SIMD_BENCH_IMM },
+  { "movmsk",       "PMOVMSKB",  0xd7, 0, BX_SIMD_BENCH_GPR },
+  { NULL, NULL, 0, 0, 0 }
+};
+
+// the same sequence in every build, so that the hashes can be compared
+static Bit32u bx_simd_bench_seed;
+
+static Bit32u bx_simd_bench_rand(void)
+{
+  bx_simd_bench_seed = bx_simd_bench_seed * 1103515245 + 12345;
+  return bx_simd_bench_seed >> 8;
+}
+
+static Bit64u bx_simd_bench_rand64(void)
+{
+  Bit64u r = bx_simd_bench_rand();
+  r = (r << 24) ^ bx_simd_bench_rand();
+  return (r << 24) ^ bx_simd_bench_rand();
+}
+
+// FNV-1a
+static Bit32u bx_simd_bench_hash(Bit32u hash, const void *data, unsigned len)
+{
+  const Bit8u *p = (const Bit8u *) data;
+  while (len--)
+    hash = (hash ^ *p++) * 16777619;
+  return hash;
+}
+
+  void
+BX_CPU_C::simdBench(void)
+{
+  bxInstruction_c insn[8];
+  Bit8u code[16];
+  unsigned len, n, k;
+  volatile unsigned e, sse;
+  double class_ns[2] = { 0, 0 };
+  unsigned class_insns = 0;
+
+  // MMX and SSE instructions are allowed in real mode
+  BX_CPU_THIS_PTR cr0.ts = 0;
+  BX_CPU_THIS_PTR cr0.em = 0;
+  BX_CPU_THIS_PTR cr4.set_OSFXSR(1);
+
+  fprintf(stderr, "simd bench: %-12s %-10s %10s %10s %9s %9s\n",
+    "class", "insn", "mmx hash", "sse2 hash", "mmx ns", "sse2 ns");
+
+  for (e=0; bx_simd_bench[e].name != NULL; e++) {
+    const bx_simd_bench_t *b = &bx_simd_bench[e];
+    Bit32u hash[2] = { 0, 0 };
+    double ns[2] = { 0, 0 };
+    bx_bool ok[2] = { 0, 0 };
+
+    for (sse=0; sse<2; sse++) {
+      if (BX_SETJMP(BX_CPU_THIS_PTR jmp_buf_env)) {
+        // the instruction raised an exception, not in this configuration
+        BX_CPU_THIS_PTR errorno = 0;
+        continue;
+      }
+      bx_simd_bench_seed = b->opcode * 256 + b->nnn;
+      Bit32u h = 2166136261u;
+
+      for (unsigned trial=0; trial <= BX_SIMD_BENCH_TRIALS; trial++) {
+        // the last round sets up the registers for the timed loop
+        bx_bool timed = (trial == BX_SIMD_BENCH_TRIALS);
+        for (n=0; n<8; n++) {
+          BxPackedMmxRegister mmx;
+          MMXUQ(mmx) = bx_simd_bench_rand64();
+          BX_CPU_THIS_PTR xmm[n].xmm64u(0) = bx_simd_bench_rand64();
+          BX_CPU_THIS_PTR xmm[n].xmm64u(1) = bx_simd_bench_rand64();
+          BX_WRITE_MMX_REG(n, mmx);
+        }
+
+        // timed: dst mm0-mm3 and src mm4-mm7, trials: anything
+        for (k=0; k<(timed ? 8U : 1U); k++) {
+          unsigned dst = timed ? (k & 3) : (bx_simd_bench_rand() & 7);
+          unsigned src = timed ? 4 + (k & 3) : (bx_simd_bench_rand() & 7);
+          len = 0;
+          if (sse) code[len++] = 0x66;
+          code[len++] = 0x0f;
+          code[len++] = b->opcode;
+          if (b->flags & BX_SIMD_BENCH_IMM) {
+            code[len++] = 0xc0 | (b->nnn << 3) | dst;
+            code[len++] = timed ? (k * 5) : (bx_simd_bench_rand() % 80);
+          }
+          else
+            code[len++] = 0xc0 | (dst << 3) | src;
+          if (! fetchDecode(code, &insn[k], len))
+            BX_PANIC(("simd bench: can't decode %s", b->name));
+          if (b->flags & BX_SIMD_BENCH_COUNT) {
+            // mostly counts below the lane size, some beyond it
+            BxPackedMmxRegister count;
+            MMXUQ(count) = bx_simd_bench_rand() % 80;
+            BX_WRITE_MMX_REG(src, count);
+            BX_CPU_THIS_PTR xmm[src].xmm64u(0) = MMXUQ(count);
+          }
+        }
+        if (timed) break;
+
+        BX_CPU_CALL_METHOD(insn[0].execute, (&insn[0]));
+        if (b->flags & BX_SIMD_BENCH_GPR) {
+          Bit32u val = BX_READ_32BIT_REG(insn[0].nnn());
+          h = bx_simd_bench_hash(h, &val, 4);
+        }
+        else {
+          unsigned reg = (b->flags & BX_SIMD_BENCH_IMM) ? insn[0].rm() : insn[0].nnn();
+          if (sse)
+            h = bx_simd_bench_hash(h, &BX_CPU_THIS_PTR xmm[reg], 16);
+          else {
+            Bit64u val = MMXUQ(BX_READ_MMX_REG(reg));
+            h = bx_simd_bench_hash(h, &val, 8);
+          }
+        }
+      }
+
+      double best = 0;
+      for (unsigned run=0; run<BX_SIMD_BENCH_RUNS; run++) {
+        Bit64u t0 = bx_get_realtime64_usec();
+        for (n=0; n<BX_SIMD_BENCH_ITERATIONS; n++) {
+          bxInstruction_c *i = &insn[n & 7];
+          BX_CPU_CALL_METHOD(i->execute, (i));
+        }
+        double t = (bx_get_realtime64_usec() - t0) * 1000.0 / BX_SIMD_BENCH_ITERATIONS;
+        if (run == 0 || t < best) best = t;
+      }
+
+      hash[sse] = h;
+      ns[sse] = best;
+      ok[sse] = 1;
+    }
+
+    if (ok[0] && ok[1]) {
+      fprintf(stderr, "simd bench: %-12s %-10s %10x %10x %9.2f %9.2f\n",
+        b->cls, b->name, hash[0], hash[1], ns[0], ns[1]);
+      class_ns[0] += ns[0];
+      class_ns[1] += ns[1];
+      class_insns++;
+    }
+    else
+      fprintf(stderr, "simd bench: %-12s %-10s not supported\n", b->cls, b->name);
+
+    const bx_simd_bench_t *next = &bx_simd_bench[e+1];
+    if (class_insns && (next->name == NULL || strcmp(next->cls, b->cls))) {
+      fprintf(stderr, "simd bench: %-12s %-10s %10s %10s %9.2f %9.2f\n",
+        b->cls, "average", "", "", class_ns[0] / class_insns, class_ns[1] / class_insns);
+      class_ns[0] = class_ns[1] = 0;
+      class_insns = 0;
+    }
+  }
+}
+
+#endif // BX_SUPPORT_CPU_BENCH && BX_SUPPORT_MMX && (BX_SUPPORT_SSE >= 2)
@@ -45,6 +45,9 @@ void BX_CPU_C::PACKSSWB_VdqWq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_packs_epi16, op1, op2);
+#else
   result.xmmsbyte(0x0) = SaturateWordSToByteS(op1.xmm16s(0));
   result.xmmsbyte(0x1) = SaturateWordSToByteS(op1.xmm16s(1));
   result.xmmsbyte(0x2) = SaturateWordSToByteS(op1.xmm16s(2));
@@ -62,6 +65,7 @@ void BX_CPU_C::PACKSSWB_VdqWq(bxInstruction_c *i)
   result.xmmsbyte(0xD) = SaturateWordSToByteS(op2.xmm16s(5));
   result.xmmsbyte(0xE) = SaturateWordSToByteS(op2.xmm16s(6));
   result.xmmsbyte(0xF) = SaturateWordSToByteS(op2.xmm16s(7));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -88,9 +92,13 @@ void BX_CPU_C::PCMPGTB_VdqWq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_cmpgt_epi8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     op1.xmmsbyte(j) = (op1.xmmsbyte(j) > op2.xmmsbyte(j)) ? 0xff : 0;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -117,6 +125,9 @@ void BX_CPU_C::PCMPGTW_VdqWq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_cmpgt_epi16, op1, op2);
+#else
   op1.xmm16s(0) = (op1.xmm16s(0) > op2.xmm16s(0)) ? 0xffff : 0;
   op1.xmm16s(1) = (op1.xmm16s(1) > op2.xmm16s(1)) ? 0xffff : 0;
   op1.xmm16s(2) = (op1.xmm16s(2) > op2.xmm16s(2)) ? 0xffff : 0;
@@ -125,6 +136,7 @@ void BX_CPU_C::PCMPGTW_VdqWq(bxInstruction_c *i)
   op1.xmm16s(5) = (op1.xmm16s(5) > op2.xmm16s(5)) ? 0xffff : 0;
   op1.xmm16s(6) = (op1.xmm16s(6) > op2.xmm16s(6)) ? 0xffff : 0;
   op1.xmm16s(7) = (op1.xmm16s(7) > op2.xmm16s(7)) ? 0xffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -151,10 +163,14 @@ void BX_CPU_C::PCMPGTD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_cmpgt_epi32, op1, op2);
+#else
   op1.xmm32s(0) = (op1.xmm32s(0) > op2.xmm32s(0)) ? 0xffffffff : 0;
   op1.xmm32s(1) = (op1.xmm32s(1) > op2.xmm32s(1)) ? 0xffffffff : 0;
   op1.xmm32s(2) = (op1.xmm32s(2) > op2.xmm32s(2)) ? 0xffffffff : 0;
   op1.xmm32s(3) = (op1.xmm32s(3) > op2.xmm32s(3)) ? 0xffffffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -181,6 +197,9 @@ void BX_CPU_C::PACKUSWB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_packus_epi16, op1, op2);
+#else
   result.xmmubyte(0x0) = SaturateWordSToByteU(op1.xmm16s(0));
   result.xmmubyte(0x1) = SaturateWordSToByteU(op1.xmm16s(1));
   result.xmmubyte(0x2) = SaturateWordSToByteU(op1.xmm16s(2));
@@ -198,6 +217,7 @@ void BX_CPU_C::PACKUSWB_VdqWdq(bxInstruction_c *i)
   result.xmmubyte(0xD) = SaturateWordSToByteU(op2.xmm16s(5));
   result.xmmubyte(0xE) = SaturateWordSToByteU(op2.xmm16s(6));
   result.xmmubyte(0xF) = SaturateWordSToByteU(op2.xmm16s(7));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -224,6 +244,9 @@ void BX_CPU_C::PACKSSDW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_packs_epi32, op1, op2);
+#else
   result.xmm16s(0) = SaturateDwordSToWordS(op1.xmm32s(0));
   result.xmm16s(1) = SaturateDwordSToWordS(op1.xmm32s(1));
   result.xmm16s(2) = SaturateDwordSToWordS(op1.xmm32s(2));
@@ -233,6 +256,7 @@ void BX_CPU_C::PACKSSDW_VdqWdq(bxInstruction_c *i)
   result.xmm16s(5) = SaturateDwordSToWordS(op2.xmm32s(1));
   result.xmm16s(6) = SaturateDwordSToWordS(op2.xmm32s(2));
   result.xmm16s(7) = SaturateDwordSToWordS(op2.xmm32s(3));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -259,9 +283,13 @@ void BX_CPU_C::PCMPEQB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_cmpeq_epi8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     op1.xmmubyte(j) = (op1.xmmubyte(j) == op2.xmmubyte(j)) ? 0xff : 0;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -288,6 +316,9 @@ void BX_CPU_C::PCMPEQW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_cmpeq_epi16, op1, op2);
+#else
   op1.xmm16u(0) = (op1.xmm16u(0) == op2.xmm16u(0)) ? 0xffff : 0;
   op1.xmm16u(1) = (op1.xmm16u(1) == op2.xmm16u(1)) ? 0xffff : 0;
   op1.xmm16u(2) = (op1.xmm16u(2) == op2.xmm16u(2)) ? 0xffff : 0;
@@ -296,6 +327,7 @@ void BX_CPU_C::PCMPEQW_VdqWdq(bxInstruction_c *i)
   op1.xmm16u(5) = (op1.xmm16u(5) == op2.xmm16u(5)) ? 0xffff : 0;
   op1.xmm16u(6) = (op1.xmm16u(6) == op2.xmm16u(6)) ? 0xffff : 0;
   op1.xmm16u(7) = (op1.xmm16u(7) == op2.xmm16u(7)) ? 0xffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -322,10 +354,14 @@ void BX_CPU_C::PCMPEQD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_cmpeq_epi32, op1, op2);
+#else
   op1.xmm32u(0) = (op1.xmm32u(0) == op2.xmm32u(0)) ? 0xffffffff : 0;
   op1.xmm32u(1) = (op1.xmm32u(1) == op2.xmm32u(1)) ? 0xffffffff : 0;
   op1.xmm32u(2) = (op1.xmm32u(2) == op2.xmm32u(2)) ? 0xffffffff : 0;
   op1.xmm32u(3) = (op1.xmm32u(3) == op2.xmm32u(3)) ? 0xffffffff : 0;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -398,6 +434,9 @@ void BX_CPU_C::PSRLW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_srl_epi16, op1, op2);
+#else
   if(op2.xmm64u(0) > 15)  /* looking only to low 64 bits */
   {
     op1.xmm64u(0) = 0;
@@ -416,6 +455,7 @@ void BX_CPU_C::PSRLW_VdqWdq(bxInstruction_c *i)
     op1.xmm16u(6) >>= shift;
     op1.xmm16u(7) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -442,6 +482,9 @@ void BX_CPU_C::PSRLD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_srl_epi32, op1, op2);
+#else
   if(op2.xmm64u(0) > 31)  /* looking only to low 64 bits */
   {
     op1.xmm64u(0) = 0;
@@ -456,6 +499,7 @@ void BX_CPU_C::PSRLD_VdqWdq(bxInstruction_c *i)
     op1.xmm32u(2) >>= shift;
     op1.xmm32u(3) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -482,6 +526,9 @@ void BX_CPU_C::PSRLQ_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_srl_epi64, op1, op2);
+#else
   if(op2.xmm64u(0) > 63)  /* looking only to low 64 bits */
   {
     op1.xmm64u(0) = 0;
@@ -494,6 +541,7 @@ void BX_CPU_C::PSRLQ_VdqWdq(bxInstruction_c *i)
     op1.xmm64u(0) >>= shift;
     op1.xmm64u(1) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -520,8 +568,12 @@ void BX_CPU_C::PADDQ_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_add_epi64, op1, op2);
+#else
   op1.xmm64u(0) += op2.xmm64u(0);
   op1.xmm64u(1) += op2.xmm64u(1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -548,6 +600,9 @@ void BX_CPU_C::PMULLW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_mullo_epi16, op1, op2);
+#else
   Bit32u product1 = Bit32u(op1.xmm16u(0)) * Bit32u(op2.xmm16u(0));
   Bit32u product2 = Bit32u(op1.xmm16u(1)) * Bit32u(op2.xmm16u(1));
   Bit32u product3 = Bit32u(op1.xmm16u(2)) * Bit32u(op2.xmm16u(2));
@@ -565,6 +620,7 @@ void BX_CPU_C::PMULLW_VdqWdq(bxInstruction_c *i)
   result.xmm16u(5) = product6 & 0xffff;
   result.xmm16u(6) = product7 & 0xffff;
   result.xmm16u(7) = product8 & 0xffff;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -583,6 +639,9 @@ void BX_CPU_C::PMOVMSKB_GdVRdq(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit32u result = 0;
 
+#if defined(BX_HostAsm_SIMD)
+  result = _mm_movemask_epi8(BX_HOSTSIMD_LOAD128(op));
+#else
   if(op.xmmubyte(0x0) & 0x80) result |= 0x0001; 
   if(op.xmmubyte(0x1) & 0x80) result |= 0x0002; 
   if(op.xmmubyte(0x2) & 0x80) result |= 0x0004; 
@@ -599,6 +658,7 @@ void BX_CPU_C::PMOVMSKB_GdVRdq(bxInstruction_c *i)
   if(op.xmmubyte(0xD) & 0x80) result |= 0x2000; 
   if(op.xmmubyte(0xE) & 0x80) result |= 0x4000; 
   if(op.xmmubyte(0xF) & 0x80) result |= 0x8000; 
+#endif
 
   /* now write result back to destination */
   BX_WRITE_32BIT_REGZ(i->nnn(), result);
@@ -626,6 +686,9 @@ void BX_CPU_C::PSUBUSB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_subs_epu8, op1, op2);
+#else
   result.xmm64u(0) = result.xmm64u(1) = 0;
 
   for(unsigned j=0; j<16; j++) 
@@ -635,6 +698,7 @@ void BX_CPU_C::PSUBUSB_VdqWdq(bxInstruction_c *i)
           result.xmmubyte(j) = op1.xmmubyte(j) - op2.xmmubyte(j);
       }
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -661,6 +725,9 @@ void BX_CPU_C::PSUBUSW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_subs_epu16, op1, op2);
+#else
   result.xmm64u(0) = result.xmm64u(1) = 0;
 
   for(unsigned j=0; j<8; j++) 
@@ -670,6 +737,7 @@ void BX_CPU_C::PSUBUSW_VdqWdq(bxInstruction_c *i)
            result.xmm16u(j) = op1.xmm16u(j) - op2.xmm16u(j);
       }
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -696,9 +764,13 @@ void BX_CPU_C::PMINUB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_min_epu8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     if(op2.xmmubyte(j) < op1.xmmubyte(j)) op1.xmmubyte(j) = op2.xmmubyte(j);
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -728,8 +800,12 @@ void BX_CPU_C::PAND_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_and_si128, op1, op2);
+#else
   op1.xmm64u(0) &= op2.xmm64u(0);
   op1.xmm64u(1) &= op2.xmm64u(1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -756,9 +832,13 @@ void BX_CPU_C::PADDUSB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_adds_epu8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     result.xmmubyte(j) = SaturateWordSToByteU(Bit16s(op1.xmmubyte(j)) + Bit16s(op2.xmmubyte(j)));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -785,6 +865,9 @@ void BX_CPU_C::PADDUSW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_adds_epu16, op1, op2);
+#else
   result.xmm16u(0) = SaturateDwordSToWordU(Bit32s(op1.xmm16u(0)) + Bit32s(op2.xmm16u(0)));
   result.xmm16u(1) = SaturateDwordSToWordU(Bit32s(op1.xmm16u(1)) + Bit32s(op2.xmm16u(1)));
   result.xmm16u(2) = SaturateDwordSToWordU(Bit32s(op1.xmm16u(2)) + Bit32s(op2.xmm16u(2)));
@@ -793,6 +876,7 @@ void BX_CPU_C::PADDUSW_VdqWdq(bxInstruction_c *i)
   result.xmm16u(5) = SaturateDwordSToWordU(Bit32s(op1.xmm16u(5)) + Bit32s(op2.xmm16u(5)));
   result.xmm16u(6) = SaturateDwordSToWordU(Bit32s(op1.xmm16u(6)) + Bit32s(op2.xmm16u(6)));
   result.xmm16u(7) = SaturateDwordSToWordU(Bit32s(op1.xmm16u(7)) + Bit32s(op2.xmm16u(7)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -819,9 +903,13 @@ void BX_CPU_C::PMAXUB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_max_epu8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     if(op2.xmmubyte(j) > op1.xmmubyte(j)) op1.xmmubyte(j) = op2.xmmubyte(j);
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -851,8 +939,12 @@ void BX_CPU_C::PANDN_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_andnot_si128, op1, op2);
+#else
   op1.xmm64u(0) = ~(op1.xmm64u(0)) & op2.xmm64u(0);
   op1.xmm64u(1) = ~(op1.xmm64u(1)) & op2.xmm64u(1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -879,9 +971,13 @@ void BX_CPU_C::PAVGB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_avg_epu8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     op1.xmmubyte(j) = (op1.xmmubyte(j) + op2.xmmubyte(j) + 1) >> 1;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -908,6 +1004,9 @@ void BX_CPU_C::PSRAW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_sra_epi16, op1, op2);
+#else
   if(op2.xmm64u(0) == 0)
   {
     BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -947,6 +1046,7 @@ void BX_CPU_C::PSRAW_VdqWdq(bxInstruction_c *i)
     if(op1.xmm16u(6) & 0x8000) result.xmm16u(6) |= (0xffff << (16 - shift));
     if(op1.xmm16u(7) & 0x8000) result.xmm16u(7) |= (0xffff << (16 - shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -973,6 +1073,9 @@ void BX_CPU_C::PSRAD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_sra_epi32, op1, op2);
+#else
   if(op2.xmm64u(0) == 0)
   {
     BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1000,6 +1103,7 @@ void BX_CPU_C::PSRAD_VdqWdq(bxInstruction_c *i)
     if(op1.xmm32u(2) & 0x80000000) result.xmm32u(2) |= (0xffffffff << (32-shift));
     if(op1.xmm32u(3) & 0x80000000) result.xmm32u(3) |= (0xffffffff << (32-shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1026,6 +1130,9 @@ void BX_CPU_C::PAVGW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_avg_epu16, op1, op2);
+#else
   op1.xmm16u(0) = (op1.xmm16u(0) + op2.xmm16u(0) + 1) >> 1;
   op1.xmm16u(1) = (op1.xmm16u(1) + op2.xmm16u(1) + 1) >> 1;
   op1.xmm16u(2) = (op1.xmm16u(2) + op2.xmm16u(2) + 1) >> 1;
@@ -1034,6 +1141,7 @@ void BX_CPU_C::PAVGW_VdqWdq(bxInstruction_c *i)
   op1.xmm16u(5) = (op1.xmm16u(5) + op2.xmm16u(5) + 1) >> 1;
   op1.xmm16u(6) = (op1.xmm16u(6) + op2.xmm16u(6) + 1) >> 1;
   op1.xmm16u(7) = (op1.xmm16u(7) + op2.xmm16u(7) + 1) >> 1;
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1060,6 +1168,9 @@ void BX_CPU_C::PMULHUW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_mulhi_epu16, op1, op2);
+#else
   Bit32u product1 = Bit32u(op1.xmm16u(0)) * Bit32u(op2.xmm16u(0));
   Bit32u product2 = Bit32u(op1.xmm16u(1)) * Bit32u(op2.xmm16u(1));
   Bit32u product3 = Bit32u(op1.xmm16u(2)) * Bit32u(op2.xmm16u(2));
@@ -1077,6 +1188,7 @@ void BX_CPU_C::PMULHUW_VdqWdq(bxInstruction_c *i)
   result.xmm16u(5) = (Bit16u)(product6 >> 16);
   result.xmm16u(6) = (Bit16u)(product7 >> 16);
   result.xmm16u(7) = (Bit16u)(product8 >> 16);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1103,6 +1215,9 @@ void BX_CPU_C::PMULHW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_mulhi_epi16, op1, op2);
+#else
   Bit32s product1 = Bit32s(op1.xmm16s(0)) * Bit32s(op2.xmm16s(0));
   Bit32s product2 = Bit32s(op1.xmm16s(1)) * Bit32s(op2.xmm16s(1));
   Bit32s product3 = Bit32s(op1.xmm16s(2)) * Bit32s(op2.xmm16s(2));
@@ -1120,6 +1235,7 @@ void BX_CPU_C::PMULHW_VdqWdq(bxInstruction_c *i)
   result.xmm16u(5) = (Bit16u)(product6 >> 16);
   result.xmm16u(6) = (Bit16u)(product7 >> 16);
   result.xmm16u(7) = (Bit16u)(product8 >> 16);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1146,9 +1262,13 @@ void BX_CPU_C::PSUBSB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_subs_epi8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     result.xmmsbyte(j) = SaturateWordSToByteS(Bit16s(op1.xmmsbyte(j)) - Bit16s(op2.xmmsbyte(j)));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1175,6 +1295,9 @@ void BX_CPU_C::PSUBSW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_subs_epi16, op1, op2);
+#else
   result.xmm16s(0) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(0)) - Bit32s(op2.xmm16s(0)));
   result.xmm16s(1) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(1)) - Bit32s(op2.xmm16s(1)));
   result.xmm16s(2) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(2)) - Bit32s(op2.xmm16s(2)));
@@ -1183,6 +1306,7 @@ void BX_CPU_C::PSUBSW_VdqWdq(bxInstruction_c *i)
   result.xmm16s(5) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(5)) - Bit32s(op2.xmm16s(5)));
   result.xmm16s(6) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(6)) - Bit32s(op2.xmm16s(6)));
   result.xmm16s(7) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(7)) - Bit32s(op2.xmm16s(7)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1209,6 +1333,9 @@ void BX_CPU_C::PMINSW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_min_epi16, op1, op2);
+#else
   if(op2.xmm16s(0) < op1.xmm16s(0)) op1.xmm16s(0) = op2.xmm16s(0);
   if(op2.xmm16s(1) < op1.xmm16s(1)) op1.xmm16s(1) = op2.xmm16s(1);
   if(op2.xmm16s(2) < op1.xmm16s(2)) op1.xmm16s(2) = op2.xmm16s(2);
@@ -1217,6 +1344,7 @@ void BX_CPU_C::PMINSW_VdqWdq(bxInstruction_c *i)
   if(op2.xmm16s(5) < op1.xmm16s(5)) op1.xmm16s(5) = op2.xmm16s(5);
   if(op2.xmm16s(6) < op1.xmm16s(6)) op1.xmm16s(6) = op2.xmm16s(6);
   if(op2.xmm16s(7) < op1.xmm16s(7)) op1.xmm16s(7) = op2.xmm16s(7);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1246,8 +1374,12 @@ void BX_CPU_C::POR_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_or_si128, op1, op2);
+#else
   op1.xmm64u(0) |= op2.xmm64u(0);
   op1.xmm64u(1) |= op2.xmm64u(1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1274,9 +1406,13 @@ void BX_CPU_C::PADDSB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_adds_epi8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     result.xmmsbyte(j) = SaturateWordSToByteS(Bit16s(op1.xmmsbyte(j)) + Bit16s(op2.xmmsbyte(j)));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1303,6 +1439,9 @@ void BX_CPU_C::PADDSW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_adds_epi16, op1, op2);
+#else
   result.xmm16s(0) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(0)) + Bit32s(op2.xmm16s(0)));
   result.xmm16s(1) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(1)) + Bit32s(op2.xmm16s(1)));
   result.xmm16s(2) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(2)) + Bit32s(op2.xmm16s(2)));
@@ -1311,6 +1450,7 @@ void BX_CPU_C::PADDSW_VdqWdq(bxInstruction_c *i)
   result.xmm16s(5) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(5)) + Bit32s(op2.xmm16s(5)));
   result.xmm16s(6) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(6)) + Bit32s(op2.xmm16s(6)));
   result.xmm16s(7) = SaturateDwordSToWordS(Bit32s(op1.xmm16s(7)) + Bit32s(op2.xmm16s(7)));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1337,6 +1477,9 @@ void BX_CPU_C::PMAXSW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_max_epi16, op1, op2);
+#else
   if(op2.xmm16s(0) > op1.xmm16s(0)) op1.xmm16s(0) = op2.xmm16s(0);
   if(op2.xmm16s(1) > op1.xmm16s(1)) op1.xmm16s(1) = op2.xmm16s(1);
   if(op2.xmm16s(2) > op1.xmm16s(2)) op1.xmm16s(2) = op2.xmm16s(2);
@@ -1345,6 +1488,7 @@ void BX_CPU_C::PMAXSW_VdqWdq(bxInstruction_c *i)
   if(op2.xmm16s(5) > op1.xmm16s(5)) op1.xmm16s(5) = op2.xmm16s(5);
   if(op2.xmm16s(6) > op1.xmm16s(6)) op1.xmm16s(6) = op2.xmm16s(6);
   if(op2.xmm16s(7) > op1.xmm16s(7)) op1.xmm16s(7) = op2.xmm16s(7);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1374,8 +1518,12 @@ void BX_CPU_C::PXOR_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_xor_si128, op1, op2);
+#else
   op1.xmm64u(0) ^= op2.xmm64u(0);
   op1.xmm64u(1) ^= op2.xmm64u(1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1402,6 +1550,9 @@ void BX_CPU_C::PSLLW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sll_epi16, op1, op2);
+#else
   if(op2.xmm64u(0) > 15)  /* looking only to low 64 bits */
   {
     op1.xmm64u(0) = 0;
@@ -1420,6 +1571,7 @@ void BX_CPU_C::PSLLW_VdqWdq(bxInstruction_c *i)
     op1.xmm16u(6) <<= shift;
     op1.xmm16u(7) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1446,6 +1598,9 @@ void BX_CPU_C::PSLLD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sll_epi32, op1, op2);
+#else
   if(op2.xmm64u(0) > 31)  /* looking only to low 64 bits */
   {
     op1.xmm64u(0) = 0;
@@ -1460,6 +1615,7 @@ void BX_CPU_C::PSLLD_VdqWdq(bxInstruction_c *i)
     op1.xmm32u(2) <<= shift;
     op1.xmm32u(3) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1486,6 +1642,9 @@ void BX_CPU_C::PSLLQ_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sll_epi64, op1, op2);
+#else
   if(op2.xmm64u(0) > 63)  /* looking only to low 64 bits */
   {
     op1.xmm64u(0) = 0;
@@ -1498,6 +1657,7 @@ void BX_CPU_C::PSLLQ_VdqWdq(bxInstruction_c *i)
     op1.xmm64u(0) <<= shift;
     op1.xmm64u(1) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1524,8 +1684,12 @@ void BX_CPU_C::PMULUDQ_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_mul_epu32, op1, op2);
+#else
   result.xmm64u(0) = Bit64u(op1.xmm32u(0)) * Bit64u(op2.xmm32u(0));
-  result.xmm64u(1) = Bit64u(op1.xmm32u(3)) * Bit64u(op2.xmm32u(3));
+  result.xmm64u(1) = Bit64u(op1.xmm32u(2)) * Bit64u(op2.xmm32u(2));
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1552,6 +1716,9 @@ void BX_CPU_C::PMADDWD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(result, _mm_madd_epi16, op1, op2);
+#else
   for(unsigned j=0; j<4; j++)
   {
     if(op1.xmm32u(j) == 0x80008000 && op2.xmm32u(j) == 0x80008000) {
@@ -1562,6 +1729,7 @@ void BX_CPU_C::PMADDWD_VdqWdq(bxInstruction_c *i)
         Bit32s(op1.xmm16s(2*j+0)) * Bit32s(op2.xmm16s(2*j+0)) +
         Bit32s(op1.xmm16s(2*j+1)) * Bit32s(op2.xmm16s(2*j+1));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), result);
@@ -1578,7 +1746,6 @@ void BX_CPU_C::PSADBW_VdqWdq(bxInstruction_c *i)
   BX_CPU_THIS_PTR prepareSSE();
 
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->nnn()), op2;
-  Bit16u temp1 = 0, temp2 = 0;
 
   /* op2 is a register or memory reference */
   if (i->modC0()) {
@@ -1589,6 +1756,11 @@ void BX_CPU_C::PSADBW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sad_epu8, op1, op2);
+#else
+  Bit16u temp1 = 0, temp2 = 0;
+
   temp1 += abs(op1.xmmubyte(0x0) - op2.xmmubyte(0x0));
   temp1 += abs(op1.xmmubyte(0x1) - op2.xmmubyte(0x1));
   temp1 += abs(op1.xmmubyte(0x2) - op2.xmmubyte(0x2));
@@ -1609,6 +1781,7 @@ void BX_CPU_C::PSADBW_VdqWdq(bxInstruction_c *i)
 
   op1.xmm64u(0) = Bit64u(temp1);
   op1.xmm64u(1) = Bit64u(temp2);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1635,9 +1808,13 @@ void BX_CPU_C::PSUBB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sub_epi8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     op1.xmmubyte(j) -= op2.xmmubyte(j);
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1664,6 +1841,9 @@ void BX_CPU_C::PSUBW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sub_epi16, op1, op2);
+#else
   op1.xmm16u(0) -= op2.xmm16u(0);
   op1.xmm16u(1) -= op2.xmm16u(1);
   op1.xmm16u(2) -= op2.xmm16u(2);
@@ -1672,6 +1852,7 @@ void BX_CPU_C::PSUBW_VdqWdq(bxInstruction_c *i)
   op1.xmm16u(5) -= op2.xmm16u(5);
   op1.xmm16u(6) -= op2.xmm16u(6);
   op1.xmm16u(7) -= op2.xmm16u(7);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1698,10 +1879,14 @@ void BX_CPU_C::PSUBD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sub_epi32, op1, op2);
+#else
   op1.xmm32u(0) -= op2.xmm32u(0);
   op1.xmm32u(1) -= op2.xmm32u(1);
   op1.xmm32u(2) -= op2.xmm32u(2);
   op1.xmm32u(3) -= op2.xmm32u(3);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1728,8 +1913,12 @@ void BX_CPU_C::PSUBQ_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_sub_epi64, op1, op2);
+#else
   op1.xmm64u(0) -= op2.xmm64u(0);
   op1.xmm64u(1) -= op2.xmm64u(1);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1756,9 +1945,13 @@ void BX_CPU_C::PADDB_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_add_epi8, op1, op2);
+#else
   for(unsigned j=0; j<16; j++) {
     op1.xmmubyte(j) += op2.xmmubyte(j);
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1785,6 +1978,9 @@ void BX_CPU_C::PADDW_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_add_epi16, op1, op2);
+#else
   op1.xmm16u(0) += op2.xmm16u(0);
   op1.xmm16u(1) += op2.xmm16u(1);
   op1.xmm16u(2) += op2.xmm16u(2);
@@ -1793,6 +1989,7 @@ void BX_CPU_C::PADDW_VdqWdq(bxInstruction_c *i)
   op1.xmm16u(5) += op2.xmm16u(5);
   op1.xmm16u(6) += op2.xmm16u(6);
   op1.xmm16u(7) += op2.xmm16u(7);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1819,10 +2016,14 @@ void BX_CPU_C::PADDD_VdqWdq(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM(op1, _mm_add_epi32, op1, op2);
+#else
   op1.xmm32u(0) += op2.xmm32u(0);
   op1.xmm32u(1) += op2.xmm32u(1);
   op1.xmm32u(2) += op2.xmm32u(2);
   op1.xmm32u(3) += op2.xmm32u(3);
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->nnn(), op1);
@@ -1841,6 +2042,9 @@ void BX_CPU_C::PSRLW_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(op, _mm_srl_epi16, op, shift);
+#else
   if(shift > 15) {
     op.xmm64u(0) = 0;
     op.xmm64u(1) = 0;
@@ -1855,6 +2059,7 @@ void BX_CPU_C::PSRLW_PdqIb(bxInstruction_c *i)
     op.xmm16u(6) >>= shift;
     op.xmm16u(7) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), op);
@@ -1873,9 +2078,12 @@ void BX_CPU_C::PSRAW_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm()), result;
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(result, _mm_sra_epi16, op, shift);
+#else
   if(shift == 0)
   {
-    BX_WRITE_XMM_REG(i->nnn(), op);
+    BX_WRITE_XMM_REG(i->rm(), op);
     return;
   }
 
@@ -1908,6 +2116,7 @@ void BX_CPU_C::PSRAW_PdqIb(bxInstruction_c *i)
     if(op.xmm16u(6) & 0x8000) result.xmm16u(6) |= (0xffff << (16 - shift));
     if(op.xmm16u(7) & 0x8000) result.xmm16u(7) |= (0xffff << (16 - shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), result);
@@ -1926,6 +2135,9 @@ void BX_CPU_C::PSLLW_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(op, _mm_sll_epi16, op, shift);
+#else
   if(shift > 15) {
     op.xmm64u(0) = 0;
     op.xmm64u(1) = 0;
@@ -1940,6 +2152,7 @@ void BX_CPU_C::PSLLW_PdqIb(bxInstruction_c *i)
     op.xmm16u(6) <<= shift;
     op.xmm16u(7) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), op);
@@ -1958,6 +2171,9 @@ void BX_CPU_C::PSRLD_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(op, _mm_srl_epi32, op, shift);
+#else
   if(shift > 31) {
     op.xmm64u(0) = 0;
     op.xmm64u(1) = 0;
@@ -1968,6 +2184,7 @@ void BX_CPU_C::PSRLD_PdqIb(bxInstruction_c *i)
     op.xmm32u(2) >>= shift;
     op.xmm32u(3) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), op);
@@ -1986,9 +2203,12 @@ void BX_CPU_C::PSRAD_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm()), result;
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(result, _mm_sra_epi32, op, shift);
+#else
   if(shift == 0)
   {
-    BX_WRITE_XMM_REG(i->nnn(), op);
+    BX_WRITE_XMM_REG(i->rm(), op);
     return;
   }
 
@@ -2009,6 +2229,7 @@ void BX_CPU_C::PSRAD_PdqIb(bxInstruction_c *i)
     if(op.xmm32u(2) & 0x80000000) result.xmm32u(2) |= (0xffffffff << (32-shift));
     if(op.xmm32u(3) & 0x80000000) result.xmm32u(3) |= (0xffffffff << (32-shift));
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), result);
@@ -2027,6 +2248,9 @@ void BX_CPU_C::PSLLD_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(op, _mm_sll_epi32, op, shift);
+#else
   if(shift > 31) {
     op.xmm64u(0) = 0;
     op.xmm64u(1) = 0;
@@ -2037,6 +2261,7 @@ void BX_CPU_C::PSLLD_PdqIb(bxInstruction_c *i)
     op.xmm32u(2) <<= shift;
     op.xmm32u(3) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), op);
@@ -2055,6 +2280,9 @@ void BX_CPU_C::PSRLQ_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(op, _mm_srl_epi64, op, shift);
+#else
   if(shift > 63) {
     op.xmm64u(0) = 0;
     op.xmm64u(1) = 0;
@@ -2063,6 +2291,7 @@ void BX_CPU_C::PSRLQ_PdqIb(bxInstruction_c *i)
     op.xmm64u(0) >>= shift;
     op.xmm64u(1) >>= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), op);
@@ -2104,6 +2333,9 @@ void BX_CPU_C::PSLLQ_PdqIb(bxInstruction_c *i)
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->rm());
   Bit8u shift = i->Ib();
 
+#if defined(BX_HostAsm_SIMD)
+  BX_HOSTSIMD_XMM_SHIFT(op, _mm_sll_epi64, op, shift);
+#else
   if(shift > 63) {
     op.xmm64u(0) = 0;
     op.xmm64u(1) = 0;
@@ -2112,6 +2344,7 @@ void BX_CPU_C::PSLLQ_PdqIb(bxInstruction_c *i)
     op.xmm64u(0) <<= shift;
     op.xmm64u(1) <<= shift;
   }
+#endif
 
   /* now write result back to destination */
   BX_WRITE_XMM_REG(i->rm(), op);
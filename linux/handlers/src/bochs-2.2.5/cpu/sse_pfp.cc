@@ -83,6 +83,93 @@ static float64_compare_method compare64[4] = {
 
 #endif /* BX_SUPPORT_SSE >= 2 */
 
+#if defined(BX_HostAsm_SSE)
+
+/*
+ * Host fast path for ADD/SUB/MUL/DIV.  With round to nearest and operands
+ * and results that are all zero or normal, the host computes the same
+ * results as softfloat, and as long as it raises no flag other than #P
+ * the same flags: DAZ, FTZ, NaN propagation and the exception masks can
+ * not make a difference then.  Anything else is done again in softfloat.
+ * The helpers return the flags, or -1 if softfloat has to be used.
+ */
+static BX_CPP_INLINE bx_bool float32_plain(float32 a)
+{
+  Bit32u exp = (a >> 23) & 0xff;
+  return (exp != 0xff) && (exp != 0 || (a & 0x7fffff) == 0);
+}
+
+static BX_CPP_INLINE bx_bool float64_plain(float64 a)
+{
+  Bit32u exp = (Bit32u) (a >> 52) & 0x7ff;
+  return (exp != 0x7ff) && (exp != 0 || (a & BX_CONST64(0xfffffffffffff)) == 0);
+}
+
+static BX_CPP_INLINE bx_bool packed32_plain(const BxPackedXmmRegister &op)
+{
+  return float32_plain(op.xmm32u(0)) && float32_plain(op.xmm32u(1)) &&
+         float32_plain(op.xmm32u(2)) && float32_plain(op.xmm32u(3));
+}
+
+static BX_CPP_INLINE bx_bool packed64_plain(const BxPackedXmmRegister &op)
+{
+  return float64_plain(op.xmm64u(0)) && float64_plain(op.xmm64u(1));
+}
+
+typedef Bit32u (*host_sse_op_t)(void *dst, const void *src);
+
+static int host_sse_ps(host_sse_op_t op, BxPackedXmmRegister &op1,
+                       const BxPackedXmmRegister &op2, bx_mxcsr_t mxcsr)
+{
+  if (mxcsr.get_rounding_mode() != float_round_nearest_even) return -1;
+  if (! packed32_plain(op1) || ! packed32_plain(op2)) return -1;
+  BxPackedXmmRegister result = op1;
+  Bit32u flags = op(&result, &op2);
+  if ((flags & ~float_flag_inexact) || ! packed32_plain(result)) return -1;
+  op1 = result;
+  return flags;
+}
+
+static int host_sse_ss(host_sse_op_t op, Float32 &op1, Float32 op2, bx_mxcsr_t mxcsr)
+{
+  if (mxcsr.get_rounding_mode() != float_round_nearest_even) return -1;
+  if (! float32_plain(op1) || ! float32_plain(op2)) return -1;
+  Float32 result = op1;
+  Bit32u flags = op(&result, &op2);
+  if ((flags & ~float_flag_inexact) || ! float32_plain(result)) return -1;
+  op1 = result;
+  return flags;
+}
+
+#if BX_SUPPORT_SSE >= 2
+
+static int host_sse_pd(host_sse_op_t op, BxPackedXmmRegister &op1,
+                       const BxPackedXmmRegister &op2, bx_mxcsr_t mxcsr)
+{
+  if (mxcsr.get_rounding_mode() != float_round_nearest_even) return -1;
+  if (! packed64_plain(op1) || ! packed64_plain(op2)) return -1;
+  BxPackedXmmRegister result = op1;
+  Bit32u flags = op(&result, &op2);
+  if ((flags & ~float_flag_inexact) || ! packed64_plain(result)) return -1;
+  op1 = result;
+  return flags;
+}
+
+static int host_sse_sd(host_sse_op_t op, Float64 &op1, Float64 op2, bx_mxcsr_t mxcsr)
+{
+  if (mxcsr.get_rounding_mode() != float_round_nearest_even) return -1;
+  if (! float64_plain(op1) || ! float64_plain(op2)) return -1;
+  Float64 result = op1;
+  Bit32u flags = op(&result, &op2);
+  if ((flags & ~float_flag_inexact) || ! float64_plain(result)) return -1;
+  op1 = result;
+  return flags;
+}
+
+#endif /* BX_SUPPORT_SSE >= 2 */
+
+#endif /* BX_HostAsm_SSE */
+
 #endif
 
 /* 
@@ -1362,6 +1449,15 @@ void BX_CPU_C::ADDPS_VpsWps(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ps(asmAddps, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1416,6 +1512,15 @@ void BX_CPU_C::ADDPD_VpdWpd(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_pd(asmAddpd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1462,6 +1567,15 @@ void BX_CPU_C::ADDSD_VsdWsd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_sd(asmAddsd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_QWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1502,6 +1616,15 @@ void BX_CPU_C::ADDSS_VssWss(bxInstruction_c *i)
     read_virtual_dword(i->seg(), RMAddr(i), &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ss(asmAddss, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_DWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1542,6 +1665,15 @@ void BX_CPU_C::MULPS_VpsWps(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ps(asmMulps, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1596,6 +1728,15 @@ void BX_CPU_C::MULPD_VpdWpd(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_pd(asmMulpd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1642,6 +1783,15 @@ void BX_CPU_C::MULSD_VsdWsd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_sd(asmMulsd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_QWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1682,6 +1832,15 @@ void BX_CPU_C::MULSS_VssWss(bxInstruction_c *i)
     read_virtual_dword(i->seg(), RMAddr(i), &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ss(asmMulss, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_DWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1722,6 +1881,15 @@ void BX_CPU_C::SUBPS_VpsWps(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ps(asmSubps, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1776,6 +1944,15 @@ void BX_CPU_C::SUBPD_VpdWpd(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_pd(asmSubpd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1822,6 +1999,15 @@ void BX_CPU_C::SUBSD_VsdWsd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_sd(asmSubsd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_QWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -1862,6 +2048,15 @@ void BX_CPU_C::SUBSS_VssWss(bxInstruction_c *i)
     read_virtual_dword(i->seg(), RMAddr(i), &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ss(asmSubss, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_DWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -2092,6 +2287,15 @@ void BX_CPU_C::DIVPS_VpsWps(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ps(asmDivps, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -2146,6 +2350,15 @@ void BX_CPU_C::DIVPD_VpdWpd(bxInstruction_c *i)
     readVirtualDQwordAligned(i->seg(), RMAddr(i), (Bit8u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_pd(asmDivpd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -2192,6 +2405,15 @@ void BX_CPU_C::DIVSD_VsdWsd(bxInstruction_c *i)
     read_virtual_qword(i->seg(), RMAddr(i), (Bit64u *) &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_sd(asmDivsd, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_QWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
@@ -2232,6 +2454,15 @@ void BX_CPU_C::DIVSS_VssWss(bxInstruction_c *i)
     read_virtual_dword(i->seg(), RMAddr(i), &op2);
   }
 
+#if defined(BX_HostAsm_SSE)
+  int host_flags = host_sse_ss(asmDivss, op1, op2, MXCSR);
+  if (host_flags >= 0) {
+    BX_CPU_THIS_PTR check_exceptionsSSE(host_flags);
+    BX_WRITE_XMM_REG_LO_DWORD(i->nnn(), op1);
+    return;
+  }
+#endif
+
   float_status_t status_word;
   mxcsr_to_softfloat_status_word(status_word, MXCSR);
 
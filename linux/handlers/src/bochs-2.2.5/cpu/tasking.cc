@@ -264,28 +264,57 @@ void BX_CPU_C::task_switch(bx_selector_t *tss_selector,
                  access_linear(obase32 + 40, 2, 0, BX_WRITE, &temp16);
   }
   else {
-    temp32 = EIP; access_linear(obase32 + 0x20, 4, 0, BX_WRITE, &temp32);
-    temp32 = oldEFLAGS; access_linear(obase32 + 0x24, 4, 0, BX_WRITE, &temp32);
-    temp32 = EAX; access_linear(obase32 + 0x28, 4, 0, BX_WRITE, &temp32);
-    temp32 = ECX; access_linear(obase32 + 0x2c, 4, 0, BX_WRITE, &temp32);
-    temp32 = EDX; access_linear(obase32 + 0x30, 4, 0, BX_WRITE, &temp32);
-    temp32 = EBX; access_linear(obase32 + 0x34, 4, 0, BX_WRITE, &temp32);
-    temp32 = ESP; access_linear(obase32 + 0x38, 4, 0, BX_WRITE, &temp32);
-    temp32 = EBP; access_linear(obase32 + 0x3c, 4, 0, BX_WRITE, &temp32);
-    temp32 = ESI; access_linear(obase32 + 0x40, 4, 0, BX_WRITE, &temp32);
-    temp32 = EDI; access_linear(obase32 + 0x44, 4, 0, BX_WRITE, &temp32);
-    temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_ES].selector.value;
-                  access_linear(obase32 + 0x48, 2, 0, BX_WRITE, &temp16);
-    temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS].selector.value;
-                  access_linear(obase32 + 0x4c, 2, 0, BX_WRITE, &temp16);
-    temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].selector.value;
-                  access_linear(obase32 + 0x50, 2, 0, BX_WRITE, &temp16);
-    temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_DS].selector.value;
-                  access_linear(obase32 + 0x54, 2, 0, BX_WRITE, &temp16);
-    temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_FS].selector.value;
-                  access_linear(obase32 + 0x58, 2, 0, BX_WRITE, &temp16);
-    temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_GS].selector.value;
-                  access_linear(obase32 + 0x5c, 2, 0, BX_WRITE, &temp16);
+    // The dynamic fields are one contiguous block; store them through
+    // the host pointer when it lies in one page of plain RAM.
+    Bit8u *hostAddr = tss_host_addr(obase32 + 0x20, 0x40, BX_WRITE);
+    if (hostAddr) {
+      WriteHostDWordToLittleEndian(hostAddr + 0x00, EIP);
+      WriteHostDWordToLittleEndian(hostAddr + 0x04, oldEFLAGS);
+      WriteHostDWordToLittleEndian(hostAddr + 0x08, EAX);
+      WriteHostDWordToLittleEndian(hostAddr + 0x0c, ECX);
+      WriteHostDWordToLittleEndian(hostAddr + 0x10, EDX);
+      WriteHostDWordToLittleEndian(hostAddr + 0x14, EBX);
+      WriteHostDWordToLittleEndian(hostAddr + 0x18, ESP);
+      WriteHostDWordToLittleEndian(hostAddr + 0x1c, EBP);
+      WriteHostDWordToLittleEndian(hostAddr + 0x20, ESI);
+      WriteHostDWordToLittleEndian(hostAddr + 0x24, EDI);
+      WriteHostWordToLittleEndian(hostAddr + 0x28,
+        BX_CPU_THIS_PTR sregs[BX_SEG_REG_ES].selector.value);
+      WriteHostWordToLittleEndian(hostAddr + 0x2c,
+        BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS].selector.value);
+      WriteHostWordToLittleEndian(hostAddr + 0x30,
+        BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].selector.value);
+      WriteHostWordToLittleEndian(hostAddr + 0x34,
+        BX_CPU_THIS_PTR sregs[BX_SEG_REG_DS].selector.value);
+      WriteHostWordToLittleEndian(hostAddr + 0x38,
+        BX_CPU_THIS_PTR sregs[BX_SEG_REG_FS].selector.value);
+      WriteHostWordToLittleEndian(hostAddr + 0x3c,
+        BX_CPU_THIS_PTR sregs[BX_SEG_REG_GS].selector.value);
+    }
+    else {
+      temp32 = EIP; access_linear(obase32 + 0x20, 4, 0, BX_WRITE, &temp32);
+      temp32 = oldEFLAGS; access_linear(obase32 + 0x24, 4, 0, BX_WRITE, &temp32);
+      temp32 = EAX; access_linear(obase32 + 0x28, 4, 0, BX_WRITE, &temp32);
+      temp32 = ECX; access_linear(obase32 + 0x2c, 4, 0, BX_WRITE, &temp32);
+      temp32 = EDX; access_linear(obase32 + 0x30, 4, 0, BX_WRITE, &temp32);
+      temp32 = EBX; access_linear(obase32 + 0x34, 4, 0, BX_WRITE, &temp32);
+      temp32 = ESP; access_linear(obase32 + 0x38, 4, 0, BX_WRITE, &temp32);
+      temp32 = EBP; access_linear(obase32 + 0x3c, 4, 0, BX_WRITE, &temp32);
+      temp32 = ESI; access_linear(obase32 + 0x40, 4, 0, BX_WRITE, &temp32);
+      temp32 = EDI; access_linear(obase32 + 0x44, 4, 0, BX_WRITE, &temp32);
+      temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_ES].selector.value;
+                    access_linear(obase32 + 0x48, 2, 0, BX_WRITE, &temp16);
+      temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS].selector.value;
+                    access_linear(obase32 + 0x4c, 2, 0, BX_WRITE, &temp16);
+      temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].selector.value;
+                    access_linear(obase32 + 0x50, 2, 0, BX_WRITE, &temp16);
+      temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_DS].selector.value;
+                    access_linear(obase32 + 0x54, 2, 0, BX_WRITE, &temp16);
+      temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_FS].selector.value;
+                    access_linear(obase32 + 0x58, 2, 0, BX_WRITE, &temp16);
+      temp16 = BX_CPU_THIS_PTR sregs[BX_SEG_REG_GS].selector.value;
+                    access_linear(obase32 + 0x5c, 2, 0, BX_WRITE, &temp16);
+    }
   }
 
   // effect on link field of new task
@@ -339,28 +368,54 @@ void BX_CPU_C::task_switch(bx_selector_t *tss_selector,
     trap_word = 0; // keep compiler happy (not used)
   }
   else {
-    if (BX_CPU_THIS_PTR cr0.pg)
-      access_linear(nbase32 + 0x1c, 4, 0, BX_READ, &newCR3);
-    else
-      newCR3 = 0;   // keep compiler happy (not used)
-    access_linear(nbase32 + 0x20, 4, 0, BX_READ, &newEIP);
-    access_linear(nbase32 + 0x24, 4, 0, BX_READ, &newEFLAGS);
-    access_linear(nbase32 + 0x28, 4, 0, BX_READ, &newEAX);
-    access_linear(nbase32 + 0x2c, 4, 0, BX_READ, &newECX);
-    access_linear(nbase32 + 0x30, 4, 0, BX_READ, &newEDX);
-    access_linear(nbase32 + 0x34, 4, 0, BX_READ, &newEBX);
-    access_linear(nbase32 + 0x38, 4, 0, BX_READ, &newESP);
-    access_linear(nbase32 + 0x3c, 4, 0, BX_READ, &newEBP);
-    access_linear(nbase32 + 0x40, 4, 0, BX_READ, &newESI);
-    access_linear(nbase32 + 0x44, 4, 0, BX_READ, &newEDI);
-    access_linear(nbase32 + 0x48, 2, 0, BX_READ, &raw_es_selector);
-    access_linear(nbase32 + 0x4c, 2, 0, BX_READ, &raw_cs_selector);
-    access_linear(nbase32 + 0x50, 2, 0, BX_READ, &raw_ss_selector);
-    access_linear(nbase32 + 0x54, 2, 0, BX_READ, &raw_ds_selector);
-    access_linear(nbase32 + 0x58, 2, 0, BX_READ, &raw_fs_selector);
-    access_linear(nbase32 + 0x5c, 2, 0, BX_READ, &raw_gs_selector);
-    access_linear(nbase32 + 0x60, 2, 0, BX_READ, &raw_ldt_selector);
-    access_linear(nbase32 + 0x64, 2, 0, BX_READ, &trap_word);
+    Bit8u *hostAddr = tss_host_addr(nbase32 + 0x1c, 0x4c, BX_READ);
+    if (hostAddr) {
+      ReadHostDWordFromLittleEndian(hostAddr + 0x00, newCR3);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x04, newEIP);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x08, newEFLAGS);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x0c, newEAX);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x10, newECX);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x14, newEDX);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x18, newEBX);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x1c, newESP);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x20, newEBP);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x24, newESI);
+      ReadHostDWordFromLittleEndian(hostAddr + 0x28, newEDI);
+      ReadHostWordFromLittleEndian(hostAddr + 0x2c, raw_es_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x30, raw_cs_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x34, raw_ss_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x38, raw_ds_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x3c, raw_fs_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x40, raw_gs_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x44, raw_ldt_selector);
+      ReadHostWordFromLittleEndian(hostAddr + 0x48, trap_word);
+      if (BX_CPU_THIS_PTR cr0.pg == 0)
+        newCR3 = 0;   // keep compiler happy (not used)
+    }
+    else {
+      if (BX_CPU_THIS_PTR cr0.pg)
+        access_linear(nbase32 + 0x1c, 4, 0, BX_READ, &newCR3);
+      else
+        newCR3 = 0;   // keep compiler happy (not used)
+      access_linear(nbase32 + 0x20, 4, 0, BX_READ, &newEIP);
+      access_linear(nbase32 + 0x24, 4, 0, BX_READ, &newEFLAGS);
+      access_linear(nbase32 + 0x28, 4, 0, BX_READ, &newEAX);
+      access_linear(nbase32 + 0x2c, 4, 0, BX_READ, &newECX);
+      access_linear(nbase32 + 0x30, 4, 0, BX_READ, &newEDX);
+      access_linear(nbase32 + 0x34, 4, 0, BX_READ, &newEBX);
+      access_linear(nbase32 + 0x38, 4, 0, BX_READ, &newESP);
+      access_linear(nbase32 + 0x3c, 4, 0, BX_READ, &newEBP);
+      access_linear(nbase32 + 0x40, 4, 0, BX_READ, &newESI);
+      access_linear(nbase32 + 0x44, 4, 0, BX_READ, &newEDI);
+      access_linear(nbase32 + 0x48, 2, 0, BX_READ, &raw_es_selector);
+      access_linear(nbase32 + 0x4c, 2, 0, BX_READ, &raw_cs_selector);
+      access_linear(nbase32 + 0x50, 2, 0, BX_READ, &raw_ss_selector);
+      access_linear(nbase32 + 0x54, 2, 0, BX_READ, &raw_ds_selector);
+      access_linear(nbase32 + 0x58, 2, 0, BX_READ, &raw_fs_selector);
+      access_linear(nbase32 + 0x5c, 2, 0, BX_READ, &raw_gs_selector);
+      access_linear(nbase32 + 0x60, 2, 0, BX_READ, &raw_ldt_selector);
+      access_linear(nbase32 + 0x64, 2, 0, BX_READ, &trap_word);
+    }
   }
 
   // Step 5: If CALL, interrupt, or JMP, set busy flag in new task's
@@ -598,6 +653,7 @@ void BX_CPU_C::task_switch(bx_selector_t *tss_selector,
 
       // All checks pass, fill in shadow cache
       BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS].cache = cs_descriptor;
+      set_seg_access_ok(&BX_CPU_THIS_PTR sregs[BX_SEG_REG_CS]);
     }
     else {
       // If new cs selector is null #TS(CS)
@@ -660,6 +716,7 @@ void BX_CPU_C::task_switch(bx_selector_t *tss_selector,
 
       // All checks pass, fill in shadow cache
       BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS].cache = ss_descriptor;
+      set_seg_access_ok(&BX_CPU_THIS_PTR sregs[BX_SEG_REG_SS]);
     }
     else {
       // SS selector is valid, else #TS(new stack segment)
@@ -737,9 +794,49 @@ void BX_CPU_C::task_switch_load_selector(bx_segment_reg_t *seg,
 
     // All checks pass, fill in shadow cache
     seg->cache = descriptor;
+    set_seg_access_ok(seg);
   }
 }
 
+// Host address of the TSS bytes [laddr, laddr+len) when they sit in one
+// page of ordinary RAM, so task_switch() can move the register block
+// without a translation per field.  NULL means use access_linear().
+// The range has already been checked for page faults by the caller.
+Bit8u* BX_CPU_C::tss_host_addr(Bit32u laddr, unsigned len, unsigned rw)
+{
+  Bit32u paddr = laddr;
+
+#if BX_X86_DEBUGGER
+  // data breakpoints are matched in access_linear()
+  if (BX_CPU_THIS_PTR dr7 & 0x000000ff)
+    return(NULL);
+#endif
+  if (((laddr & 0xfff) + len) > 4096)
+    return(NULL);
+#if BX_SUPPORT_PAGING
+  if (BX_CPU_THIS_PTR cr0.pg)
+    paddr = dtranslate_linear(laddr, 0, rw);
+#endif
+  Bit8u *hostAddr = BX_CPU_THIS_PTR mem->getHostMemAddr(BX_CPU_THIS,
+            A20ADDR(paddr), rw);
+  if (hostAddr == NULL)
+    return(NULL);
+#if BX_INSTRUMENTATION
+  // report the block in pieces of at most 16 bytes, the widest access
+  // the instrumentation callbacks are expected to see
+  for (unsigned off = 0; off < len; off += 16) {
+    unsigned chunk = (len - off > 16) ? 16 : (len - off);
+    if (rw == BX_READ) {
+      BX_INSTR_LIN_READ(BX_CPU_ID, laddr + off, paddr + off, chunk);
+    }
+    else {
+      BX_INSTR_LIN_WRITE(BX_CPU_ID, laddr + off, paddr + off, chunk);
+    }
+  }
+#endif
+  return(hostAddr);
+}
+
 void BX_CPU_C::get_SS_ESP_from_TSS(unsigned pl, Bit16u *ss, Bit32u *esp)
 {
   if (BX_CPU_THIS_PTR tr.cache.valid==0)
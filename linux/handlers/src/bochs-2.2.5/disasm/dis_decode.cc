@@ -261,7 +261,8 @@ unsigned disassembler::disasm(bx_bool is_32, bx_bool is_64, bx_address base, bx_
     if (prefix_byte == 0xF3 || prefix_byte == 0xF2 || prefix_byte == 0xF0) 
     {
       const BxDisasmOpcodeTable_t *prefix = &(opcode_table[prefix_byte]);
-      dis_sprintf("%s ", OPCODE(prefix)->IntelOpcode);
+      dis_puts(OPCODE(prefix)->IntelOpcode);
+      dis_putc(' ');
     }
 
     // branch hint for jcc instructions
@@ -287,25 +288,101 @@ unsigned disassembler::disasm(bx_bool is_32, bx_bool is_64, bx_address base, bx_
 
   if (branch_hint == BRANCH_NOT_TAKEN)
   {
-    dis_sprintf(", not taken");
+    dis_puts(", not taken");
   }
   else if (branch_hint == BRANCH_TAKEN)
   {
-    dis_sprintf(", taken");
+    dis_puts(", taken");
   }
  
   return(instruction - instruction_begin);
 }
 
-void disassembler::dis_sprintf(char *fmt, ...)
+// The operand printers only use a handful of conversions (%s, %c, %d,
+// %u and %x with an optional zero padded width), so they are expanded
+// here directly instead of going through vsprintf() and strlen() for
+// every operand.
+static const char dis_hex_digits[] = "0123456789abcdef";
+
+void disassembler::dis_sprintf(const char *fmt, ...)
 {
   va_list ap;
+  char *p = disbufptr;
 
   va_start(ap, fmt);
-  vsprintf(disbufptr, fmt, ap);
+  for (; *fmt; fmt++) {
+    if (*fmt != '%') {
+      *p++ = *fmt;
+      continue;
+    }
+    fmt++;
+    if (*fmt == '%') {
+      *p++ = '%';
+      continue;
+    }
+    unsigned width = 0;
+    while (*fmt >= '0' && *fmt <= '9')
+      width = width * 10 + (*fmt++ - '0');
+
+    char digits[12];
+    unsigned n = 0;
+    switch (*fmt) {
+      case 's':
+        {
+          const char *str = va_arg(ap, const char *);
+          while (*str) *p++ = *str++;
+        }
+        continue;
+      case 'c':
+        *p++ = (char) va_arg(ap, int);
+        continue;
+      case 'x':
+        {
+          unsigned val = va_arg(ap, unsigned);
+          do {
+            digits[n++] = dis_hex_digits[val & 0xf];
+            val >>= 4;
+          } while (val);
+        }
+        break;
+      case 'd':
+      case 'u':
+        {
+          int sval = va_arg(ap, int);
+          unsigned val = (unsigned) sval;
+          if (*fmt == 'd' && sval < 0) {
+            *p++ = '-';
+            val = 0 - val;
+          }
+          do {
+            digits[n++] = '0' + val % 10;
+            val /= 10;
+          } while (val);
+        }
+        break;
+      default:
+        *p++ = '%';
+        *p++ = *fmt;
+        continue;
+    }
+    while (width > n) {
+      *p++ = '0';
+      width--;
+    }
+    while (n) *p++ = digits[--n];
+  }
   va_end(ap);
 
-  disbufptr += strlen(disbufptr);
+  *p = 0;
+  disbufptr = p;
+}
+
+void disassembler::dis_puts(const char *str)
+{
+  char *p = disbufptr;
+  while (*str) *p++ = *str++;
+  *p = 0;
+  disbufptr = p;
 }
 
 void disassembler::dis_putc(char symbol)
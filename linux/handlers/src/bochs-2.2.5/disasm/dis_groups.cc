@@ -22,39 +22,39 @@ void disassembler::Apd(const x86_insn *insn)
 }
 
 // 8-bit general purpose registers
-void disassembler::AL(const x86_insn *insn) { dis_sprintf("%s", general_8bit_regname[rAX_REG]); }
-void disassembler::CL(const x86_insn *insn) { dis_sprintf("%s", general_8bit_regname[rCX_REG]); }
+void disassembler::AL(const x86_insn *insn) { dis_puts(general_8bit_regname[rAX_REG]); }
+void disassembler::CL(const x86_insn *insn) { dis_puts(general_8bit_regname[rCX_REG]); }
 
 // 16-bit general purpose registers
 void disassembler::AX(const x86_insn *insn) {
-  dis_sprintf("%s", general_16bit_regname[rAX_REG]);
+  dis_puts(general_16bit_regname[rAX_REG]);
 }
 
 void disassembler::DX(const x86_insn *insn) {
-  dis_sprintf("%s", general_16bit_regname[rDX_REG]);
+  dis_puts(general_16bit_regname[rDX_REG]);
 }
 
 // 32-bit general purpose registers
 void disassembler::EAX(const x86_insn *insn)
 {
-  dis_sprintf("%s", general_32bit_regname[rAX_REG]);
+  dis_puts(general_32bit_regname[rAX_REG]);
 }
 
 // 64-bit general purpose registers
 void disassembler::RAX(const x86_insn *insn)
 {
-  dis_sprintf("%s", general_64bit_regname[rAX_REG]);
+  dis_puts(general_64bit_regname[rAX_REG]);
 }
 
 // segment registers
-void disassembler::CS(const x86_insn *insn) { dis_sprintf("%s", segment_name[CS_REG]); }
-void disassembler::DS(const x86_insn *insn) { dis_sprintf("%s", segment_name[DS_REG]); }
-void disassembler::ES(const x86_insn *insn) { dis_sprintf("%s", segment_name[ES_REG]); }
-void disassembler::SS(const x86_insn *insn) { dis_sprintf("%s", segment_name[SS_REG]); }
-void disassembler::FS(const x86_insn *insn) { dis_sprintf("%s", segment_name[FS_REG]); }
-void disassembler::GS(const x86_insn *insn) { dis_sprintf("%s", segment_name[GS_REG]); }
+void disassembler::CS(const x86_insn *insn) { dis_puts(segment_name[CS_REG]); }
+void disassembler::DS(const x86_insn *insn) { dis_puts(segment_name[DS_REG]); }
+void disassembler::ES(const x86_insn *insn) { dis_puts(segment_name[ES_REG]); }
+void disassembler::SS(const x86_insn *insn) { dis_puts(segment_name[SS_REG]); }
+void disassembler::FS(const x86_insn *insn) { dis_puts(segment_name[FS_REG]); }
+void disassembler::GS(const x86_insn *insn) { dis_puts(segment_name[GS_REG]); }
 
-void disassembler::Sw(const x86_insn *insn) { dis_sprintf("%s", segment_name[insn->nnn]); }
+void disassembler::Sw(const x86_insn *insn) { dis_puts(segment_name[insn->nnn]); }
 
 // test registers
 void disassembler::Td(const x86_insn *insn)
@@ -93,27 +93,27 @@ void disassembler::R8(const x86_insn *insn)
   unsigned reg = (insn->b1 & 7) | insn->rex_b;
  
   if (reg < 4 || insn->extend8b)
-    dis_sprintf("%s", general_8bit_regname_rex[reg]);
+    dis_puts(general_8bit_regname_rex[reg]);
   else
-    dis_sprintf("%s", general_8bit_regname[reg]);
+    dis_puts(general_8bit_regname[reg]);
 }
 
 // 16-bit general purpose register
 void disassembler::RX(const x86_insn *insn)
 { 
-  dis_sprintf("%s", general_16bit_regname[(insn->b1 & 7) | insn->rex_b]);
+  dis_puts(general_16bit_regname[(insn->b1 & 7) | insn->rex_b]);
 }
 
 // 32-bit general purpose register
 void disassembler::ERX(const x86_insn *insn)
 { 
-  dis_sprintf("%s", general_32bit_regname[(insn->b1 & 7) | insn->rex_b]);
+  dis_puts(general_32bit_regname[(insn->b1 & 7) | insn->rex_b]);
 }
 
 // 64-bit general purpose register
 void disassembler::RRX(const x86_insn *insn)
 { 
-  dis_sprintf("%s", general_64bit_regname[(insn->b1 & 7) | insn->rex_b]);
+  dis_puts(general_64bit_regname[(insn->b1 & 7) | insn->rex_b]);
 }
 
 // general purpose register or memory operand
@@ -121,9 +121,9 @@ void disassembler::Eb(const x86_insn *insn)
 {
   if (insn->mod == 3) {
     if (insn->rm < 4 || insn->extend8b)
-      dis_sprintf("%s", general_8bit_regname_rex[insn->rm]);
+      dis_puts(general_8bit_regname_rex[insn->rm]);
     else
-      dis_sprintf("%s", general_8bit_regname[insn->rm]);
+      dis_puts(general_8bit_regname[insn->rm]);
   }
   else
     (this->*resolve_modrm)(insn, B_SIZE);
@@ -132,7 +132,7 @@ void disassembler::Eb(const x86_insn *insn)
 void disassembler::Ew(const x86_insn *insn) 
 {
   if (insn->mod == 3)
-    dis_sprintf("%s", general_16bit_regname[insn->rm]);
+    dis_puts(general_16bit_regname[insn->rm]);
   else
     (this->*resolve_modrm)(insn, W_SIZE);
 }
@@ -140,7 +140,7 @@ void disassembler::Ew(const x86_insn *insn)
 void disassembler::Ed(const x86_insn *insn) 
 {
   if (insn->mod == 3)
-    dis_sprintf("%s", general_32bit_regname[insn->rm]);
+    dis_puts(general_32bit_regname[insn->rm]);
   else
     (this->*resolve_modrm)(insn, D_SIZE);
 }
@@ -148,7 +148,7 @@ void disassembler::Ed(const x86_insn *insn)
 void disassembler::Eq(const x86_insn *insn) 
 {
   if (insn->mod == 3)
-    dis_sprintf("%s", general_64bit_regname[insn->rm]);
+    dis_puts(general_64bit_regname[insn->rm]);
   else
     (this->*resolve_modrm)(insn, Q_SIZE);
 }
@@ -157,24 +157,24 @@ void disassembler::Eq(const x86_insn *insn)
 void disassembler::Gb(const x86_insn *insn) 
 {
   if (insn->nnn < 4 || insn->extend8b)
-    dis_sprintf("%s", general_8bit_regname_rex[insn->nnn]);
+    dis_puts(general_8bit_regname_rex[insn->nnn]);
   else
-    dis_sprintf("%s", general_8bit_regname[insn->nnn]);
+    dis_puts(general_8bit_regname[insn->nnn]);
 }
 
 void disassembler::Gw(const x86_insn *insn) 
 {
-  dis_sprintf("%s", general_16bit_regname[insn->nnn]);
+  dis_puts(general_16bit_regname[insn->nnn]);
 }
 
 void disassembler::Gd(const x86_insn *insn) 
 {
-  dis_sprintf("%s", general_32bit_regname[insn->nnn]);
+  dis_puts(general_32bit_regname[insn->nnn]);
 }
 
 void disassembler::Gq(const x86_insn *insn) 
 {
-  dis_sprintf("%s", general_64bit_regname[insn->nnn]);
+  dis_puts(general_64bit_regname[insn->nnn]);
 }
 
 // immediate
@@ -265,19 +265,19 @@ void disassembler::STi(const x86_insn *insn)
 // 16-bit general purpose register
 void disassembler::Rw(const x86_insn *insn)
 {
-  dis_sprintf("%s", general_16bit_regname[insn->rm]);
+  dis_puts(general_16bit_regname[insn->rm]);
 }
 
 // 32-bit general purpose register
 void disassembler::Rd(const x86_insn *insn)
 {
-  dis_sprintf("%s", general_32bit_regname[insn->rm]);
+  dis_puts(general_32bit_regname[insn->rm]);
 }
 
 // 64-bit general purpose register
 void disassembler::Rq(const x86_insn *insn)
 {
-  dis_sprintf("%s", general_64bit_regname[insn->rm]);
+  dis_puts(general_64bit_regname[insn->rm]);
 }
 
 // mmx register
@@ -392,7 +392,7 @@ void disassembler::Oq(const x86_insn *insn) { OP_O(insn, Q_SIZE); }
 void disassembler::OP_M(const x86_insn *insn, unsigned size)
 {
   if(insn->mod == 3)
-    dis_sprintf("(bad)");
+    dis_puts("(bad)");
   else
     (this->*resolve_modrm)(insn, size);
 }
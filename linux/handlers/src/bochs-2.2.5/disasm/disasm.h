@@ -227,7 +227,8 @@ private:
   };
 
   void dis_putc(char symbol);
-  void dis_sprintf(char *fmt, ...);
+  void dis_puts(const char *str);
+  void dis_sprintf(const char *fmt, ...);
   void decode_modrm(x86_insn *insn);
 
   void resolve16_mod0   (const x86_insn *insn, unsigned mode);
@@ -302,22 +302,22 @@ void disassembler::print_datasize(unsigned size)
   switch(size)
   {
     case B_SIZE:
-      dis_sprintf("byte ptr ");
+      dis_puts("byte ptr ");
       break;
     case W_SIZE:
-      dis_sprintf("word ptr ");
+      dis_puts("word ptr ");
       break;
     case D_SIZE:
-      dis_sprintf("dword ptr ");
+      dis_puts("dword ptr ");
       break;
     case Q_SIZE:
-      dis_sprintf("qword ptr ");
+      dis_puts("qword ptr ");
       break;
     case O_SIZE:
-      dis_sprintf("dqword ptr ");
+      dis_puts("dqword ptr ");
       break;
     case T_SIZE:
-      dis_sprintf("tbyte ptr ");
+      dis_puts("tbyte ptr ");
       break;
     case P_SIZE:
       break;
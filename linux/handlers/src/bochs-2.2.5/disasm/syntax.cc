@@ -197,11 +197,11 @@ void disassembler::print_disassembly_intel(const x86_insn *insn, const BxDisasmO
     (this->*entry->Operand1)(insn);
   }
   if (entry->Operand2) {
-    dis_sprintf(", ");
+    dis_puts(", ");
     (this->*entry->Operand2)(insn);
   }
   if (entry->Operand3) {
-    dis_sprintf(", ");
+    dis_puts(", ");
     (this->*entry->Operand3)(insn);
   }
 }
@@ -233,11 +233,11 @@ void disassembler::print_disassembly_att(const x86_insn *insn, const BxDisasmOpc
 
   if (entry->Operand3) {                                         
     (this->*entry->Operand3)(insn);
-    dis_sprintf(", ");
+    dis_puts(", ");
   }
   if (entry->Operand2) {
     (this->*entry->Operand2)(insn);
-    dis_sprintf(", ");
+    dis_puts(", ");
   }
   if (entry->Operand1) {
     (this->*entry->Operand1)(insn);
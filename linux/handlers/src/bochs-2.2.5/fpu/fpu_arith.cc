@@ -59,6 +59,179 @@ float_status_t FPU_pre_exception_handling(Bit16u control_word)
 
   return status;
 }
+
+#if defined(BX_HostAsm_Double)
+
+/*
+ * x87 arithmetic on host doubles.  Operands that are zero or normal with
+ * at most 53 significant bits convert to doubles exactly.  The host
+ * rounds the exact result once to 53 bits, as softfloat does with the
+ * precision control set to double; an error free transformation gives
+ * the rounding error, from which follow the inexact flag and C1 (rounded
+ * up).  With extended precision only exact results are taken.  Results
+ * that are not normal (or zero) are left to softfloat, so the extended
+ * exponent range never matters.  Multiplication and division are only
+ * done for exponents below 2^480, which keeps every partial product of
+ * the error computation away from overflow and underflow.
+ */
+
+#define FPU_HOST_MAX_EXP 480
+
+union fpu_host_double_t {
+  double d;
+  Bit64u u;
+};
+
+static BX_CPP_INLINE bx_bool floatx80_to_host_double(floatx80 a, double &d, unsigned max_exp)
+{
+  fpu_host_double_t hd;
+  Bit32u exp = a.exp & 0x7fff;
+
+  hd.u = (Bit64u)(a.exp & 0x8000) << 48;
+  if (exp != 0 || a.fraction != 0) {
+    if (exp < 0x3fff - max_exp || exp > 0x3fff + max_exp) return 0;
+    if (! (a.fraction & BX_CONST64(0x8000000000000000))) return 0;
+    if (a.fraction & 0x7ff) return 0;
+    hd.u |= ((Bit64u)(exp - 0x3fff + 1023) << 52) |
+              ((a.fraction >> 11) & BX_CONST64(0x000fffffffffffff));
+  }
+  d = hd.d;
+  return 1;
+}
+
+/* exact product of a and b as hi + lo (Dekker) */
+static BX_CPP_INLINE void host_double_two_product(double a, double b, double &hi, double &lo)
+{
+  const double split = 134217729.0;  /* 2^27 + 1 */
+  double t, ah, al, bh, bl;
+
+  t = split * a; ah = t - (t - a); al = a - ah;
+  t = split * b; bh = t - (t - b); bl = b - bh;
+  hi = a * b;
+  lo = ((ah * bh - hi) + ah * bl + al * bh) + al * bl;
+}
+
+/* err is the exact result minus r; the host rounded up if they differ in sign */
+static bx_bool FPU_host_double_result(double r, double err, float_status_t &status, floatx80 &result)
+{
+  fpu_host_double_t hd;
+  hd.d = r;
+  Bit32u exp = (Bit32u)(hd.u >> 52) & 0x7ff;
+  Bit16u sign = (Bit16u)(hd.u >> 48) & 0x8000;
+
+  if (exp == 0x7ff) return 0;
+  if (exp == 0) {
+    if (hd.u & BX_CONST64(0x000fffffffffffff)) return 0;
+    if (err != 0) return 0;
+    result.exp = sign;
+    result.fraction = 0;
+    return 1;
+  }
+  if (err != 0) {
+    if (status.float_rounding_precision != 64) return 0;
+    /* like roundAndPackFloatx80(), no C1 when rounding up carried
+       into the next power of two */
+    if ((err < 0) != (r < 0) && (hd.u & BX_CONST64(0x000fffffffffffff)))
+      set_float_rounding_up(status);
+    else
+      float_raise(status, float_flag_inexact);
+  }
+  result.exp = sign | (Bit16u)(exp - 1023 + 0x3fff);
+  result.fraction = BX_CONST64(0x8000000000000000) | (hd.u << 11);
+  return 1;
+}
+
+static BX_CPP_INLINE bx_bool FPU_host_double_usable(float_status_t &status)
+{
+  return status.float_rounding_mode == float_round_nearest_even &&
+         status.float_rounding_precision != 32;
+}
+
+static bx_bool FPU_host_double_add(floatx80 a, floatx80 b, int negate_b,
+        float_status_t &status, floatx80 &result)
+{
+  double da, db;
+
+  if (! FPU_host_double_usable(status)) return 0;
+  if (! floatx80_to_host_double(a, da, 1022) ||
+      ! floatx80_to_host_double(b, db, 1022)) return 0;
+  if (negate_b) db = -db;
+
+  /* TwoSum: s + err == da + db exactly */
+  double s = da + db;
+  double bv = s - da;
+  double err = (da - (s - bv)) + (db - bv);
+  return FPU_host_double_result(s, err, status, result);
+}
+
+static bx_bool FPU_host_double_mul(floatx80 a, floatx80 b,
+        float_status_t &status, floatx80 &result)
+{
+  double da, db, p, err;
+
+  if (! FPU_host_double_usable(status)) return 0;
+  if (! floatx80_to_host_double(a, da, FPU_HOST_MAX_EXP) ||
+      ! floatx80_to_host_double(b, db, FPU_HOST_MAX_EXP)) return 0;
+
+  host_double_two_product(da, db, p, err);
+  return FPU_host_double_result(p, err, status, result);
+}
+
+static bx_bool FPU_host_double_div(floatx80 a, floatx80 b,
+        float_status_t &status, floatx80 &result)
+{
+  double da, db, hi, lo;
+
+  if (! FPU_host_double_usable(status)) return 0;
+  if (! floatx80_to_host_double(a, da, FPU_HOST_MAX_EXP) ||
+      ! floatx80_to_host_double(b, db, FPU_HOST_MAX_EXP)) return 0;
+  if (db == 0) return 0;
+
+  /* the remainder a - q*b of a rounded quotient is a double and exact */
+  double q = da / db;
+  host_double_two_product(q, db, hi, lo);
+  double rem = (da - hi) - lo;
+  /* a/b == q + rem/b */
+  return FPU_host_double_result(q, (db < 0) ? -rem : rem, status, result);
+}
+
+#endif
+
+static BX_CPP_INLINE floatx80 FPU_add(floatx80 a, floatx80 b, float_status_t &status)
+{
+#if defined(BX_HostAsm_Double)
+  floatx80 result;
+  if (FPU_host_double_add(a, b, 0, status, result)) return result;
+#endif
+  return floatx80_add(a, b, status);
+}
+
+static BX_CPP_INLINE floatx80 FPU_sub(floatx80 a, floatx80 b, float_status_t &status)
+{
+#if defined(BX_HostAsm_Double)
+  floatx80 result;
+  if (FPU_host_double_add(a, b, 1, status, result)) return result;
+#endif
+  return floatx80_sub(a, b, status);
+}
+
+static BX_CPP_INLINE floatx80 FPU_mul(floatx80 a, floatx80 b, float_status_t &status)
+{
+#if defined(BX_HostAsm_Double)
+  floatx80 result;
+  if (FPU_host_double_mul(a, b, status, result)) return result;
+#endif
+  return floatx80_mul(a, b, status);
+}
+
+static BX_CPP_INLINE floatx80 FPU_div(floatx80 a, floatx80 b, float_status_t &status)
+{
+#if defined(BX_HostAsm_Double)
+  floatx80 result;
+  if (FPU_host_double_div(a, b, status, result)) return result;
+#endif
+  return floatx80_div(a, b, status);
+}
 #endif
 
 void BX_CPU_C::FADD_ST0_STj(bxInstruction_c *i)
@@ -80,7 +253,7 @@ void BX_CPU_C::FADD_ST0_STj(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_add(a, b, status);
+  floatx80 result = FPU_add(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -112,7 +285,7 @@ void BX_CPU_C::FADD_STi_ST0(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_add(a, b, status);
+  floatx80 result = FPU_add(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -144,7 +317,7 @@ void BX_CPU_C::FADD_SINGLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_add(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_add(BX_READ_FPU_REG(0), 
 		float32_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -175,7 +348,7 @@ void BX_CPU_C::FADD_DOUBLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_add(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_add(BX_READ_FPU_REG(0), 
 		float64_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -209,7 +382,7 @@ void BX_CPU_C::FIADD_WORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_add(a, b, status);
+  floatx80 result = FPU_add(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -242,7 +415,7 @@ void BX_CPU_C::FIADD_DWORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_add(a, b, status);
+  floatx80 result = FPU_add(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -272,7 +445,7 @@ void BX_CPU_C::FMUL_ST0_STj(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_mul(a, b, status);
+  floatx80 result = FPU_mul(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -304,7 +477,7 @@ void BX_CPU_C::FMUL_STi_ST0(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_mul(a, b, status);
+  floatx80 result = FPU_mul(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -336,7 +509,7 @@ void BX_CPU_C::FMUL_SINGLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_mul(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_mul(BX_READ_FPU_REG(0), 
 		float32_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -367,7 +540,7 @@ void BX_CPU_C::FMUL_DOUBLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_mul(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_mul(BX_READ_FPU_REG(0), 
 		float64_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -401,7 +574,7 @@ void BX_CPU_C::FIMUL_WORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_mul(a, b, status);
+  floatx80 result = FPU_mul(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -434,7 +607,7 @@ void BX_CPU_C::FIMUL_DWORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_mul(a, b, status);
+  floatx80 result = FPU_mul(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -464,7 +637,7 @@ void BX_CPU_C::FSUB_ST0_STj(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -494,7 +667,7 @@ void BX_CPU_C::FSUBR_ST0_STj(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -526,7 +699,7 @@ void BX_CPU_C::FSUB_STi_ST0(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -561,7 +734,7 @@ void BX_CPU_C::FSUBR_STi_ST0(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -594,7 +767,7 @@ void BX_CPU_C::FSUB_SINGLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_sub(BX_READ_FPU_REG(0), 
 		float32_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -625,7 +798,7 @@ void BX_CPU_C::FSUBR_SINGLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(float32_to_floatx80(load_reg, status), 
+  floatx80 result = FPU_sub(float32_to_floatx80(load_reg, status), 
 		BX_READ_FPU_REG(0), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -656,7 +829,7 @@ void BX_CPU_C::FSUB_DOUBLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_sub(BX_READ_FPU_REG(0), 
 		float64_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -687,7 +860,7 @@ void BX_CPU_C::FSUBR_DOUBLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(float64_to_floatx80(load_reg, status), 
+  floatx80 result = FPU_sub(float64_to_floatx80(load_reg, status), 
 		BX_READ_FPU_REG(0), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -721,7 +894,7 @@ void BX_CPU_C::FISUB_WORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -754,7 +927,7 @@ void BX_CPU_C::FISUBR_WORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -787,7 +960,7 @@ void BX_CPU_C::FISUB_DWORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_sub(BX_READ_FPU_REG(0), 
 	      int32_to_floatx80(load_reg), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -821,7 +994,7 @@ void BX_CPU_C::FISUBR_DWORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_sub(a, b, status);
+  floatx80 result = FPU_sub(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -851,7 +1024,7 @@ void BX_CPU_C::FDIV_ST0_STj(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -881,7 +1054,7 @@ void BX_CPU_C::FDIVR_ST0_STj(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -913,7 +1086,7 @@ void BX_CPU_C::FDIV_STi_ST0(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -947,7 +1120,7 @@ void BX_CPU_C::FDIVR_STi_ST0(bxInstruction_c *i)
   float_status_t status = 
 	FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -979,7 +1152,7 @@ void BX_CPU_C::FDIV_SINGLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_div(BX_READ_FPU_REG(0), 
 		float32_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -1010,7 +1183,7 @@ void BX_CPU_C::FDIVR_SINGLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(float32_to_floatx80(load_reg, status), 
+  floatx80 result = FPU_div(float32_to_floatx80(load_reg, status), 
 		BX_READ_FPU_REG(0), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -1041,7 +1214,7 @@ void BX_CPU_C::FDIV_DOUBLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(BX_READ_FPU_REG(0), 
+  floatx80 result = FPU_div(BX_READ_FPU_REG(0), 
 		float64_to_floatx80(load_reg, status), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -1072,7 +1245,7 @@ void BX_CPU_C::FDIVR_DOUBLE_REAL(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(float64_to_floatx80(load_reg, status), 
+  floatx80 result = FPU_div(float64_to_floatx80(load_reg, status), 
 		BX_READ_FPU_REG(0), status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
@@ -1106,7 +1279,7 @@ void BX_CPU_C::FIDIV_WORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -1139,7 +1312,7 @@ void BX_CPU_C::FIDIVR_WORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -1172,7 +1345,7 @@ void BX_CPU_C::FIDIV_DWORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -1205,7 +1378,7 @@ void BX_CPU_C::FIDIVR_DWORD_INTEGER(bxInstruction_c *i)
   float_status_t status = 
       FPU_pre_exception_handling(BX_CPU_THIS_PTR the_i387.get_control_word());
 
-  floatx80 result = floatx80_div(a, b, status);
+  floatx80 result = FPU_div(a, b, status);
 
   if (BX_CPU_THIS_PTR FPU_exception(status.float_exception_flags))
       return;
@@ -12,6 +12,16 @@
 #include <signal.h>
 #include <sys/socket.h>
 #endif
+#if !defined(__CYGWIN__) && !defined(__MINGW32__)
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+// a host thread watches the socket while the guest runs
+#define GDBSTUB_POLL_THREAD 1
+#else
+#define GDBSTUB_POLL_THREAD 0
+#endif
 
 #define NEED_CPU_REG_SHORTCUTS 1
 
@@ -26,6 +36,7 @@ static int last_stop_reason = GDBSTUB_STOP_NO_REASON;
 #define GDBSTUB_EXECUTION_BREAKPOINT (0xac1)
 #define GDBSTUB_TRACE (0xac2)
 #define GDBSTUB_USER_BREAK (0xac3)
+#define GDBSTUB_WATCHPOINT (0xac4)
 
 static int listen_socket_fd;
 static int socket_fd;
@@ -216,21 +227,201 @@ static unsigned int breakpoints[MAX_BREAKPOINTS] = {
 };
 static unsigned int nr_breakpoints = 0;
 
-static int stub_trace_flag = 0;
-
+// Open addressing hash set over breakpoints[], rebuilt whenever a
+// breakpoint is inserted or removed, so that the per-instruction check
+// does not depend on the number of breakpoints.
+#define BP_HASH_SIZE (512) // power of 2, at least 2 * MAX_BREAKPOINTS
+#define BP_HASH(addr) ((((Bit32u)(addr)) * 0x9e3779b1U) >> 23)
+static unsigned int bp_hash[BP_HASH_SIZE];
+static unsigned char bp_hash_used[BP_HASH_SIZE];
+static unsigned int nr_hashed_breakpoints = 0;
+
+// gdb Z2/Z3/Z4 watchpoints, matched on physical addresses by the memory
+// subsystem through bx_gdbstub_check_watch()
+#define MAX_WATCHPOINTS (16)
+static struct
+{
+    Bit32u laddr;
+    Bit32u paddr;
+    unsigned len;
+    int type; // 2 = write, 3 = read, 4 = access
+    bx_bool mapped; // laddr has a translation, paddr is valid
+} watchpoints[MAX_WATCHPOINTS];
+unsigned bx_gdbstub_nr_watchpoints = 0;
+static int watch_hit = -1;
+static bx_bool watch_remap = 0;
+static void remap_watchpoints(void);
+
+#define GDBSTUB_TRACE_OFF (0)
+#define GDBSTUB_TRACE_STEP (1)
+#define GDBSTUB_TRACE_RANGE (2) // vCont;r: step while range_start <= eip < range_end
+static int stub_trace_flag = GDBSTUB_TRACE_OFF;
+static Bit32u range_start = 0;
+static Bit32u range_end = 0;
+
+#if !GDBSTUB_POLL_THREAD
 static int instr_count = 0;
+#endif
 
 static int saved_eip = 0;
 
+// Set when gdb sent something (normally ^C) while the guest is running.
+static volatile int break_requested = 0;
+
+#if GDBSTUB_POLL_THREAD
+// The poll thread is created on the first resume and then parked on
+// poll_cond while the guest is stopped.  poll_running is set while the
+// guest runs; poll_busy while the thread is in select() on the socket.
+static pthread_t poll_thread;
+static int poll_thread_active = 0;
+static int poll_wakeup[2] = {-1, -1};
+static pthread_mutex_t poll_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poll_cond = PTHREAD_COND_INITIALIZER;
+static int poll_running = 0;
+static int poll_busy = 0;
+
+static void *poll_thread_func(void *arg)
+{
+    fd_set fds;
+    int maxfd = (socket_fd > poll_wakeup[0]) ? socket_fd : poll_wakeup[0];
+    int ret;
+
+    pthread_mutex_lock(&poll_mutex);
+    while (1)
+    {
+        while (!poll_running)
+        {
+            if (poll_busy)
+            {
+                poll_busy = 0;
+                pthread_cond_broadcast(&poll_cond);
+            }
+            pthread_cond_wait(&poll_cond, &poll_mutex);
+        }
+        poll_busy = 1;
+        pthread_mutex_unlock(&poll_mutex);
+
+        FD_ZERO(&fds);
+        FD_SET(socket_fd, &fds);
+        FD_SET(poll_wakeup[0], &fds);
+        ret = select(maxfd + 1, &fds, NULL, NULL, NULL);
+
+        pthread_mutex_lock(&poll_mutex);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret > 0 && FD_ISSET(poll_wakeup[0], &fds))
+            continue; // stop_polling() drains the pipe
+        if (ret > 0 && FD_ISSET(socket_fd, &fds))
+        {
+            // the byte itself is consumed by bx_gdbstub_check()
+            break_requested = 1;
+        }
+        // don't select() again on a socket that stays readable (or
+        // broken) until the guest has been stopped and resumed
+        while (poll_running)
+            pthread_cond_wait(&poll_cond, &poll_mutex);
+    }
+    return (NULL);
+}
+#endif
+
+// Start watching the socket for a break request before handing the
+// CPU to the guest.
+static void start_polling(void)
+{
+    break_requested = 0;
+#if GDBSTUB_POLL_THREAD
+    if (!poll_thread_active)
+    {
+        if (pipe(poll_wakeup) < 0)
+        {
+            BX_PANIC(("gdbstub: could not create wakeup pipe"));
+            return;
+        }
+        fcntl(poll_wakeup[0], F_SETFL, fcntl(poll_wakeup[0], F_GETFL) | O_NONBLOCK);
+        if (pthread_create(&poll_thread, NULL, poll_thread_func, NULL) != 0)
+        {
+            BX_PANIC(("gdbstub: could not create socket poll thread"));
+            return;
+        }
+        pthread_detach(poll_thread);
+        poll_thread_active = 1;
+    }
+    pthread_mutex_lock(&poll_mutex);
+    poll_running = 1;
+    pthread_cond_broadcast(&poll_cond);
+    pthread_mutex_unlock(&poll_mutex);
+#endif
+}
+
+// Park the poll thread again.  Returns once it has left select(), so
+// that it can not see the commands gdb sends while the guest is stopped.
+static void stop_polling(void)
+{
+#if GDBSTUB_POLL_THREAD
+    char ch = 0;
+
+    if (!poll_thread_active)
+        return;
+    pthread_mutex_lock(&poll_mutex);
+    poll_running = 0;
+    pthread_cond_broadcast(&poll_cond);
+    if (poll_busy)
+    {
+        write(poll_wakeup[1], &ch, 1);
+        while (poll_busy)
+            pthread_cond_wait(&poll_cond, &poll_mutex);
+    }
+    pthread_mutex_unlock(&poll_mutex);
+    while (read(poll_wakeup[0], &ch, 1) == 1)
+        ;
+#endif
+}
+
+static int is_breakpoint(Bit32u addr)
+{
+    unsigned int h;
+
+    for (h = BP_HASH(addr); bp_hash_used[h]; h = (h + 1) & (BP_HASH_SIZE - 1))
+    {
+        if (bp_hash[h] == addr)
+        {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+static void rehash_breakpoints(void)
+{
+    unsigned int i, h;
+
+    memset(bp_hash_used, 0, sizeof(bp_hash_used));
+    nr_hashed_breakpoints = 0;
+    for (i = 0; i < nr_breakpoints; i++)
+    {
+        if (breakpoints[i] == 0 || is_breakpoint(breakpoints[i]))
+        {
+            continue;
+        }
+        for (h = BP_HASH(breakpoints[i]); bp_hash_used[h]; h = (h + 1) & (BP_HASH_SIZE - 1))
+            ;
+        bp_hash[h] = breakpoints[i];
+        bp_hash_used[h] = 1;
+        nr_hashed_breakpoints++;
+    }
+}
+
 int bx_gdbstub_check(unsigned int eip)
 {
-    unsigned int i;
     unsigned char ch;
-    long arg;
     int r;
+#if !GDBSTUB_POLL_THREAD
 #if defined(__CYGWIN__) || defined(__MINGW32__)
     fd_set fds;
     struct timeval tv = {0, 0};
+#else
+    long arg;
 #endif
 
     instr_count++;
@@ -253,27 +444,53 @@ int bx_gdbstub_check(unsigned int eip)
 #endif
         if (r == 1)
         {
-            BX_INFO(("Got byte %x", (unsigned int)ch));
-            last_stop_reason = GDBSTUB_USER_BREAK;
-            return (GDBSTUB_USER_BREAK);
+            break_requested = 1;
         }
     }
+#endif
+
+    if (watch_remap)
+    {
+        remap_watchpoints();
+    }
+
+    if (break_requested)
+    {
+#if GDBSTUB_POLL_THREAD
+        r = recv(socket_fd, &ch, 1, 0);
+        if (r != 1)
+        {
+            BX_PANIC(("gdbstub: connection to gdb lost"));
+        }
+#else
+        ch = 3;
+#endif
+        break_requested = 0;
+        BX_INFO(("Got byte %x", (unsigned int)ch));
+        last_stop_reason = GDBSTUB_USER_BREAK;
+        return (GDBSTUB_USER_BREAK);
+    }
+
+    if (watch_hit >= 0)
+    {
+        BX_INFO(("hit watchpoint at %x", watchpoints[watch_hit].laddr));
+        last_stop_reason = GDBSTUB_WATCHPOINT;
+        return (GDBSTUB_WATCHPOINT);
+    }
 
     // why is trace before breakpoints? does that mean it would never
     // hit a breakpoint during tracing?
-    if (stub_trace_flag == 1)
+    if (stub_trace_flag == GDBSTUB_TRACE_STEP ||
+        (stub_trace_flag == GDBSTUB_TRACE_RANGE && (eip < range_start || eip >= range_end)))
     {
         last_stop_reason = GDBSTUB_TRACE;
         return (GDBSTUB_TRACE);
     }
-    for (i = 0; i < nr_breakpoints; i++)
+    if (nr_hashed_breakpoints && is_breakpoint(eip))
     {
-        if (eip == breakpoints[i])
-        {
-            BX_INFO(("found breakpoint at %x", eip));
-            last_stop_reason = GDBSTUB_EXECUTION_BREAKPOINT;
-            return (GDBSTUB_EXECUTION_BREAKPOINT);
-        }
+        BX_INFO(("found breakpoint at %x", eip));
+        last_stop_reason = GDBSTUB_EXECUTION_BREAKPOINT;
+        return (GDBSTUB_EXECUTION_BREAKPOINT);
     }
     last_stop_reason = GDBSTUB_STOP_NO_REASON;
     return (GDBSTUB_STOP_NO_REASON);
@@ -294,6 +511,7 @@ static int remove_breakpoint(unsigned int addr, int len)
         {
             BX_INFO(("Removing breakpoint at %x", addr));
             breakpoints[i] = 0;
+            rehash_breakpoints();
             return (1);
         }
     }
@@ -315,6 +533,7 @@ static void insert_breakpoint(unsigned int addr)
             {
                 nr_breakpoints = i + 1;
             }
+            rehash_breakpoints();
             return;
         }
     }
@@ -330,6 +549,142 @@ static void do_pc_breakpoint(int insert, unsigned long long addr, int len)
             remove_breakpoint(addr + i, 1);
 }
 
+void bx_gdbstub_check_watch(Bit32u paddr, unsigned len, unsigned rw)
+{
+    for (unsigned i = 0; i < bx_gdbstub_nr_watchpoints; i++)
+    {
+        if (!watchpoints[i].mapped)
+        {
+            continue;
+        }
+        if (paddr < watchpoints[i].paddr + watchpoints[i].len && watchpoints[i].paddr < paddr + len)
+        {
+            if ((watchpoints[i].type == 2 && rw == BX_READ) || (watchpoints[i].type == 3 && rw != BX_READ))
+            {
+                continue;
+            }
+            if (watch_hit < 0)
+            {
+                watch_hit = i;
+            }
+            return;
+        }
+    }
+}
+
+// Refuse direct host access to pages holding a watchpoint, so that all
+// guest accesses to them go through readPhysicalPage/writePhysicalPage.
+bx_bool bx_gdbstub_watch_veto(Bit32u paddr, unsigned op)
+{
+    for (unsigned i = 0; i < bx_gdbstub_nr_watchpoints; i++)
+    {
+        if (watchpoints[i].mapped && (watchpoints[i].paddr >> 12) == (paddr >> 12) &&
+            (watchpoints[i].type != 2 || op != BX_READ))
+        {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+// Watchpoints are set on linear addresses but matched on physical ones.
+// A TLB flush or INVLPG means the guest may have remapped a watched page
+// (new CR3, copy on write), so the list is translated again before the
+// next instruction.
+void bx_gdbstub_paging_changed(void)
+{
+    watch_remap = 1;
+}
+
+static void remap_watchpoints(void)
+{
+    int saved_hit = watch_hit;
+    bx_bool moved = 0;
+    Bit32u paddr;
+    bx_bool valid;
+
+    watch_remap = 0;
+    for (unsigned i = 0; i < bx_gdbstub_nr_watchpoints; i++)
+    {
+        BX_CPU(0)->dbg_xlate_linear2phy(watchpoints[i].laddr, &paddr, &valid);
+        paddr = A20ADDR(paddr);
+        if (valid != watchpoints[i].mapped || (valid && paddr != watchpoints[i].paddr))
+        {
+            if (valid)
+            {
+                BX_DEBUG(("watchpoint at %x moved to phys %x", watchpoints[i].laddr, paddr));
+            }
+            else
+            {
+                BX_DEBUG(("watchpoint at %x is not mapped", watchpoints[i].laddr));
+            }
+            watchpoints[i].mapped = valid;
+            if (valid)
+            {
+                watchpoints[i].paddr = paddr;
+            }
+            moved = 1;
+        }
+    }
+    // the page table walk reads memory through readPhysicalPage()
+    watch_hit = saved_hit;
+    if (moved)
+    {
+        // drop direct host pointers to the newly watched pages
+        BX_CPU(0)->TLB_flush(1);
+    }
+}
+
+static int do_watchpoint(int insert, int type, Bit32u laddr, unsigned len)
+{
+    Bit32u paddr;
+    bx_bool valid;
+    unsigned i;
+
+    if (insert)
+    {
+        if (len == 0 || ((laddr & 0xfff) + len) > 4096 || bx_gdbstub_nr_watchpoints == MAX_WATCHPOINTS)
+        {
+            return (0);
+        }
+        BX_CPU(0)->dbg_xlate_linear2phy(laddr, &paddr, &valid);
+        if (!valid)
+        {
+            return (0);
+        }
+        BX_INFO(("setting watchpoint type %d at %x (phys %x) len %u", type, laddr, paddr, len));
+        watchpoints[bx_gdbstub_nr_watchpoints].laddr = laddr;
+        watchpoints[bx_gdbstub_nr_watchpoints].paddr = A20ADDR(paddr);
+        watchpoints[bx_gdbstub_nr_watchpoints].len = len;
+        watchpoints[bx_gdbstub_nr_watchpoints].type = type;
+        watchpoints[bx_gdbstub_nr_watchpoints].mapped = 1;
+        bx_gdbstub_nr_watchpoints++;
+    }
+    else
+    {
+        for (i = 0; i < bx_gdbstub_nr_watchpoints; i++)
+        {
+            if (watchpoints[i].laddr == laddr && watchpoints[i].len == len && watchpoints[i].type == type)
+            {
+                break;
+            }
+        }
+        if (i == bx_gdbstub_nr_watchpoints)
+        {
+            return (0);
+        }
+        BX_INFO(("removing watchpoint type %d at %x", type, laddr));
+        for (; i < bx_gdbstub_nr_watchpoints - 1; i++)
+        {
+            watchpoints[i] = watchpoints[i + 1];
+        }
+        bx_gdbstub_nr_watchpoints--;
+    }
+    // drop direct host pointers to the affected page
+    BX_CPU(0)->TLB_flush(1);
+    return (1);
+}
+
 static void do_breakpoint(int insert, char *buffer)
 {
     char *ebuf;
@@ -343,6 +698,18 @@ static void do_breakpoint(int insert, char *buffer)
         do_pc_breakpoint(insert, addr, len);
         put_reply("OK");
         break;
+    case 2:
+    case 3:
+    case 4:
+        if (do_watchpoint(insert, type, addr, len))
+        {
+            put_reply("OK");
+        }
+        else
+        {
+            put_reply("E01");
+        }
+        break;
     default:
         put_reply("");
         break;
@@ -391,6 +758,97 @@ static int access_linear(Bit64u laddress, unsigned len, unsigned int rw, Bit8u *
     return (valid);
 }
 
+static void run_guest(void)
+{
+    watch_hit = -1;
+    start_polling();
+    bx_cpu.cpu_loop(-1);
+    stop_polling();
+}
+
+static void stop_reply(int step)
+{
+    char buf[255];
+    static const char *watch_kind[] = {"watch", "rwatch", "awatch"};
+
+    BX_INFO(("stopped with %x", last_stop_reason));
+    if (last_stop_reason == GDBSTUB_WATCHPOINT && watch_hit >= 0)
+    {
+        sprintf(buf, "T%02x%s:%x;", SIGTRAP, watch_kind[watchpoints[watch_hit].type - 2],
+                watchpoints[watch_hit].laddr);
+        watch_hit = -1;
+        put_reply(buf);
+        return;
+    }
+    buf[0] = 'S';
+    if (last_stop_reason == GDBSTUB_EXECUTION_BREAKPOINT || last_stop_reason == GDBSTUB_TRACE)
+    {
+        write_signal(&buf[1], SIGTRAP);
+    }
+    else if (!step)
+    {
+        write_signal(&buf[1], 0);
+    }
+    else if (last_stop_reason == GDBSTUB_STOP_NO_REASON)
+    {
+        write_signal(&buf[1], SIGSEGV);
+    }
+    else
+    {
+        write_signal(&buf[1], SIGTRAP);
+    }
+    put_reply(buf);
+}
+
+// vCont;<action>[:thread][;<action>...] - there is only one thread, so
+// the first action applies.  Supports c, C, s, S and range stepping, r.
+static void do_vcont(char *buffer)
+{
+    char *p = buffer + 5;
+    char *ebuf;
+
+    if (*p == '?')
+    {
+        put_reply("vCont;c;C;s;S;r");
+        return;
+    }
+    if (*p != ';')
+    {
+        put_reply("");
+        return;
+    }
+    p++;
+    switch (*p)
+    {
+    case 'c':
+    case 'C':
+        stub_trace_flag = GDBSTUB_TRACE_OFF;
+        break;
+    case 's':
+    case 'S':
+        stub_trace_flag = GDBSTUB_TRACE_STEP;
+        break;
+    case 'r':
+        range_start = strtoul(p + 1, &ebuf, 16);
+        range_end = strtoul(ebuf + 1, &ebuf, 16);
+        BX_DEBUG(("range stepping %x-%x", range_start, range_end));
+        stub_trace_flag = GDBSTUB_TRACE_RANGE;
+        break;
+    default:
+        put_reply("E01");
+        return;
+    }
+    bx_cpu.ispanic = 0;
+    run_guest();
+    if (bx_cpu.ispanic)
+    {
+        last_stop_reason = GDBSTUB_EXECUTION_BREAKPOINT;
+    }
+    DEV_vga_refresh();
+    stop_reply(stub_trace_flag != GDBSTUB_TRACE_OFF);
+    stub_trace_flag = GDBSTUB_TRACE_OFF;
+}
+
 static void debug_loop(void)
 {
     char buffer[255];
@@ -408,7 +866,6 @@ static void debug_loop(void)
         switch (buffer[0])
         {
         case 'c': {
-            char buf[255];
             int new_eip;
 
             if (buffer[1] != 0)
@@ -427,9 +884,9 @@ static void debug_loop(void)
                 BX_CPU(0)->dword.eip = new_eip;
             }
 
-            stub_trace_flag = 0;
+            stub_trace_flag = GDBSTUB_TRACE_OFF;
             bx_cpu.ispanic = 0;
-            bx_cpu.cpu_loop(-1);
+            run_guest();
             if (bx_cpu.ispanic)
             {
                 last_stop_reason = GDBSTUB_EXECUTION_BREAKPOINT;
@@ -444,45 +901,30 @@ static void debug_loop(void)
                 BX_CPU_THIS_PTR dword.eip = saved_eip;
             }
 
-            BX_INFO(("stopped with %x", last_stop_reason));
-            buf[0] = 'S';
-            if (last_stop_reason == GDBSTUB_EXECUTION_BREAKPOINT || last_stop_reason == GDBSTUB_TRACE)
-            {
-                write_signal(&buf[1], SIGTRAP);
-            }
-            else
-            {
-                write_signal(&buf[1], 0);
-            }
-            put_reply(buf);
+            stop_reply(0);
             break;
         }
 
         case 's': {
-            char buf[255];
-
             BX_INFO(("stepping"));
-            stub_trace_flag = 1;
-            bx_cpu.cpu_loop(-1);
+            stub_trace_flag = GDBSTUB_TRACE_STEP;
+            run_guest();
             DEV_vga_refresh();
-            stub_trace_flag = 0;
-            BX_INFO(("stopped with %x", last_stop_reason));
-            buf[0] = 'S';
-            if (last_stop_reason == GDBSTUB_EXECUTION_BREAKPOINT || last_stop_reason == GDBSTUB_TRACE)
-            {
-                write_signal(&buf[1], SIGTRAP);
-            }
-            else if (last_stop_reason == GDBSTUB_STOP_NO_REASON)
+            stub_trace_flag = GDBSTUB_TRACE_OFF;
+            stop_reply(1);
+            break;
+        }
+
+        case 'v':
+            if (strncmp(buffer, "vCont", 5) == 0)
             {
-                write_signal(&buf[1], SIGSEGV);
+                do_vcont(buffer);
             }
             else
             {
-                write_signal(&buf[1], SIGTRAP);
+                put_reply("");
             }
-            put_reply(buf);
             break;
-        }
 
         case 'M': {
             Bit64u addr;
@@ -462,6 +462,7 @@ int n_atadevice_biosdetect_names = 3;
 char *atadevice_translation_names[] = { "none", "lba", "large", "rechs", "auto", NULL };
 int n_atadevice_translation_names = 5;
 char *clock_sync_names[] = { "none", "realtime", "slowdown", "both", NULL };
+const char *replay_mode_names[] = { "none", "record", "replay", NULL };
 int clock_sync_n_names=4;
 
 
@@ -938,9 +939,9 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
     Bit8u lowbit)
 : bx_param_num_c (id, name, description, BX_MIN_BIT64S, BX_MAX_BIT64S, *ptr_to_real_val)
 {
-  this->varsize = 16;
+  this->varsize = 64;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p64bit = ptr_to_real_val;
 }
 
@@ -953,9 +954,9 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
     Bit8u lowbit)
 : bx_param_num_c (id, name, description, BX_MIN_BIT64U, BX_MAX_BIT64U, *ptr_to_real_val)
 {
-  this->varsize = 16;
+  this->varsize = 64;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p64bit = (Bit64s*) ptr_to_real_val;
 }
 
@@ -968,9 +969,9 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
     Bit8u lowbit)
 : bx_param_num_c (id, name, description, BX_MIN_BIT32S, BX_MAX_BIT32S, *ptr_to_real_val)
 {
-  this->varsize = 16;
+  this->varsize = 32;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p32bit = ptr_to_real_val;
 }
 
@@ -985,7 +986,7 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
 {
   this->varsize = 32;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p32bit = (Bit32s*) ptr_to_real_val;
 }
 
@@ -1000,7 +1001,7 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
 {
   this->varsize = 16;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p16bit = ptr_to_real_val;
 }
 
@@ -1015,7 +1016,7 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
 {
   this->varsize = 16;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p16bit = (Bit16s*) ptr_to_real_val;
 }
 
@@ -1028,9 +1029,9 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
     Bit8u lowbit)
 : bx_param_num_c (id, name, description, BX_MIN_BIT8S, BX_MAX_BIT8S, *ptr_to_real_val)
 {
-  this->varsize = 16;
+  this->varsize = 8;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p8bit = ptr_to_real_val;
 }
 
@@ -1045,7 +1046,7 @@ bx_shadow_num_c::bx_shadow_num_c (bx_id id,
 {
   this->varsize = 8;
   this->lowbit = lowbit;
-  this->mask = (1 << (highbit - lowbit)) - 1;
+  this->mask = ((BX_CONST64(1) << (highbit - lowbit)) << 1) - 1;
   val.p8bit = (Bit8s*) ptr_to_real_val;
 }
 
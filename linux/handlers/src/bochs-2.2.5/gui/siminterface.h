@@ -151,6 +151,7 @@ typedef enum {
   BXP_OPTRAM4_ADDRESS,
   BXP_KBD_SERIAL_DELAY,
   BXP_KBD_PASTE_DELAY,
+  BXP_KBD_INJECT_PATH,
   BXP_KBD_TYPE,
   BXP_FLOPPYA_DEVTYPE,
   BXP_FLOPPYA_PATH,
@@ -326,19 +327,23 @@ typedef enum {
   BXP_ATA3_SLAVE_JOURNAL,
 #define BXP_ATAx_DEVICE_JOURNAL(i, s) (BXP_ATA0_MASTER_JOURNAL + (2*(i)) + (s))
 
-#define BXP_PARAMS_PER_SERIAL_PORT 3
+#define BXP_PARAMS_PER_SERIAL_PORT 4
   BXP_COM1_ENABLED,
   BXP_COM1_MODE,
   BXP_COM1_PATH,
+  BXP_COM1_FAST,
   BXP_COM2_ENABLED,
   BXP_COM2_MODE,
   BXP_COM2_PATH,
+  BXP_COM2_FAST,
   BXP_COM3_ENABLED,
   BXP_COM3_MODE,
   BXP_COM3_PATH,
+  BXP_COM3_FAST,
   BXP_COM4_ENABLED,
   BXP_COM4_MODE,
   BXP_COM4_PATH,
+  BXP_COM4_FAST,
 #define BXP_PARAMS_PER_USB_HUB 5
   BXP_USB1_ENABLED,
   BXP_USB1_PORT1,
@@ -356,6 +361,18 @@ typedef enum {
   BXP_CMOSIMAGE_ENABLED,
   BXP_CMOSIMAGE_PATH,
   BXP_CMOSIMAGE_RTC_INIT,
+  BXP_G2H_ENABLED,
+  BXP_G2H_DIR,
+  BXP_G2H_LOG,
+  BXP_PROFILE_ENABLED,
+  BXP_PROFILE_PERIOD,
+  BXP_PROFILE_FILE,
+  BXP_PROFILE_SYMBOLS,
+  BXP_STATS_ENABLED,
+  BXP_STATS_PERIOD,
+  BXP_STATS_FILE,
+  BXP_REPLAY_MODE,
+  BXP_REPLAY_FILE,
   BXP_CLOCK,
   BXP_CLOCK_TIME0,
   BXP_CLOCK_SYNC,
@@ -499,6 +516,8 @@ typedef enum {
   BXP_KBD_TIMER_PENDING,
   BXP_KBD_IRQ1_REQ,
   BXP_KBD_IRQ12_REQ,
+  // self-profiling counters, see stats.h
+  BXP_STATS,
 #if BX_DEBUGGER
   // in debugger, is the simulation running (continue command) or waiting.
   // This is only modified by debugger code, not by the user.
@@ -517,6 +536,8 @@ typedef enum {
    (bx_id)(BXP_COM1_MODE + (((x)-1)*BXP_PARAMS_PER_SERIAL_PORT))
 #define BXP_COMx_PATH(x) \
   (bx_id)(BXP_COM1_PATH + (((x)-1)*BXP_PARAMS_PER_SERIAL_PORT))
+#define BXP_COMx_FAST(x) \
+  (bx_id)(BXP_COM1_FAST + (((x)-1)*BXP_PARAMS_PER_SERIAL_PORT))
 
 // use x=1
 #define BXP_USBx_ENABLED(x) \
@@ -1299,6 +1320,11 @@ enum {
 #define BX_CLOCK_SYNC_BOTH     3
 #define BX_CLOCK_SYNC_LAST     3
 
+#define BX_REPLAY_MODE_NONE    0
+#define BX_REPLAY_MODE_RECORD  1
+#define BX_REPLAY_MODE_REPLAY  2
+#define BX_REPLAY_MODE_LAST    2
+
 #define BX_CLOCK_TIME0_LOCAL     1
 #define BX_CLOCK_TIME0_UTC       2
 
@@ -1327,6 +1353,7 @@ BOCHSAPI extern char *atadevice_translation_names[];
 BOCHSAPI extern int n_atadevice_translation_names;
 BOCHSAPI extern char *clock_sync_names[];
 BOCHSAPI extern int clock_sync_n_names;
+BOCHSAPI extern const char *replay_mode_names[];
 
 typedef struct {
   bx_param_enum_c *Odevtype;
@@ -1355,6 +1382,7 @@ typedef struct {
   bx_param_bool_c *Oenabled;
   bx_param_enum_c *Omode;
   bx_param_string_c *Odev;
+  bx_param_bool_c *Ofast;
 } bx_serial_options;
 
 typedef struct {
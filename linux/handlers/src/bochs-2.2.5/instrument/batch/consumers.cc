@@ -0,0 +1,142 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Consumers for the batched instrumentation.  They are selected with a
+// comma separated list in the BXBATCH environment variable:
+//
+//   count   number of records of every type per CPU
+//   pages   the physical pages written most often
+//
+// New consumers are added to the table at the end of this file.
+
+#include "bochs.h"
+
+#define LOG_THIS genlog->
+
+static const char *type_name[BX_IBATCH_NTYPES] = {
+  "fetch", "read", "write", "branch", "exception", "interrupt"
+};
+
+/////////////////////////////////////////////////////////////////////////
+// count
+
+static Bit64u counts[BX_SMP_PROCESSORS][BX_IBATCH_NTYPES];
+static Bit64u taken[BX_SMP_PROCESSORS];
+
+static void count_batch(unsigned cpu, const bx_ibatch_rec_t *rec, unsigned n)
+{
+  Bit64u *c = counts[cpu];
+  for (unsigned i=0; i<n; i++) {
+    c[rec[i].type]++;
+    if (rec[i].type == BX_IBATCH_BRANCH && rec[i].aux != BX_IBATCH_BR_NOT_TAKEN)
+      taken[cpu]++;
+  }
+}
+
+static void count_report(FILE *fp)
+{
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++) {
+    fprintf(fp, "ibatch: CPU %u:", cpu);
+    for (unsigned t=0; t<BX_IBATCH_NTYPES; t++)
+      fprintf(fp, " %s " FMT_LL "u", type_name[t], counts[cpu][t]);
+    fprintf(fp, " (" FMT_LL "u taken)\n", taken[cpu]);
+  }
+}
+
+static bx_ibatch_consumer_t count_consumer = {
+  "count", BX_IBATCH_ALL, count_batch, count_report, NULL
+};
+
+/////////////////////////////////////////////////////////////////////////
+// pages
+
+#define PAGES_TOP 10
+
+static Bit32u *page_writes = NULL;
+static Bit32u npages = 0;
+
+static void pages_batch(unsigned cpu, const bx_ibatch_rec_t *rec, unsigned n)
+{
+  for (unsigned i=0; i<n; i++) {
+    if (rec[i].type != BX_IBATCH_WRITE) continue;
+    Bit32u page = (Bit32u) (rec[i].phy >> 12);
+    if (page < npages) page_writes[page]++;
+  }
+}
+
+static void pages_report(FILE *fp)
+{
+  Bit32u top[PAGES_TOP];
+  unsigned ntop = 0, i, j;
+
+  // insertion into a short sorted list is all we need for the top ten
+  for (Bit32u page=0; page<npages; page++) {
+    if (page_writes[page] == 0) continue;
+    for (i=ntop; i>0 && page_writes[top[i-1]] < page_writes[page]; i--) {
+      if (i < PAGES_TOP) top[i] = top[i-1];
+    }
+    if (i < PAGES_TOP) {
+      top[i] = page;
+      if (ntop < PAGES_TOP) ntop++;
+    }
+  }
+  for (j=0; j<ntop; j++) {
+    fprintf(fp, "ibatch: page 0x%08x: %u writes\n", top[j] << 12, page_writes[top[j]]);
+  }
+}
+
+static bx_ibatch_consumer_t pages_consumer = {
+  "pages", BX_IBATCH_MASK(BX_IBATCH_WRITE), pages_batch, pages_report, NULL
+};
+
+/////////////////////////////////////////////////////////////////////////
+
+static struct {
+  const char *name;
+  bx_ibatch_consumer_t *consumer;
+} consumer_table[] = {
+  { "count", &count_consumer },
+  { "pages", &pages_consumer },
+  { NULL, NULL }
+};
+
+void bx_ibatch_init_consumers(const char *names)
+{
+  const char *p = names;
+
+  npages = bx_options.memory.Osize->get () * 256;
+  while (*p) {
+    size_t len = strcspn(p, ",");
+    unsigned n;
+    for (n=0; consumer_table[n].name != NULL; n++) {
+      if (strlen(consumer_table[n].name) == len &&
+          !strncmp(consumer_table[n].name, p, len)) break;
+    }
+    if (consumer_table[n].name == NULL) {
+      BX_ERROR(("ibatch: unknown consumer '%.*s'", (int) len, p));
+    } else {
+      if (consumer_table[n].consumer == &pages_consumer && page_writes == NULL) {
+        page_writes = new Bit32u[npages];
+        memset(page_writes, 0, npages * sizeof(Bit32u));
+      }
+      bx_ibatch_register(consumer_table[n].consumer);
+    }
+    p += len;
+    if (*p == ',') p++;
+  }
+}
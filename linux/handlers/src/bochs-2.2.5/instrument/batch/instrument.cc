@@ -0,0 +1,125 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Rings and consumer list of the batched instrumentation, see
+// instrument.h.
+
+#include "bochs.h"
+
+#define LOG_THIS genlog->
+
+Bit32u bx_ibatch_mask = 0;
+bx_ibatch_ring_t bx_ibatch_ring[BX_SMP_PROCESSORS];
+
+static bx_ibatch_consumer_t *consumers = NULL;
+static Bit32u registered_mask = 0;
+static bx_bool enabled = 1;
+static unsigned init_cpus = 0;
+
+void bx_ibatch_register(bx_ibatch_consumer_t *consumer)
+{
+  for (bx_ibatch_consumer_t *c = consumers; c != NULL; c = c->next) {
+    if (c == consumer) return;
+  }
+  consumer->next = consumers;
+  consumers = consumer;
+  registered_mask |= consumer->mask;
+  if (enabled) bx_ibatch_mask = registered_mask;
+  BX_INFO(("ibatch: consumer '%s' registered", consumer->name));
+}
+
+// Hand the records collected so far to every consumer that wants any of
+// their types, and start over.
+void bx_ibatch_flush(unsigned cpu)
+{
+  bx_ibatch_ring_t *ring = &bx_ibatch_ring[cpu];
+  Bit32u types = 0;
+  unsigned n, i;
+
+  if (ring->ptr == NULL) return;  // before bx_instr_init()
+  n = ring->ptr - ring->rec;
+  ring->ptr = ring->rec;
+  if (n == 0) return;
+  for (i=0; i<n; i++)
+    types |= BX_IBATCH_MASK(ring->rec[i].type);
+  for (bx_ibatch_consumer_t *c = consumers; c != NULL; c = c->next) {
+    if (c->mask & types) c->batch(cpu, ring->rec, n);
+  }
+}
+
+static void ibatch_flush_all(void)
+{
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++)
+    bx_ibatch_flush(cpu);
+}
+
+static void ibatch_report(void)
+{
+  for (bx_ibatch_consumer_t *c = consumers; c != NULL; c = c->next) {
+    if (c->report) c->report(stderr);
+  }
+}
+
+static void ibatch_exit(void)
+{
+  bx_ibatch_mask = 0;
+  ibatch_flush_all();
+  ibatch_report();
+}
+
+void bx_instr_init(unsigned cpu)
+{
+  if (init_cpus++ == 0) {
+    for (unsigned n=0; n<BX_SMP_PROCESSORS; n++) {
+      bx_ibatch_ring[n].ptr = bx_ibatch_ring[n].rec;
+      bx_ibatch_ring[n].end = bx_ibatch_ring[n].rec + BX_IBATCH_RECORDS;
+    }
+    const char *names = getenv("BXBATCH");
+    bx_ibatch_init_consumers(names ? names : "count");
+    atexit(ibatch_exit);
+  }
+}
+
+void bx_instr_shutdown(unsigned cpu)
+{
+  bx_ibatch_flush(cpu);
+}
+
+void bx_instr_reset(unsigned cpu)
+{
+  bx_ibatch_flush(cpu);
+}
+
+void bx_instr_start()
+{
+  enabled = 1;
+  bx_ibatch_mask = registered_mask;
+}
+
+void bx_instr_stop()
+{
+  enabled = 0;
+  bx_ibatch_mask = 0;
+  ibatch_flush_all();
+}
+
+void bx_instr_print()
+{
+  ibatch_flush_all();
+  ibatch_report();
+}
@@ -0,0 +1,271 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Batched instrumentation.
+//
+// The hooks on the hot paths (instruction fetch, linear memory accesses,
+// branches, interrupts and exceptions) do not call out of line.  If some
+// consumer has registered for the event, the hook stores a fixed size
+// record in the ring of its CPU; the consumers get the records in bulk
+// when the ring is full or flushed.  Events nobody registered for cost a
+// test of bx_ibatch_mask.  See instrumentation.txt.
+
+
+// possible types passed to BX_INSTR_TLB_CNTRL()
+#define BX_INSTR_MOV_CR3      10
+#define BX_INSTR_INVLPG       11
+#define BX_INSTR_TASKSWITCH   12
+
+// possible types passed to BX_INSTR_CACHE_CNTRL()
+#define BX_INSTR_INVD         20
+#define BX_INSTR_WBINVD       21
+
+#define BX_INSTR_IS_CALL  10
+#define BX_INSTR_IS_RET   11
+#define BX_INSTR_IS_IRET  12
+#define BX_INSTR_IS_JMP   13
+#define BX_INSTR_IS_INT   14
+
+#define BX_INSTR_PREFETCH_NTA 0
+#define BX_INSTR_PREFETCH_T0  1
+#define BX_INSTR_PREFETCH_T1  2
+#define BX_INSTR_PREFETCH_T2  3
+
+
+// record types, bit n of a consumer mask selects type n
+#define BX_IBATCH_FETCH       0   // addr = linear EIP, len = insn length
+#define BX_IBATCH_READ        1   // addr = linear, phy = physical address
+#define BX_IBATCH_WRITE       2
+#define BX_IBATCH_BRANCH      3   // aux = BX_IBATCH_BR_*, addr = target
+#define BX_IBATCH_EXCEPTION   4   // aux = vector
+#define BX_IBATCH_INTERRUPT   5   // aux = vector, len = 1 for hardware
+#define BX_IBATCH_NTYPES      6
+
+#define BX_IBATCH_MASK(type)  (1u << (type))
+#define BX_IBATCH_ALL         ((1u << BX_IBATCH_NTYPES) - 1)
+
+// branch kinds in BX_IBATCH_BRANCH records
+#define BX_IBATCH_BR_NOT_TAKEN  0
+#define BX_IBATCH_BR_TAKEN      1   // conditional near branch
+#define BX_IBATCH_BR_NEAR       2   // aux | what (BX_INSTR_IS_*) << 4
+#define BX_IBATCH_BR_FAR        3   // aux | what << 4, phy = new CS
+
+// records per CPU ring, the consumers see at most this many at once
+#define BX_IBATCH_RECORDS     4096
+
+typedef struct {
+  Bit8u  type;
+  Bit8u  len;
+  Bit16u aux;
+  Bit32u reserved;
+  Bit64u addr;
+  Bit64u phy;
+} bx_ibatch_rec_t;
+
+typedef struct bx_ibatch_consumer {
+  const char *name;
+  Bit32u mask;          // BX_IBATCH_MASK() of the wanted types
+  // Called with the records of one CPU in program order.  A batch may
+  // also hold records of types that only other consumers asked for.
+  void (*batch)(unsigned cpu, const bx_ibatch_rec_t *rec, unsigned n);
+  // at exit and on "instrument print", may be NULL
+  void (*report)(FILE *fp);
+  struct bx_ibatch_consumer *next;
+} bx_ibatch_consumer_t;
+
+typedef struct {
+  bx_ibatch_rec_t *ptr;
+  bx_ibatch_rec_t *end;
+  bx_ibatch_rec_t  rec[BX_IBATCH_RECORDS];
+} bx_ibatch_ring_t;
+
+extern Bit32u bx_ibatch_mask;   // OR of the masks while enabled, else 0
+extern bx_ibatch_ring_t bx_ibatch_ring[BX_SMP_PROCESSORS];
+
+void bx_ibatch_register(bx_ibatch_consumer_t *consumer);
+void bx_ibatch_flush(unsigned cpu);
+
+// the consumers of consumers.cc, selected with BXBATCH
+void bx_ibatch_init_consumers(const char *names);
+
+static BX_CPP_INLINE void bx_ibatch_put(unsigned cpu, unsigned type,
+    unsigned len, unsigned aux, Bit64u addr, Bit64u phy)
+{
+  bx_ibatch_ring_t *ring = &bx_ibatch_ring[cpu];
+  bx_ibatch_rec_t *r = ring->ptr;
+  r->type = type;
+  r->len  = len;
+  r->aux  = aux;
+  r->addr = addr;
+  r->phy  = phy;
+  if (++ring->ptr == ring->end) bx_ibatch_flush(cpu);
+}
+
+#define BX_IBATCH(type, cpu, len, aux, addr, phy) do { \
+  if (bx_ibatch_mask & BX_IBATCH_MASK(type)) \
+    bx_ibatch_put(cpu, type, len, aux, addr, phy); \
+} while (0)
+
+
+#if BX_INSTRUMENTATION
+
+class bxInstruction_c;
+
+void bx_instr_init(unsigned cpu);
+void bx_instr_shutdown(unsigned cpu);
+void bx_instr_reset(unsigned cpu);
+
+void bx_instr_start();
+void bx_instr_stop();
+void bx_instr_print();
+
+/* simulation init, shutdown, reset */
+#  define BX_INSTR_INIT(cpu_id)            bx_instr_init(cpu_id)
+#  define BX_INSTR_SHUTDOWN(cpu_id)        bx_instr_shutdown(cpu_id)
+#  define BX_INSTR_RESET(cpu_id)           bx_instr_reset(cpu_id)
+#  define BX_INSTR_HLT(cpu_id)
+#  define BX_INSTR_NEW_INSTRUCTION(cpu_id)
+
+/* called from command line debugger */
+#  define BX_INSTR_DEBUG_PROMPT()
+#  define BX_INSTR_START()                 bx_instr_start()
+#  define BX_INSTR_STOP()                  bx_instr_stop()
+#  define BX_INSTR_PRINT()                 bx_instr_print()
+
+/* branch resoultion */
+#  define BX_INSTR_CNEAR_BRANCH_TAKEN(cpu_id, new_eip) \
+     BX_IBATCH(BX_IBATCH_BRANCH, cpu_id, 0, BX_IBATCH_BR_TAKEN, new_eip, 0)
+#  define BX_INSTR_CNEAR_BRANCH_NOT_TAKEN(cpu_id) \
+     BX_IBATCH(BX_IBATCH_BRANCH, cpu_id, 0, BX_IBATCH_BR_NOT_TAKEN, 0, 0)
+#  define BX_INSTR_UCNEAR_BRANCH(cpu_id, what, new_eip) \
+     BX_IBATCH(BX_IBATCH_BRANCH, cpu_id, 0, BX_IBATCH_BR_NEAR | ((what) << 4), new_eip, 0)
+#  define BX_INSTR_FAR_BRANCH(cpu_id, what, new_cs, new_eip) \
+     BX_IBATCH(BX_IBATCH_BRANCH, cpu_id, 0, BX_IBATCH_BR_FAR | ((what) << 4), new_eip, new_cs)
+
+/* decoding completed */
+#  define BX_INSTR_OPCODE(cpu_id, opcode, len, is32, is64)
+#  define BX_INSTR_FETCH_DECODE_COMPLETED(cpu_id, i)
+
+/* prefix byte decoded */
+#  define BX_INSTR_PREFIX(cpu_id, prefix)
+
+/* exceptional case and interrupt */
+#  define BX_INSTR_EXCEPTION(cpu_id, vector) \
+     BX_IBATCH(BX_IBATCH_EXCEPTION, cpu_id, 0, vector, 0, 0)
+#  define BX_INSTR_INTERRUPT(cpu_id, vector) \
+     BX_IBATCH(BX_IBATCH_INTERRUPT, cpu_id, 0, vector, 0, 0)
+#  define BX_INSTR_HWINTERRUPT(cpu_id, vector, cs, eip) \
+     BX_IBATCH(BX_IBATCH_INTERRUPT, cpu_id, 1, vector, eip, cs)
+
+/* TLB/CACHE control instruction executed */
+#  define BX_INSTR_CACHE_CNTRL(cpu_id, what)
+#  define BX_INSTR_TLB_CNTRL(cpu_id, what, newval)
+#  define BX_INSTR_PREFETCH_HINT(cpu_id, what, seg, offset)
+
+/* execution */
+#  define BX_INSTR_BEFORE_EXECUTION(cpu_id, i) \
+     BX_IBATCH(BX_IBATCH_FETCH, cpu_id, (i)->ilen(), 0, BX_CPU(cpu_id)->get_linear_ip(), 0)
+#  define BX_INSTR_AFTER_EXECUTION(cpu_id, i)
+#  define BX_INSTR_REPEAT_ITERATION(cpu_id, i)
+
+/* memory access */
+#  define BX_INSTR_LIN_READ(cpu_id, lin, phy, len) \
+     BX_IBATCH(BX_IBATCH_READ, cpu_id, len, 0, lin, phy)
+#  define BX_INSTR_LIN_WRITE(cpu_id, lin, phy, len) \
+     BX_IBATCH(BX_IBATCH_WRITE, cpu_id, len, 0, lin, phy)
+
+#  define BX_INSTR_MEM_CODE(cpu_id, linear, size)
+#  define BX_INSTR_MEM_DATA(cpu_id, linear, size, rw)
+
+/* called from memory object */
+#  define BX_INSTR_PHY_WRITE(cpu_id, addr, len)
+#  define BX_INSTR_PHY_READ(cpu_id, addr, len)
+
+/* feedback from device units */
+#  define BX_INSTR_INP(addr, len)
+#  define BX_INSTR_INP2(addr, len, val)
+#  define BX_INSTR_OUTP(addr, len)
+#  define BX_INSTR_OUTP2(addr, len, val)
+
+/* wrmsr callback */
+#  define BX_INSTR_WRMSR(cpu_id, addr, value)
+
+#else
+
+/* simulation init, shutdown, reset */
+#  define BX_INSTR_INIT(cpu_id)
+#  define BX_INSTR_SHUTDOWN(cpu_id)
+#  define BX_INSTR_RESET(cpu_id)
+#  define BX_INSTR_HLT(cpu_id)
+#  define BX_INSTR_NEW_INSTRUCTION(cpu_id)
+
+/* called from command line debugger */
+#  define BX_INSTR_DEBUG_PROMPT()
+#  define BX_INSTR_START()
+#  define BX_INSTR_STOP()
+#  define BX_INSTR_PRINT()
+
+/* branch resoultion */
+#  define BX_INSTR_CNEAR_BRANCH_TAKEN(cpu_id, new_eip)
+#  define BX_INSTR_CNEAR_BRANCH_NOT_TAKEN(cpu_id)
+#  define BX_INSTR_UCNEAR_BRANCH(cpu_id, what, new_eip)
+#  define BX_INSTR_FAR_BRANCH(cpu_id, what, new_cs, new_eip)
+
+/* decoding completed */
+#  define BX_INSTR_OPCODE(cpu_id, opcode, len, is32, is64)
+#  define BX_INSTR_FETCH_DECODE_COMPLETED(cpu_id, i)
+
+/* prefix byte decoded */
+#  define BX_INSTR_PREFIX(cpu_id, prefix)
+
+/* exceptional case and interrupt */
+#  define BX_INSTR_EXCEPTION(cpu_id, vector)
+#  define BX_INSTR_INTERRUPT(cpu_id, vector)
+#  define BX_INSTR_HWINTERRUPT(cpu_id, vector, cs, eip)
+
+/* TLB/CACHE control instruction executed */
+#  define BX_INSTR_CACHE_CNTRL(cpu_id, what)
+#  define BX_INSTR_TLB_CNTRL(cpu_id, what, newval)
+#  define BX_INSTR_PREFETCH_HINT(cpu_id, what, seg, offset)
+
+/* execution */
+#  define BX_INSTR_BEFORE_EXECUTION(cpu_id, i)
+#  define BX_INSTR_AFTER_EXECUTION(cpu_id, i)
+#  define BX_INSTR_REPEAT_ITERATION(cpu_id, i)
+
+/* memory access */
+#  define BX_INSTR_LIN_READ(cpu_id, lin, phy, len)
+#  define BX_INSTR_LIN_WRITE(cpu_id, lin, phy, len)
+
+#  define BX_INSTR_MEM_CODE(cpu_id, linear, size)
+#  define BX_INSTR_MEM_DATA(cpu_id, linear, size, rw)
+
+/* called from memory object */
+#  define BX_INSTR_PHY_WRITE(cpu_id, addr, len)
+#  define BX_INSTR_PHY_READ(cpu_id, addr, len)
+
+/* feedback from device units */
+#  define BX_INSTR_INP(addr, len)
+#  define BX_INSTR_INP2(addr, len, val)
+#  define BX_INSTR_OUTP(addr, len)
+#  define BX_INSTR_OUTP2(addr, len, val)
+
+/* wrmsr callback */
+#  define BX_INSTR_WRMSR(cpu_id, addr, value)
+
+#endif
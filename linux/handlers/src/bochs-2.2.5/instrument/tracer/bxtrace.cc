@@ -0,0 +1,254 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// bxtrace: offline decoder for traces written by the tracer
+// instrumentation library.
+//
+//   bxtrace [-c cpu] [-m mapfile] [-s] [-q] tracefile
+//
+//     -c cpu   only decode the chunks of this CPU
+//     -m map   name instruction addresses with the symbols of a
+//              System.map or nm output
+//     -s       print a summary after decoding
+//     -q       do not print records (use with -s)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "osdep.h"
+#include "bxtrace.h"
+#include "symbols.h"
+
+static const char *branch_name[] = {
+  "not-taken", "taken", "call", "ret", "iret", "jmp", "int", "?"
+};
+
+static const char *event_name[] = {
+  "interrupt", "exception", "hwinterrupt", "cr3", "reset"
+};
+
+static struct {
+  Bit64u chunks, bytes, insns, reads, writes, branches, events;
+} stats;
+
+static bx_symbol_table_c *symbols = NULL;
+
+static int get_varint(const Bit8u **pp, const Bit8u *end, Bit64u *val)
+{
+  const Bit8u *p = *pp;
+  Bit64u v = 0;
+  unsigned shift = 0;
+
+  while (p < end && shift < 64) {
+    Bit8u b = *p++;
+    v |= (Bit64u)(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      *pp = p;
+      *val = v;
+      return 1;
+    }
+    shift += 7;
+  }
+  return 0;
+}
+
+static int decode_chunk(const bx_trace_chunk_header_t *hdr, const Bit8u *p, int quiet)
+{
+  const Bit8u *end = p + hdr->length;
+  Bit64u insn = hdr->first_insn;
+  bx_trace_state_t s;
+  Bit64u v;
+
+  s.next_eip = 0;
+  s.last_laddr = 0;
+  s.map_lpf = ~(Bit64u) 0;
+  s.map_ppf = 0;
+
+  if (!quiet)
+    printf("# chunk cpu %u, first insn " FMT_LL "u, ticks " FMT_LL "u\n",
+      hdr->cpu, hdr->first_insn, hdr->ticks);
+
+  while (p < end) {
+    Bit8u tag = *p++;
+    switch (tag & 7) {
+      case BX_TRACE_REC_INSN:
+        {
+          unsigned len = tag >> 4;
+          Bit64u eip = s.next_eip;
+          if (tag & BX_TRACE_INSN_DELTA) {
+            if (!get_varint(&p, end, &v)) return 0;
+            eip += BX_TRACE_UNZIGZAG(v);
+          }
+          if (len == 0) len = 16;
+          if (!quiet) {
+            Bit32u offset;
+            const char *sym = symbols ? symbols->lookup((Bit32u) eip, &offset) : NULL;
+            if (sym)
+              printf("%u " FMT_LL "u " FMT_LL "x len %u %s+%x\n", hdr->cpu, insn, eip, len,
+                sym, offset);
+            else
+              printf("%u " FMT_LL "u " FMT_LL "x len %u\n", hdr->cpu, insn, eip, len);
+          }
+          s.next_eip = eip + len;
+          insn++;
+          stats.insns++;
+        }
+        break;
+      case BX_TRACE_REC_READ:
+      case BX_TRACE_REC_WRITE:
+        {
+          unsigned len = ((tag >> 3) & 0xf) + 1;
+          Bit64u laddr, paddr;
+          if (!get_varint(&p, end, &v)) return 0;
+          laddr = s.last_laddr + BX_TRACE_UNZIGZAG(v);
+          s.last_laddr = laddr;
+          if (tag & BX_TRACE_MEM_PPF) {
+            if (!get_varint(&p, end, &v)) return 0;
+            s.map_lpf = laddr & ~(Bit64u) 0xfff;
+            s.map_ppf = v << 12;
+          }
+          if ((laddr & ~(Bit64u) 0xfff) == s.map_lpf)
+            paddr = s.map_ppf | (laddr & 0xfff);
+          else
+            paddr = laddr;
+          if (!quiet)
+            printf("    %s " FMT_LL "x -> " FMT_LL "x len %u\n",
+              (tag & 7) == BX_TRACE_REC_READ ? "rd" : "wr", laddr, paddr, len);
+          if ((tag & 7) == BX_TRACE_REC_READ) stats.reads++;
+          else stats.writes++;
+        }
+        break;
+      case BX_TRACE_REC_BRANCH:
+        {
+          unsigned kind = tag >> 3;
+          if (kind & BX_TRACE_BR_FAR) {
+            if (!get_varint(&p, end, &v)) return 0;
+            if (!quiet)
+              printf("    far %s cs %04x\n", branch_name[kind & 7], (unsigned) v);
+          }
+          else if (!quiet) {
+            printf("    %s\n", branch_name[kind & 7]);
+          }
+          stats.branches++;
+        }
+        break;
+      case BX_TRACE_REC_EVENT:
+        {
+          unsigned kind = tag >> 3;
+          if (!get_varint(&p, end, &v)) return 0;
+          if (!quiet) {
+            printf("    %s " FMT_LL "x\n",
+              kind <= BX_TRACE_EV_RESET ? event_name[kind] : "?", v);
+          }
+          stats.events++;
+        }
+        break;
+      default:
+        return 0;
+    }
+  }
+  return 1;
+}
+
+static void usage(void)
+{
+  fprintf(stderr, "usage: bxtrace [-c cpu] [-m mapfile] [-s] [-q] tracefile\n");
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *fname = NULL, *mapfile = NULL;
+  int cpu = -1, summary = 0, quiet = 0;
+
+  for (int n=1; n<argc; n++) {
+    if (!strcmp(argv[n], "-c") && n+1 < argc) cpu = atoi(argv[++n]);
+    else if (!strcmp(argv[n], "-m") && n+1 < argc) mapfile = argv[++n];
+    else if (!strcmp(argv[n], "-s")) summary = 1;
+    else if (!strcmp(argv[n], "-q")) quiet = 1;
+    else if (argv[n][0] == '-' || fname != NULL) usage();
+    else fname = argv[n];
+  }
+  if (fname == NULL) usage();
+
+  if (mapfile != NULL) {
+    symbols = bx_symbol_context(0, 1);
+    if (symbols->load(mapfile, 0) < 0) {
+      perror(mapfile);
+      return 1;
+    }
+  }
+
+  FILE *fp = fopen(fname, "rb");
+  if (fp == NULL) {
+    perror(fname);
+    return 1;
+  }
+
+  bx_trace_file_header_t fhdr;
+  if (fread(&fhdr, sizeof(fhdr), 1, fp) != 1 ||
+      memcmp(fhdr.magic, BX_TRACE_MAGIC, sizeof(fhdr.magic)) || fhdr.version != 1)
+  {
+    fprintf(stderr, "%s: not a bochs trace file\n", fname);
+    return 1;
+  }
+
+  bx_trace_chunk_header_t hdr;
+  Bit8u *data = NULL;
+  Bit32u datasize = 0;
+
+  while (fread(&hdr, sizeof(hdr), 1, fp) == 1) {
+    if (hdr.magic != BX_TRACE_CHUNK_MAGIC || hdr.cpu >= fhdr.ncpus) {
+      fprintf(stderr, "%s: bad chunk header at offset %ld\n", fname,
+        ftell(fp) - (long) sizeof(hdr));
+      return 1;
+    }
+    if (hdr.length > datasize) {
+      datasize = hdr.length;
+      data = (Bit8u *) realloc(data, datasize);
+    }
+    if (fread(data, 1, hdr.length, fp) != hdr.length) {
+      // bochs was killed while the writer was busy; keep what we have
+      fprintf(stderr, "%s: last chunk is truncated, ignored\n", fname);
+      break;
+    }
+    if (cpu >= 0 && hdr.cpu != (Bit32u) cpu) continue;
+    stats.chunks++;
+    stats.bytes += sizeof(hdr) + hdr.length;
+    if (!decode_chunk(&hdr, data, quiet)) {
+      fprintf(stderr, "%s: corrupt record in chunk of cpu %u\n", fname, hdr.cpu);
+      return 1;
+    }
+  }
+
+  if (summary) {
+    printf("chunks       " FMT_LL "u\n", stats.chunks);
+    printf("instructions " FMT_LL "u\n", stats.insns);
+    printf("reads        " FMT_LL "u\n", stats.reads);
+    printf("writes       " FMT_LL "u\n", stats.writes);
+    printf("branches     " FMT_LL "u\n", stats.branches);
+    printf("events       " FMT_LL "u\n", stats.events);
+    printf("bytes        " FMT_LL "u (%.2f per instruction)\n", stats.bytes,
+      stats.insns ? (double) stats.bytes / stats.insns : 0.0);
+  }
+
+  free(data);
+  fclose(fp);
+  return 0;
+}
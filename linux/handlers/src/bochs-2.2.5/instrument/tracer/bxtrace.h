@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Binary execution trace format, shared by the recorder (instrument.cc)
+// and the offline decoder (bxtrace.cc).
+//
+// A trace file starts with a bx_trace_file_header_t followed by any
+// number of chunks.  Every chunk holds the records of one CPU and starts
+// with a bx_trace_chunk_header_t.  The delta encoder state is reset at
+// the start of every chunk, so each chunk can be decoded on its own and
+// chunks of different CPUs may be interleaved freely in the file.
+//
+// Headers are written in host byte order.  Records are a tag byte,
+// optionally followed by unsigned LEB128 varints; signed deltas are
+// zigzag encoded before they are written as varints.
+//
+//   tag bits 2..0  record type (BX_TRACE_REC_*)
+//
+//   INSN     bits 7..4 instruction length (0 means 16)
+//            bit 3     an EIP delta follows.  Without it the instruction
+//                      starts where the previous one ended.
+//            [varint zigzag(eip - predicted eip)]
+//
+//   READ,    bits 6..3 access length - 1
+//   WRITE    bit 7     a physical page frame follows.  Without it the
+//                      physical address is predicted from the last page
+//                      mapping seen in this chunk if the linear page
+//                      matches, or else equals the linear address.
+//            varint zigzag(laddr - previous laddr)
+//            [varint ppf >> 12]
+//
+//   BRANCH   bits 7..3 branch kind (BX_TRACE_BR_*).  The target is the
+//                      EIP of the next INSN record.
+//            [varint new cs]   far branches only
+//
+//   EVENT    bits 7..3 event kind (BX_TRACE_EV_*)
+//            varint value      vector for interrupts and exceptions,
+//                              new CR3 for BX_TRACE_EV_CR3
+
+#ifndef BX_INSTRUMENT_BXTRACE_H
+#define BX_INSTRUMENT_BXTRACE_H
+
+#define BX_TRACE_MAGIC          "BXTRACE1"
+#define BX_TRACE_CHUNK_MAGIC    0x43545842   // "BXTC"
+
+#define BX_TRACE_REC_INSN       0
+#define BX_TRACE_REC_READ       1
+#define BX_TRACE_REC_WRITE      2
+#define BX_TRACE_REC_BRANCH     3
+#define BX_TRACE_REC_EVENT      4
+
+#define BX_TRACE_INSN_DELTA     0x08
+#define BX_TRACE_MEM_PPF        0x80
+
+#define BX_TRACE_BR_NOT_TAKEN   0
+#define BX_TRACE_BR_TAKEN       1
+#define BX_TRACE_BR_CALL        2
+#define BX_TRACE_BR_RET         3
+#define BX_TRACE_BR_IRET        4
+#define BX_TRACE_BR_JMP         5
+#define BX_TRACE_BR_INT         6
+#define BX_TRACE_BR_FAR         8    // OR'ed with one of CALL .. INT
+
+#define BX_TRACE_EV_INTERRUPT   0
+#define BX_TRACE_EV_EXCEPTION   1
+#define BX_TRACE_EV_HWINTERRUPT 2
+#define BX_TRACE_EV_CR3         3
+#define BX_TRACE_EV_RESET       4
+
+// longest record: tag byte plus two 64 bit varints
+#define BX_TRACE_MAX_RECORD     21
+
+typedef struct {
+  char   magic[8];        // BX_TRACE_MAGIC
+  Bit32u version;         // 1
+  Bit32u ncpus;
+} bx_trace_file_header_t;
+
+typedef struct {
+  Bit32u magic;           // BX_TRACE_CHUNK_MAGIC
+  Bit32u cpu;
+  Bit32u length;          // bytes of record data after this header
+  Bit32u ninsns;          // INSN records in this chunk
+  Bit64u first_insn;      // per CPU index of the first INSN record
+  Bit64u ticks;           // system ticks when the chunk was started
+} bx_trace_chunk_header_t;
+
+// Delta encoder/decoder state, reset at every chunk boundary.
+typedef struct {
+  Bit64u next_eip;
+  Bit64u last_laddr;
+  Bit64u map_lpf;
+  Bit64u map_ppf;
+} bx_trace_state_t;
+
+#define BX_TRACE_ZIGZAG(d)   (((Bit64u)(d) << 1) ^ (Bit64u)((Bit64s)(d) >> 63))
+#define BX_TRACE_UNZIGZAG(v) ((Bit64s)((v) >> 1) ^ -(Bit64s)((v) & 1))
+
+#endif // BX_INSTRUMENT_BXTRACE_H
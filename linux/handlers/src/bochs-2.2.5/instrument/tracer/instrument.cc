@@ -0,0 +1,404 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Binary execution trace recorder.
+//
+// Every CPU appends records to its own buffer without any locking.  A
+// full buffer is handed to a writer thread, which writes it to the trace
+// file as one chunk and gives it back to the CPU it came from.  Each CPU
+// owns BX_TRACE_NBUFS buffers; if the disk cannot keep up and all of them
+// are queued, the CPU waits for the writer instead of dropping records.
+
+#include "bochs.h"
+#include "bxtrace.h"
+
+#if !defined(WIN32)
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#define LOG_THIS genlog->
+
+#define BX_TRACE_BUFSIZE  (1024 * 1024)
+#define BX_TRACE_NBUFS    4
+
+typedef struct bx_trace_buf {
+  bx_trace_chunk_header_t hdr;
+  struct bx_trace_buf *next;
+  Bit8u data[BX_TRACE_BUFSIZE];
+} bx_trace_buf_t;
+
+typedef struct {
+  bx_bool active;
+  bx_trace_buf_t *buf;        // buffer being filled
+  Bit8u *ptr;                 // next free byte in buf
+  Bit8u *limit;               // last position a record may start at
+  bx_trace_state_t state;
+  Bit64u insns;               // INSN records emitted so far
+  bx_trace_buf_t *free_list;  // protected by trace_lock
+} bx_trace_cpu_t;
+
+static bx_trace_cpu_t tcpu[BX_SMP_PROCESSORS];
+
+static FILE *trace_file = NULL;
+static unsigned trace_cpus = 0;
+
+#if !defined(WIN32)
+static pthread_t       writer_thread;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  full_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  free_cond = PTHREAD_COND_INITIALIZER;
+static bx_trace_buf_t *full_head = NULL, *full_tail = NULL;
+static bx_bool writer_active = 0;
+static bx_bool writer_quit = 0;
+#endif
+
+static void write_chunk(bx_trace_buf_t *buf)
+{
+  if (buf->hdr.length == 0) return;
+  if (fwrite(&buf->hdr, sizeof(buf->hdr), 1, trace_file) != 1 ||
+      fwrite(buf->data, buf->hdr.length, 1, trace_file) != 1)
+  {
+    BX_ERROR(("bxtrace: write error, trace file is incomplete"));
+  }
+}
+
+#if !defined(WIN32)
+static void *trace_writer(void *arg)
+{
+  // leave SIGINT and friends to the simulator thread
+  sigset_t mask;
+  sigfillset(&mask);
+  pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+  pthread_mutex_lock(&trace_lock);
+  for (;;) {
+    while (full_head == NULL && !writer_quit)
+      pthread_cond_wait(&full_cond, &trace_lock);
+    if (full_head == NULL) break;
+    bx_trace_buf_t *buf = full_head;
+    full_head = buf->next;
+    if (full_head == NULL) full_tail = NULL;
+    pthread_mutex_unlock(&trace_lock);
+
+    write_chunk(buf);
+
+    pthread_mutex_lock(&trace_lock);
+    bx_trace_cpu_t *t = &tcpu[buf->hdr.cpu];
+    buf->next = t->free_list;
+    t->free_list = buf;
+    pthread_cond_broadcast(&free_cond);
+  }
+  pthread_mutex_unlock(&trace_lock);
+  return NULL;
+}
+#endif
+
+// Pass the buffer being filled to the writer and start a new chunk.
+static void switch_buffer(unsigned cpu, bx_bool final)
+{
+  bx_trace_cpu_t *t = &tcpu[cpu];
+  bx_trace_buf_t *buf = t->buf;
+
+  if (buf != NULL) {
+    buf->hdr.length = t->ptr - buf->data;
+    buf->hdr.ninsns = (Bit32u)(t->insns - buf->hdr.first_insn);
+    buf->next = NULL;
+#if !defined(WIN32)
+    if (writer_active) {
+      pthread_mutex_lock(&trace_lock);
+      if (full_tail) full_tail->next = buf;
+      else full_head = buf;
+      full_tail = buf;
+      pthread_cond_signal(&full_cond);
+      pthread_mutex_unlock(&trace_lock);
+    }
+    else
+#endif
+    {
+      write_chunk(buf);
+      buf->next = t->free_list;
+      t->free_list = buf;
+    }
+    t->buf = NULL;
+  }
+
+  if (final) {
+    t->ptr = t->limit = NULL;
+    return;
+  }
+
+#if !defined(WIN32)
+  pthread_mutex_lock(&trace_lock);
+  while (t->free_list == NULL)
+    pthread_cond_wait(&free_cond, &trace_lock);
+#endif
+  buf = t->free_list;
+  t->free_list = buf->next;
+#if !defined(WIN32)
+  pthread_mutex_unlock(&trace_lock);
+#endif
+
+  buf->hdr.magic = BX_TRACE_CHUNK_MAGIC;
+  buf->hdr.cpu = cpu;
+  buf->hdr.length = 0;
+  buf->hdr.ninsns = 0;
+  buf->hdr.first_insn = t->insns;
+  buf->hdr.ticks = bx_pc_system.time_ticks();
+  t->buf = buf;
+  t->ptr = buf->data;
+  t->limit = buf->data + BX_TRACE_BUFSIZE - BX_TRACE_MAX_RECORD;
+  t->state.next_eip = 0;
+  t->state.last_laddr = 0;
+  t->state.map_lpf = ~(Bit64u) 0;
+  t->state.map_ppf = 0;
+}
+
+static void trace_close(void)
+{
+  if (trace_file == NULL) return;
+
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++) {
+    if (tcpu[cpu].buf) switch_buffer(cpu, 1);
+  }
+#if !defined(WIN32)
+  if (writer_active) {
+    pthread_mutex_lock(&trace_lock);
+    writer_quit = 1;
+    pthread_cond_signal(&full_cond);
+    pthread_mutex_unlock(&trace_lock);
+    pthread_join(writer_thread, NULL);
+    writer_active = 0;
+  }
+#endif
+  fclose(trace_file);
+  trace_file = NULL;
+}
+
+static BX_CPP_INLINE Bit8u *put_varint(Bit8u *p, Bit64u v)
+{
+  while (v >= 0x80) {
+    *p++ = (Bit8u)(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (Bit8u) v;
+  return p;
+}
+
+// Returns where the next record of this CPU goes, or NULL when the CPU
+// is not being traced.
+static BX_CPP_INLINE Bit8u *record_start(unsigned cpu)
+{
+  bx_trace_cpu_t *t = &tcpu[cpu];
+  if (!t->active) return NULL;
+  if (t->ptr > t->limit) switch_buffer(cpu, 0);
+  return t->ptr;
+}
+
+static void trace_branch(unsigned cpu, unsigned kind)
+{
+  Bit8u *p = record_start(cpu);
+  if (p == NULL) return;
+  *p++ = BX_TRACE_REC_BRANCH | (kind << 3);
+  tcpu[cpu].ptr = p;
+}
+
+static void trace_event(unsigned cpu, unsigned kind, Bit64u value)
+{
+  Bit8u *p = record_start(cpu);
+  if (p == NULL) return;
+  *p++ = BX_TRACE_REC_EVENT | (kind << 3);
+  tcpu[cpu].ptr = put_varint(p, value);
+}
+
+static void trace_mem(unsigned cpu, unsigned type, bx_address lin, bx_address phy, unsigned len)
+{
+  Bit8u *p = record_start(cpu);
+  if (p == NULL) return;
+
+  bx_trace_state_t *s = &tcpu[cpu].state;
+  Bit64u lpf = (Bit64u) lin & ~(Bit64u) 0xfff;
+  Bit64u predicted = (lpf == s->map_lpf) ? (s->map_ppf | (lin & 0xfff)) : (Bit64u) lin;
+  Bit8u tag = type | (((len - 1) & 0xf) << 3);
+  bx_bool new_ppf = ((Bit64u) phy != predicted);
+
+  if (new_ppf) tag |= BX_TRACE_MEM_PPF;
+  *p++ = tag;
+  p = put_varint(p, BX_TRACE_ZIGZAG((Bit64u) lin - s->last_laddr));
+  s->last_laddr = lin;
+  if (new_ppf) {
+    s->map_lpf = lpf;
+    s->map_ppf = (Bit64u) phy & ~(Bit64u) 0xfff;
+    p = put_varint(p, s->map_ppf >> 12);
+  }
+  tcpu[cpu].ptr = p;
+}
+
+void bx_instr_init(unsigned cpu)
+{
+  if (trace_cpus++ == 0) {
+    const char *fname = getenv("BXTRACE_FILE");
+    if (fname == NULL) fname = "bxtrace.out";
+    trace_file = fopen(fname, "wb");
+    if (trace_file == NULL) {
+      BX_PANIC(("bxtrace: can not open trace file '%s'", fname));
+      return;
+    }
+    bx_trace_file_header_t hdr;
+    memcpy(hdr.magic, BX_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = 1;
+    hdr.ncpus = BX_SMP_PROCESSORS;
+    fwrite(&hdr, sizeof(hdr), 1, trace_file);
+#if !defined(WIN32)
+    writer_quit = 0;
+    writer_active = (pthread_create(&writer_thread, NULL, trace_writer, NULL) == 0);
+#endif
+    atexit(trace_close);
+    BX_INFO(("bxtrace: writing execution trace to '%s'", fname));
+  }
+
+  bx_trace_cpu_t *t = &tcpu[cpu];
+  if (trace_file == NULL || t->buf != NULL) return;
+  for (unsigned n=0; n<BX_TRACE_NBUFS; n++) {
+    bx_trace_buf_t *buf = new bx_trace_buf_t;
+    buf->next = t->free_list;
+    t->free_list = buf;
+  }
+  t->insns = 0;
+  switch_buffer(cpu, 0);
+  t->active = 1;
+}
+
+void bx_instr_shutdown(unsigned cpu)
+{
+  if (tcpu[cpu].buf) switch_buffer(cpu, 1);
+  tcpu[cpu].active = 0;
+  if (trace_cpus > 0 && --trace_cpus == 0) trace_close();
+}
+
+void bx_instr_reset(unsigned cpu)
+{
+  trace_event(cpu, BX_TRACE_EV_RESET, 0);
+}
+
+void bx_instr_start()
+{
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++)
+    if (tcpu[cpu].buf) tcpu[cpu].active = 1;
+}
+
+void bx_instr_stop()
+{
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++)
+    tcpu[cpu].active = 0;
+}
+
+void bx_instr_print()
+{
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++) {
+    fprintf(stderr, "bxtrace: CPU %u: %s, " FMT_LL "u instructions recorded\n",
+      cpu, tcpu[cpu].active ? "active" : "stopped", tcpu[cpu].insns);
+  }
+}
+
+void bx_instr_cnear_branch_taken(unsigned cpu, bx_address new_eip)
+{
+  trace_branch(cpu, BX_TRACE_BR_TAKEN);
+}
+
+void bx_instr_cnear_branch_not_taken(unsigned cpu)
+{
+  trace_branch(cpu, BX_TRACE_BR_NOT_TAKEN);
+}
+
+static unsigned branch_kind(unsigned what)
+{
+  switch (what) {
+    case BX_INSTR_IS_CALL: return BX_TRACE_BR_CALL;
+    case BX_INSTR_IS_RET:  return BX_TRACE_BR_RET;
+    case BX_INSTR_IS_IRET: return BX_TRACE_BR_IRET;
+    case BX_INSTR_IS_INT:  return BX_TRACE_BR_INT;
+    default:               return BX_TRACE_BR_JMP;
+  }
+}
+
+void bx_instr_ucnear_branch(unsigned cpu, unsigned what, bx_address new_eip)
+{
+  trace_branch(cpu, branch_kind(what));
+}
+
+void bx_instr_far_branch(unsigned cpu, unsigned what, Bit16u new_cs, bx_address new_eip)
+{
+  Bit8u *p = record_start(cpu);
+  if (p == NULL) return;
+  *p++ = BX_TRACE_REC_BRANCH | ((BX_TRACE_BR_FAR | branch_kind(what)) << 3);
+  tcpu[cpu].ptr = put_varint(p, new_cs);
+}
+
+void bx_instr_interrupt(unsigned cpu, unsigned vector)
+{
+  trace_event(cpu, BX_TRACE_EV_INTERRUPT, vector);
+}
+
+void bx_instr_exception(unsigned cpu, unsigned vector)
+{
+  trace_event(cpu, BX_TRACE_EV_EXCEPTION, vector);
+}
+
+void bx_instr_hwinterrupt(unsigned cpu, unsigned vector, Bit16u cs, bx_address eip)
+{
+  trace_event(cpu, BX_TRACE_EV_HWINTERRUPT, vector);
+}
+
+void bx_instr_tlb_cntrl(unsigned cpu, unsigned what, Bit32u newval)
+{
+  if (what == BX_INSTR_MOV_CR3 || what == BX_INSTR_TASKSWITCH)
+    trace_event(cpu, BX_TRACE_EV_CR3, newval);
+}
+
+void bx_instr_before_execution(unsigned cpu, const bxInstruction_c *i)
+{
+  Bit8u *p = record_start(cpu);
+  if (p == NULL) return;
+
+  bx_trace_cpu_t *t = &tcpu[cpu];
+  Bit64u eip = BX_CPU(cpu)->get_linear_ip();
+  unsigned len = i->ilen();
+  Bit8u tag = BX_TRACE_REC_INSN | ((len & 0xf) << 4);
+
+  if (eip != t->state.next_eip) {
+    *p++ = tag | BX_TRACE_INSN_DELTA;
+    p = put_varint(p, BX_TRACE_ZIGZAG(eip - t->state.next_eip));
+  }
+  else {
+    *p++ = tag;
+  }
+  t->state.next_eip = eip + len;
+  t->insns++;
+  t->ptr = p;
+}
+
+void bx_instr_lin_read(unsigned cpu, bx_address lin, bx_address phy, unsigned len)
+{
+  trace_mem(cpu, BX_TRACE_REC_READ, lin, phy, len);
+}
+
+void bx_instr_lin_write(unsigned cpu, bx_address lin, bx_address phy, unsigned len)
+{
+  trace_mem(cpu, BX_TRACE_REC_WRITE, lin, phy, len);
+}
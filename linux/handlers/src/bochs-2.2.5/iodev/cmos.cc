@@ -194,6 +194,8 @@ bx_cmos_c::init(void)
     BX_INFO(("Using specified time for initial clock"));
     BX_CMOS_THIS s.timeval = bx_options.clock.Otime0->get ();
   }
+  // the host time is an input of the run, see replay.h
+  BX_CMOS_THIS s.timeval = (time_t) bx_replay.time0(BX_CMOS_THIS s.timeval);
 
   // load CMOS from image file if requested.
   if (bx_options.cmosimage.Oenabled->get ()) {
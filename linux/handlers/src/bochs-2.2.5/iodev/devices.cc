@@ -119,6 +119,9 @@ bx_devices_c::init(BX_MEM_C *newmem)
   io_read_handlers.funct         = (void *)&default_read_handler;
   io_read_handlers.this_ptr      = NULL;
   io_read_handlers.usage_count = 0; // not used with the default handler
+#if BX_SUPPORT_STATS
+  io_read_handlers.count = 0;
+#endif
   io_read_handlers.mask          = 7;
   
   io_write_handlers.next = &io_write_handlers;
@@ -127,6 +130,9 @@ bx_devices_c::init(BX_MEM_C *newmem)
   io_write_handlers.funct        = (void *)&default_write_handler;
   io_write_handlers.this_ptr     = NULL;
   io_write_handlers.usage_count = 0; // not used with the default handler
+#if BX_SUPPORT_STATS
+  io_write_handlers.count = 0;
+#endif
   io_write_handlers.mask         = 7;
 
   if (read_port_to_handler)
@@ -268,12 +274,12 @@ bx_devices_c::init(BX_MEM_C *newmem)
   iodebug->init();
 #endif
 
-#if 0
   // Guest to Host interface.  Used with special guest drivers
   // which move data to/from the host environment.
-  g2h = &bx_g2h;
-  g2h->init();
-#endif
+  if (bx_options.g2h.Oenabled->get ()) {
+    g2h = &bx_g2h;
+    g2h->init();
+  }
 
   // system hardware
   register_io_read_handler(this, &read_handler, 0x0092,
@@ -338,6 +344,8 @@ bx_devices_c::reset(unsigned type)
 #if BX_SUPPORT_IODEBUG
   iodebug->reset(type);
 #endif
+  if (g2h != NULL)
+    g2h->reset(type);
   // now reset optional plugins
   bx_reset_plugins(type);
 }
@@ -439,8 +447,10 @@ bx_devices_c::timer()
     {
       multiple=0;
       SIM->periodic ();
-      if (!BX_CPU(0)->kill_bochs_request)
+      if (!BX_CPU(0)->kill_bochs_request) {
+        bx_replay.gui_poll();
 	bx_gui->handle_events();
+      }
     }
   }
 
@@ -529,6 +539,9 @@ bx_devices_c::register_io_read_handler(void *this_ptr, bx_read_handler_t f,
     io_read_handler->handler_name = name;
     io_read_handler->mask = mask;
     io_read_handler->usage_count = 0;
+#if BX_SUPPORT_STATS
+    io_read_handler->count = 0;
+#endif
     // add the handler to the double linked list of handlers
     io_read_handlers.prev->next = io_read_handler;
     io_read_handler->next = &io_read_handlers;
@@ -583,6 +596,9 @@ bx_devices_c::register_io_write_handler(void *this_ptr, bx_write_handler_t f,
     io_write_handler->handler_name = name;
     io_write_handler->mask = mask;
     io_write_handler->usage_count = 0;
+#if BX_SUPPORT_STATS
+    io_write_handler->count = 0;
+#endif
     // add the handler to the double linked list of handlers
     io_write_handlers.prev->next = io_write_handler;
     io_write_handler->next = &io_write_handlers;
@@ -647,6 +663,9 @@ bx_devices_c::register_io_read_handler_range(void *this_ptr, bx_read_handler_t f
     io_read_handler->handler_name = name;
     io_read_handler->mask = mask;
     io_read_handler->usage_count = 0;
+#if BX_SUPPORT_STATS
+    io_read_handler->count = 0;
+#endif
     // add the handler to the double linked list of handlers
     io_read_handlers.prev->next = io_read_handler;
     io_read_handler->next = &io_read_handlers;
@@ -712,6 +731,9 @@ bx_devices_c::register_io_write_handler_range(void *this_ptr, bx_write_handler_t
     io_write_handler->handler_name = name;
     io_write_handler->mask = mask;
     io_write_handler->usage_count = 0;
+#if BX_SUPPORT_STATS
+    io_write_handler->count = 0;
+#endif
     // add the handler to the double linked list of handlers
     io_write_handlers.prev->next = io_write_handler;
     io_write_handler->next = &io_write_handlers;
@@ -887,6 +909,9 @@ bx_devices_c::inp(Bit16u addr, unsigned io_len)
   BX_INSTR_INP(addr, io_len);
   
   io_read_handler = read_port_to_handler[addr];
+#if BX_SUPPORT_STATS
+  io_read_handler->count++;
+#endif
   if (io_read_handler->mask & io_len) {
 	ret = ((bx_read_handler_t)io_read_handler->funct)(io_read_handler->this_ptr, (Bit32u)addr, io_len);
   } else {
@@ -920,6 +945,9 @@ bx_devices_c::outp(Bit16u addr, Bit32u value, unsigned io_len)
   BX_DBG_IO_REPORT(addr, io_len, BX_WRITE, value);
   
   io_write_handler = write_port_to_handler[addr];
+#if BX_SUPPORT_STATS
+  io_write_handler->count++;
+#endif
   if (io_write_handler->mask & io_len) {
 	((bx_write_handler_t)io_write_handler->funct)(io_write_handler->this_ptr, (Bit32u)addr, value, io_len);
   } else if (addr != 0x0cf8) { // don't flood the logfile when probing PCI
@@ -927,6 +955,66 @@ bx_devices_c::outp(Bit16u addr, Bit32u value, unsigned io_len)
   }
 }
 
+#if BX_SUPPORT_STATS
+static Bit64s io_read_stats_handler(bx_param_c *param, int set, Bit64s val)
+{
+  return bx_devices.get_io_count(0, param->get_name());
+}
+
+static Bit64s io_write_stats_handler(bx_param_c *param, int set, Bit64s val)
+{
+  return bx_devices.get_io_count(1, param->get_name());
+}
+
+// A device may own several handlers (one per io_len mask), so the
+// parameters are per device name and sum the counts of its handlers.
+  void
+bx_devices_c::init_stats(bx_list_c *parent)
+{
+  static char io_read_name[] = "io_read";
+  static char io_write_name[] = "io_write";
+
+  for (int write=0; write<2; write++) {
+    struct io_handler_struct *head = write ? &io_write_handlers : &io_read_handlers;
+    struct io_handler_struct *curr = head;
+    int n = 0;
+    do {
+      n++;
+      curr = curr->next;
+    } while (curr != head);
+
+    bx_list_c *list = new bx_list_c (BXP_NULL, write ? io_write_name : io_read_name, "", n);
+    do {
+      int i;
+      for (i=0; i<list->get_size (); i++) {
+        if (!strcmp(list->get(i)->get_name (), curr->handler_name)) break;
+      }
+      if (i == list->get_size ()) {
+        bx_param_num_c *param = new bx_param_num_c (BXP_NULL,
+            (char *) curr->handler_name, "", 0, BX_MAX_BIT64S, 0);
+        param->set_handler (write ? io_write_stats_handler : io_read_stats_handler);
+        list->add (param);
+      }
+      curr = curr->next;
+    } while (curr != head);
+    parent->add (list);
+  }
+}
+
+  Bit64u
+bx_devices_c::get_io_count(bx_bool write, const char *name)
+{
+  struct io_handler_struct *head = write ? &io_write_handlers : &io_read_handlers;
+  struct io_handler_struct *curr = head;
+  Bit64u count = 0;
+  do {
+    if (!strcmp(curr->handler_name, name)) count += curr->count;
+    curr = curr->next;
+  } while (curr != head);
+  return count;
+}
+#endif
+
 bx_bool bx_devices_c::is_serial_enabled ()
 {
   for (int i=0; i<BX_N_SERIAL_PORTS; i++) {
@@ -25,27 +25,32 @@
 //  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
 
 
-
 #include "iodev.h"
 #define LOG_THIS  bx_g2h.
 
+// size of the host side bounce buffer used for bulk file transfers
+#define BX_G2H_XFER_SIZE  65536
+// longest text accepted by BX_G2H_OP_REPORT
+#define BX_G2H_MAX_REPORT 1024
+
 bx_g2h_c bx_g2h;
 
+static Bit8u g2h_xfer_buf[BX_G2H_XFER_SIZE];
+
 bx_g2h_c::bx_g2h_c(void)
 {
   put("G2H");
   settype(G2HLOG);
-  unsigned i;
-
-  for (i=0; i<BX_MAX_G2H_CHANNELS; i++) {
-    s.callback[i].f = NULL;
-    s.callback[i].used = 0;
-    }
+  memset(&s, 0, sizeof(s));
 }
 
 bx_g2h_c::~bx_g2h_c(void)
 {
-  // nothing for now
+  close_files();
+  if (s.report != NULL) {
+    fclose(s.report);
+    s.report = NULL;
+  }
   BX_DEBUG(("Exit."));
 }
 
@@ -53,49 +58,38 @@ bx_g2h_c::~bx_g2h_c(void)
 bx_g2h_c::init(void)
 {
   BX_DEBUG(("Init $Id: guest2host.cc,v 1.14 2004/06/19 15:20:12 sshwarts Exp $"));
-  // Reserve a dword port for this interface
-  for (Bit32u addr=BX_G2H_PORT; addr<=(BX_G2H_PORT+3); addr++) {
-    bx_devices.register_io_read_handler(&bx_g2h,
-      inp_handler, addr, "g2h");
-    bx_devices.register_io_write_handler(&bx_g2h,
-      outp_handler, addr, "g2h");
-    }
-  memset(&bx_g2h.s, 0, sizeof(bx_g2h.s));
+  DEV_register_ioread_handler(this, read_handler, BX_G2H_RING_REG, "Guest2Host", 4);
+  DEV_register_iowrite_handler(this, write_handler, BX_G2H_RING_REG, "Guest2Host", 4);
+  DEV_register_ioread_handler(this, read_handler, BX_G2H_DOORBELL_REG, "Guest2Host", 4);
+  DEV_register_iowrite_handler(this, write_handler, BX_G2H_DOORBELL_REG, "Guest2Host", 4);
+
+  char *logname = bx_options.g2h.Olog->getptr ();
+  if (strlen(logname) > 0) {
+    BX_G2H_THIS s.report = fopen(logname, "w");
+    if (BX_G2H_THIS s.report == NULL)
+      BX_PANIC(("could not open report log '%s'", logname));
+  }
+  BX_INFO(("channel at 0x%04x, share directory '%s'", BX_G2H_PORT,
+           bx_options.g2h.Odir->getptr ()));
 }
 
   void
 bx_g2h_c::reset(unsigned type)
 {
+  BX_G2H_THIS s.ring_addr = 0;
+  BX_G2H_THIS s.completed = 0;
+  close_files();
 }
 
-  unsigned
-bx_g2h_c::acquire_channel(bx_g2h_callback_t f)
-{
-  unsigned i;
-
-  for (i=0; i<BX_MAX_G2H_CHANNELS; i++) {
-    if (bx_g2h.s.callback[i].used==0) {
-      bx_g2h.s.callback[i].f = f;
-      bx_g2h.s.callback[i].used = 1;
-      return(i);
-      }
-    }
-
-  BX_INFO(("g2h: attempt to acquire channel: maxed out"));
-  return(BX_G2H_ERROR); // No more free channels
-}
-
-  unsigned
-bx_g2h_c::deacquire_channel(unsigned channel)
+  void
+bx_g2h_c::close_files(void)
 {
-  if ( (channel >= BX_MAX_G2H_CHANNELS) ||
-       (bx_g2h.s.callback[channel].used==0) ) {
-    BX_PANIC(("g2h: attempt to deacquire channel %u: not acquired",
-      channel));
+  for (unsigned i=0; i<BX_G2H_MAX_FILES; i++) {
+    if (BX_G2H_THIS s.file[i] != NULL) {
+      fclose(BX_G2H_THIS s.file[i]);
+      BX_G2H_THIS s.file[i] = NULL;
     }
-  bx_g2h.s.callback[channel].used = 0;
-  bx_g2h.s.callback[channel].f = NULL;
-  return(0);
+  }
 }
 
 
@@ -103,49 +97,246 @@ bx_g2h_c::deacquire_channel(unsigned channel)
   // redirects to non-static class handler to avoid virtual functions
 
   Bit32u
-bx_g2h_c::inp_handler(void *this_ptr, Bit32u addr, unsigned io_len)
+bx_g2h_c::read_handler(void *this_ptr, Bit32u addr, unsigned io_len)
 {
   UNUSED(this_ptr);
+  UNUSED(io_len);
 
-  if (addr != BX_G2H_PORT)
-    BX_PANIC(("g2h: IO read not aligned on dword boundary."));
-  if (io_len != 4)
-    BX_PANIC(("g2h: IO read not dword."));
+  if (addr == BX_G2H_RING_REG)
+    return(BX_G2H_MAGIC);
+  return(BX_G2H_THIS s.completed);
+}
 
-  BX_PANIC(("g2h: IO read not complete."));
-  return(0);
+  void
+bx_g2h_c::write_handler(void *this_ptr, Bit32u addr,
+                        Bit32u value, unsigned io_len)
+{
+  UNUSED(this_ptr);
+  UNUSED(io_len);
+
+  if (addr == BX_G2H_RING_REG) {
+    if (value & 3) {
+      BX_ERROR(("ring address 0x%08x not dword aligned", value));
+      value = 0;
+    }
+    BX_G2H_THIS s.ring_addr = value;
+    BX_DEBUG(("ring at 0x%08x", value));
+  } else {
+    BX_G2H_THIS process_ring();
+  }
 }
 
 
+// Move a buffer between guest physical memory and the host.  The memory
+// interface works on one page at a time, so a bulk request is split at
+// page boundaries only.
 
   void
-bx_g2h_c::outp_handler(void *this_ptr, Bit32u addr,
-                               Bit32u val32, unsigned io_len)
+bx_g2h_c::copy_from_guest(Bit32u addr, Bit32u len, Bit8u *buf)
 {
-  UNUSED(this_ptr);
+  while (len > 0) {
+    Bit32u chunk = 0x1000 - (addr & 0xfff);
+    if (chunk > len) chunk = len;
+    BX_MEM_READ_PHYSICAL(addr, chunk, buf);
+    addr += chunk;
+    buf += chunk;
+    len -= chunk;
+  }
+}
 
-  if (addr != BX_G2H_PORT)
-    BX_PANIC(("g2h: IO write not aligned on dword boundary."));
-  if (io_len != 4)
-    BX_PANIC(("g2h: IO write not dword."));
+  void
+bx_g2h_c::copy_to_guest(Bit32u addr, Bit32u len, Bit8u *buf)
+{
+  while (len > 0) {
+    Bit32u chunk = 0x1000 - (addr & 0xfff);
+    if (chunk > len) chunk = len;
+    BX_MEM_WRITE_PHYSICAL(addr, chunk, buf);
+    addr += chunk;
+    buf += chunk;
+    len -= chunk;
+  }
+}
+
+
+// Doorbell: run every request the guest has queued since the last one and
+// publish the new consumer index.
+
+  void
+bx_g2h_c::process_ring(void)
+{
+  Bit32u ring = BX_G2H_THIS s.ring_addr;
+  Bit32u magic, size, prod, cons;
 
-  if ( (bx_g2h.s.packet_count==0) && (val32!=BX_G2H_MAGIC) ) {
-    BX_INFO(("g2h: IO W: Not magic header."));
+  if (ring == 0) {
+    BX_ERROR(("doorbell without a ring"));
     return;
-    }
-  bx_g2h.s.guest_packet[bx_g2h.s.packet_count++] = val32;
-  if (bx_g2h.s.packet_count >= BX_G2H_PACKET_SIZE) {
-    unsigned channel;
-
-    // Full packet received from guest.  Pass on to the host code.
-    channel = bx_g2h.s.guest_packet[1];
-    if (channel >= BX_MAX_G2H_CHANNELS) {
-      BX_PANIC(("g2h: channel (%u) out of bounds", channel));
+  }
+  BX_MEM_READ_PHYSICAL(ring, 4, &magic);
+  BX_MEM_READ_PHYSICAL(ring + 4, 4, &size);
+  BX_MEM_READ_PHYSICAL(ring + 8, 4, &prod);
+  BX_MEM_READ_PHYSICAL(ring + 12, 4, &cons);
+  if (magic != BX_G2H_RING_MAGIC) {
+    BX_ERROR(("bad ring magic 0x%08x at 0x%08x", magic, ring));
+    return;
+  }
+  if ((size == 0) || (size > BX_G2H_MAX_RING_SIZE) || (size & (size - 1))) {
+    BX_ERROR(("bad ring size %u", size));
+    return;
+  }
+  if ((Bit32u)(prod - cons) > size) {
+    BX_ERROR(("ring indices out of range (prod=%u, cons=%u)", prod, cons));
+    return;
+  }
+
+  while (cons != prod) {
+    Bit32u desc = ring + BX_G2H_RING_HDR_SIZE + (cons & (size - 1)) * BX_G2H_DESC_SIZE;
+    Bit32u opcode, handle, arg, addr, len, status, dword;
+    Bit64u result = 0;
+
+    BX_MEM_READ_PHYSICAL(desc, 4, &opcode);
+    BX_MEM_READ_PHYSICAL(desc + 8, 4, &handle);
+    BX_MEM_READ_PHYSICAL(desc + 12, 4, &arg);
+    BX_MEM_READ_PHYSICAL(desc + 16, 4, &addr);
+    BX_MEM_READ_PHYSICAL(desc + 20, 4, &len);
+    status = do_request(opcode, handle, arg, addr, len, &result);
+    BX_MEM_WRITE_PHYSICAL(desc + 4, 4, &status);
+    dword = (Bit32u) result;
+    BX_MEM_WRITE_PHYSICAL(desc + 24, 4, &dword);
+    dword = (Bit32u) (result >> 32);
+    BX_MEM_WRITE_PHYSICAL(desc + 28, 4, &dword);
+    cons++;
+    BX_G2H_THIS s.completed++;
+  }
+  BX_MEM_WRITE_PHYSICAL(ring + 12, 4, &cons);
+}
+
+  Bit32u
+bx_g2h_c::do_open(Bit32u flags, Bit32u addr, Bit32u len, Bit64u *result)
+{
+  char name[BX_PATHNAME_LEN], path[2*BX_PATHNAME_LEN];
+  char *dir = bx_options.g2h.Odir->getptr ();
+  unsigned handle;
+
+  if ((strlen(dir) == 0) || (len == 0) || (len >= BX_PATHNAME_LEN) || (flags > 1))
+    return BX_G2H_STATUS_EINVAL;
+  copy_from_guest(addr, len, (Bit8u *) name);
+  name[len] = 0;
+  // the guest may only see files below the share directory
+  if ((name[0] == '/') || (name[0] == '\\') || (strstr(name, "..") != NULL))
+    return BX_G2H_STATUS_EINVAL;
+
+  for (handle=0; handle<BX_G2H_MAX_FILES; handle++) {
+    if (BX_G2H_THIS s.file[handle] == NULL) break;
+  }
+  if (handle == BX_G2H_MAX_FILES)
+    return BX_G2H_STATUS_EIO;
+
+  sprintf(path, "%s/%s", dir, name);
+  BX_G2H_THIS s.file[handle] = fopen(path, flags ? "wb" : "rb");
+  if (BX_G2H_THIS s.file[handle] == NULL)
+    return BX_G2H_STATUS_ENOENT;
+  BX_DEBUG(("open '%s' (%s) as handle %u", path, flags ? "write" : "read", handle));
+  *result = handle;
+  return BX_G2H_STATUS_OK;
+}
+
+  Bit32u
+bx_g2h_c::do_request(Bit32u opcode, Bit32u handle, Bit32u arg,
+                     Bit32u addr, Bit32u len, Bit64u *result)
+{
+  FILE *fp = NULL;
+  Bit32u done, chunk;
+
+  switch (opcode) {
+    case BX_G2H_OP_CLOSE:
+    case BX_G2H_OP_READ:
+    case BX_G2H_OP_WRITE:
+    case BX_G2H_OP_SIZE:
+      if (handle >= BX_G2H_MAX_FILES)
+        return BX_G2H_STATUS_EBADF;
+      fp = BX_G2H_THIS s.file[handle];
+      if (fp == NULL)
+        return BX_G2H_STATUS_EBADF;
+      break;
+  }
+
+  switch (opcode) {
+    case BX_G2H_OP_NOP:
+      return BX_G2H_STATUS_OK;
+
+    case BX_G2H_OP_OPEN:
+      return do_open(arg, addr, len, result);
+
+    case BX_G2H_OP_CLOSE:
+      fclose(fp);
+      BX_G2H_THIS s.file[handle] = NULL;
+      return BX_G2H_STATUS_OK;
+
+    case BX_G2H_OP_READ:
+      if (fseek(fp, arg, SEEK_SET) != 0)
+        return BX_G2H_STATUS_EIO;
+      for (done = 0; done < len; done += chunk) {
+        chunk = len - done;
+        if (chunk > BX_G2H_XFER_SIZE) chunk = BX_G2H_XFER_SIZE;
+        chunk = fread(g2h_xfer_buf, 1, chunk, fp);
+        if (chunk == 0) break;
+        copy_to_guest(addr + done, chunk, g2h_xfer_buf);
       }
-    if (bx_g2h.s.callback[channel].used==0) {
-      BX_PANIC(("g2h: channel (%u) not active", channel));
+      *result = done;
+      return ferror(fp) ? BX_G2H_STATUS_EIO : BX_G2H_STATUS_OK;
+
+    case BX_G2H_OP_WRITE:
+      if (fseek(fp, arg, SEEK_SET) != 0)
+        return BX_G2H_STATUS_EIO;
+      for (done = 0; done < len; done += chunk) {
+        chunk = len - done;
+        if (chunk > BX_G2H_XFER_SIZE) chunk = BX_G2H_XFER_SIZE;
+        copy_from_guest(addr + done, chunk, g2h_xfer_buf);
+        if (fwrite(g2h_xfer_buf, 1, chunk, fp) != chunk) {
+          *result = done;
+          return BX_G2H_STATUS_EIO;
+        }
       }
-    bx_g2h.s.callback[channel].f(&bx_g2h.s.guest_packet);
-    bx_g2h.s.packet_count = 0; // Ready for next packet
-    }
+      *result = done;
+      return BX_G2H_STATUS_OK;
+
+    case BX_G2H_OP_SIZE:
+      if (fseek(fp, 0, SEEK_END) != 0)
+        return BX_G2H_STATUS_EIO;
+      *result = ftell(fp);
+      return BX_G2H_STATUS_OK;
+
+    case BX_G2H_OP_REPORT:
+      {
+        char text[BX_G2H_MAX_REPORT+1];
+        if (len > BX_G2H_MAX_REPORT) len = BX_G2H_MAX_REPORT;
+        copy_from_guest(addr, len, (Bit8u *) text);
+        text[len] = 0;
+        len = strlen(text);
+        while ((len > 0) && ((text[len-1] == '\n') || (text[len-1] == '\r')))
+          text[--len] = 0;
+        if (BX_G2H_THIS s.report != NULL) {
+          fprintf(BX_G2H_THIS s.report, "%s\n", text);
+          fflush(BX_G2H_THIS s.report);
+        } else {
+          BX_INFO(("report: %s", text));
+        }
+        *result = len;
+      }
+      return BX_G2H_STATUS_OK;
+
+    case BX_G2H_OP_MARK:
+      *result = bx_pc_system.time_ticks();
+      if (BX_G2H_THIS s.report != NULL) {
+        fprintf(BX_G2H_THIS s.report, "mark %u " FMT_LL "u\n", handle, *result);
+        fflush(BX_G2H_THIS s.report);
+      } else {
+        BX_INFO(("mark %u at tick " FMT_LL "u", handle, *result));
+      }
+      return BX_G2H_STATUS_OK;
+
+    default:
+      BX_ERROR(("unknown request opcode %u", opcode));
+      return BX_G2H_STATUS_ENOSYS;
+  }
 }
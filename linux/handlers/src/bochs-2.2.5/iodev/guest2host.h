@@ -26,52 +26,98 @@
 
 
 
-#define BX_MAX_G2H_CHANNELS 8
-#define BX_G2H_ERROR        ((unsigned) -1)
-  // IO port number for this interface.  Align on dword boundary.
-#define BX_G2H_PORT  0x2000
-  // Magic number which is first dword passed by guest
-#define BX_G2H_MAGIC 0xffeeddcc
-  // Number of dwords in packet from guest
-#define BX_G2H_PACKET_SIZE 5
+// Paravirtual guest to host channel.
+//
+// The guest puts a ring of request descriptors somewhere in its physical
+// memory and tells the host where it is by writing the physical address
+// to the ring register.  Writing the doorbell register makes the host
+// process every request between req_cons and req_prod before the OUT
+// instruction completes; the guest does not have to poll or take an
+// interrupt.  Data buffers are moved with one bulk copy per request.
+//
+//   port 0x2000 (dword)  read:  BX_G2H_MAGIC if the channel is present
+//                        write: ring physical address (0 = no ring)
+//   port 0x2004 (dword)  read:  number of requests completed so far
+//                        write: doorbell, process pending requests
+//
+// All ring fields are little endian dwords.
+//
+//   ring header   +0  magic     BX_G2H_RING_MAGIC
+//                 +4  size      number of descriptors (power of 2)
+//                 +8  req_prod  written by the guest
+//                 +12 req_cons  written by the host
+//                 +16 descriptors
+//
+//   descriptor    +0  opcode    BX_G2H_OP_xxx
+//                 +4  status    BX_G2H_STATUS_xxx, written by the host
+//                 +8  handle    file handle or marker id
+//                 +12 arg       opcode specific (open flags, offset)
+//                 +16 addr      guest physical address of the buffer
+//                 +20 len       buffer length in bytes
+//                 +24 result    opcode specific result, written by host
+//                 +28 result_hi high dword of a 64 bit result
 
+  // IO port number for this interface.  Align on dword boundary.
+#define BX_G2H_PORT         0x2000
+#define BX_G2H_RING_REG     (BX_G2H_PORT)
+#define BX_G2H_DOORBELL_REG (BX_G2H_PORT + 4)
+  // Returned when the guest probes the ring register
+#define BX_G2H_MAGIC        0xffeeddcc
+  // First dword of a valid ring header ("G2HR")
+#define BX_G2H_RING_MAGIC   0x52483247
 
+#define BX_G2H_RING_HDR_SIZE   16
+#define BX_G2H_DESC_SIZE       32
+#define BX_G2H_MAX_RING_SIZE   1024
+#define BX_G2H_MAX_FILES       8
 
-typedef Bit32u bx_guest_packet_t[BX_G2H_PACKET_SIZE];
-typedef void (*bx_g2h_callback_t)(bx_guest_packet_t *);
+// request opcodes
+#define BX_G2H_OP_NOP     0
+#define BX_G2H_OP_OPEN    1  // buffer: path relative to the share directory
+                             // arg: 0=read, 1=write/truncate; result: handle
+#define BX_G2H_OP_CLOSE   2
+#define BX_G2H_OP_READ    3  // arg: file offset; result: bytes read
+#define BX_G2H_OP_WRITE   4  // arg: file offset; result: bytes written
+#define BX_G2H_OP_SIZE    5  // result: size of the file
+#define BX_G2H_OP_REPORT  6  // buffer: text line for the host report log
+#define BX_G2H_OP_MARK    7  // handle: marker id; result: emulated time
 
+// request status
+#define BX_G2H_STATUS_OK      0
+#define BX_G2H_STATUS_EINVAL  1
+#define BX_G2H_STATUS_ENOENT  2
+#define BX_G2H_STATUS_EBADF   3
+#define BX_G2H_STATUS_EIO     4
+#define BX_G2H_STATUS_ENOSYS  5
 
+#define BX_G2H_THIS bx_g2h.
 
-class bx_g2h_c : public logfunctions {
+class bx_g2h_c : public bx_devmodel_c {
 public:
   bx_g2h_c(void);
   ~bx_g2h_c(void);
-  static void   init(void);
-  void reset (unsigned type);
-  unsigned acquire_channel(bx_g2h_callback_t);
-  unsigned deacquire_channel(unsigned channel);
+  virtual void init(void);
+  virtual void reset(unsigned type);
 
 private:
-
-  static Bit32u inp_handler(void *this_ptr, Bit32u addr, unsigned io_len);
-  static void   outp_handler(void *this_ptr, Bit32u addr,
+  static Bit32u read_handler(void *this_ptr, Bit32u addr, unsigned io_len);
+  static void   write_handler(void *this_ptr, Bit32u addr,
                               Bit32u value, unsigned io_len);
-  // state info
-  struct {
-    struct {
-      bx_g2h_callback_t f;
-      bx_bool used;
-      } callback[BX_MAX_G2H_CHANNELS];
 
-    // Define the data received from the guest OS.
-    //   dword0: magic number, should be BX_G2H_MAGIC
-    //   dword1: channel ID
-    //   dword2: address of data structure in guest physical memory
-    //   dword3: size of data structure in guest physical memory
-    //   dword4: address of return data structure in guest physical memory
-    unsigned packet_count;
-    bx_guest_packet_t guest_packet;
-    } s;
-  };
+  void   process_ring(void);
+  Bit32u do_request(Bit32u opcode, Bit32u handle, Bit32u arg,
+                    Bit32u addr, Bit32u len, Bit64u *result);
+  Bit32u do_open(Bit32u flags, Bit32u addr, Bit32u len, Bit64u *result);
+  void   copy_from_guest(Bit32u addr, Bit32u len, Bit8u *buf);
+  void   copy_to_guest(Bit32u addr, Bit32u len, Bit8u *buf);
+  void   close_files(void);
+
+  struct {
+    Bit32u ring_addr;
+    Bit32u completed;
+    FILE  *file[BX_G2H_MAX_FILES];
+    FILE  *report;
+  } s;
+};
 
 extern bx_g2h_c bx_g2h;
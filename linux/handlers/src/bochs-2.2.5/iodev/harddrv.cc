@@ -112,6 +112,7 @@ bx_hard_drive_c::bx_hard_drive_c(void)
     for (Bit8u channel=0; channel<BX_MAX_ATA_CHANNEL; channel++) {
       channels[channel].drives[0].hard_drive =  NULL;
       channels[channel].drives[1].hard_drive =  NULL;
+      channels[channel].prefetch = NULL;
       put("HD");
       settype(HDLOG);
     }
@@ -133,6 +134,10 @@ bx_hard_drive_c::~bx_hard_drive_c(void)
       delete channels[channel].drives[1].hard_drive;
       channels[channel].drives[1].hard_drive =  NULL;        /* DT 17.12.2001 21:56 */
     }
+    if (channels[channel].prefetch != NULL) {
+      delete [] channels[channel].prefetch;
+      channels[channel].prefetch = NULL;
+    }
   }
 }
 
@@ -229,7 +234,7 @@ bx_hard_drive_c::init(void)
       BX_CONTROLLER(channel,device).control.disable_irq = 0;
       BX_CONTROLLER(channel,device).reset_in_progress   = 0;
 
-      BX_CONTROLLER(channel,device).sectors_per_block   = 0x80;
+      BX_CONTROLLER(channel,device).sectors_per_block   = BX_MAX_MULTIPLE_SECTORS;
       BX_CONTROLLER(channel,device).lba_mode            = 0;
 
       BX_CONTROLLER(channel,device).features            = 0;
@@ -238,6 +243,7 @@ bx_hard_drive_c::init(void)
       BX_HD_THIS channels[channel].drives[device].device_type           = IDE_NONE;
       BX_HD_THIS channels[channel].drives[device].statusbar_id = -1;
       BX_HD_THIS channels[channel].drives[device].iolight_counter = 0;
+      BX_HD_THIS channels[channel].drives[device].bulk_io = 0;
       if (!bx_options.atadevice[channel][device].Opresent->get()) {
         continue;
       }
@@ -268,6 +274,7 @@ bx_hard_drive_c::init(void)
             BX_INFO(("HD on ata%d-%d: '%s' 'flat' mode ", channel, device, 
                                     bx_options.atadevice[channel][device].Opath->getptr ()));
             channels[channel].drives[device].hard_drive = new default_image_t();
+            channels[channel].drives[device].bulk_io = 1;
             break;
 
           case BX_ATA_MODE_CONCAT:
@@ -447,6 +454,17 @@ bx_hard_drive_c::init(void)
     }
   }
 
+  // PIO reads from images that take multi-sector transfers are served
+  // from a per-channel read-ahead buffer
+  for (channel=0; channel<BX_MAX_ATA_CHANNEL; channel++) {
+    BX_HD_THIS channels[channel].prefetch_count = 0;
+    if ((BX_HD_THIS channels[channel].drives[0].bulk_io ||
+         BX_HD_THIS channels[channel].drives[1].bulk_io) &&
+        (BX_HD_THIS channels[channel].prefetch == NULL)) {
+      BX_HD_THIS channels[channel].prefetch = new Bit8u[BX_HD_PREFETCH_SECTORS * 512];
+    }
+  }
+
   // generate CMOS values for hard drive if not using a CMOS image
   if (!bx_options.cmosimage.Oenabled->get ()) {
     DEV_cmos_set_reg(0x12, 0x00); // start out with: no drive 0, no drive 1
@@ -693,15 +711,17 @@ bx_hard_drive_c::read(Bit32u address, unsigned io_len)
       switch (BX_SELECTED_CONTROLLER(channel).current_command) {
         case 0x20: // READ SECTORS, with retries
         case 0x21: // READ SECTORS, without retries
-          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= 512)
-            BX_PANIC(("IO read(0x%04x): buffer_index >= 512", address));
+        case 0xC4: // READ MULTIPLE SECTORS
+          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= BX_SELECTED_CONTROLLER(channel).buffer_size)
+            BX_PANIC(("IO read(0x%04x): buffer_index >= %d", address,
+                      BX_SELECTED_CONTROLLER(channel).buffer_size));
 
 #if BX_SupportRepeatSpeedups
           if (DEV_bulk_io_quantum_requested()) {
             unsigned transferLen, quantumsMax;
 
             quantumsMax =
-              (512 - BX_SELECTED_CONTROLLER(channel).buffer_index) / io_len;
+              (BX_SELECTED_CONTROLLER(channel).buffer_size - BX_SELECTED_CONTROLLER(channel).buffer_index) / io_len;
             if ( quantumsMax == 0)
               BX_PANIC(("IO read(0x%04x): not enough space for read", address));
             DEV_bulk_io_quantum_transferred() =
@@ -732,14 +752,17 @@ bx_hard_drive_c::read(Bit32u address, unsigned io_len)
             }
 
           // if buffer completely read
-          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= 512) {
+          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= BX_SELECTED_CONTROLLER(channel).buffer_size) {
             // update sector count, sector number, cylinder,
             // drive, head, status
-            // if there are more sectors, read next one in...
+            // if there are more sectors, read next block in...
             //
+            Bit32u count = BX_SELECTED_CONTROLLER(channel).buffer_size / 512;
+
             BX_SELECTED_CONTROLLER(channel).buffer_index = 0;
 
-	    increment_address(channel);
+            while (count-- > 0)
+	      increment_address(channel);
 
             BX_SELECTED_CONTROLLER(channel).status.busy = 0;
             BX_SELECTED_CONTROLLER(channel).status.drive_ready = 1;
@@ -751,38 +774,14 @@ bx_hard_drive_c::read(Bit32u address, unsigned io_len)
             if (BX_SELECTED_CONTROLLER(channel).sector_count==0) {
               BX_SELECTED_CONTROLLER(channel).status.drq = 0;
               }
-            else { /* read next one into controller buffer */
-              off_t logical_sector;
-              off_t ret;
-
+            else { /* read next block into controller buffer */
               BX_SELECTED_CONTROLLER(channel).status.drq = 1;
               BX_SELECTED_CONTROLLER(channel).status.seek_complete = 1;
 
-	      if (!calculate_logical_address(channel, &logical_sector)) {
-	        BX_ERROR(("multi-sector read reached invalid sector %lu, aborting", (unsigned long)logical_sector));
-		command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
-	        GOTO_RETURN_VALUE ;
-	      }
-	      ret = BX_SELECTED_DRIVE(channel).hard_drive->lseek(logical_sector * 512, SEEK_SET);
-              if (ret < 0) {
-                BX_ERROR(("could not lseek() hard drive image file"));
-		command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+              BX_SELECTED_CONTROLLER(channel).buffer_size = pio_block_size(channel);
+              if (!pio_read_block(channel, BX_SELECTED_CONTROLLER(channel).buffer_size / 512))
 	        GOTO_RETURN_VALUE ;
-	      }
-              /* set status bar conditions for device */
-              if (!BX_SELECTED_DRIVE(channel).iolight_counter)
-                bx_gui->statusbar_setitem(BX_SELECTED_DRIVE(channel).statusbar_id, 1);
-              BX_SELECTED_DRIVE(channel).iolight_counter = 5;
-              bx_pc_system.activate_timer( BX_HD_THIS iolight_timer_index, 100000, 0 );
-	      ret = BX_SELECTED_DRIVE(channel).hard_drive->read((bx_ptr_t) BX_SELECTED_CONTROLLER(channel).buffer, 512);
-              if (ret < 512) {
-                BX_ERROR(("logical sector was %lu", (unsigned long)logical_sector));
-                BX_ERROR(("could not read() hard drive image file at byte %lu", (unsigned long)logical_sector*512));
-		command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
-	        GOTO_RETURN_VALUE ;
-	      }
 
-              BX_SELECTED_CONTROLLER(channel).buffer_index = 0;
 	      raise_interrupt(channel);
 	    }
 	  }
@@ -975,7 +974,6 @@ bx_hard_drive_c::read(Bit32u address, unsigned io_len)
 	case 0xB0: BX_ERROR(("read cmd 0xB0 (SMART DISABLE OPERATIONS) not supported")); command_aborted(channel, 0xB0); break;
 	case 0xB1: BX_ERROR(("read cmd 0xB1 (DEVICE CONFIGURATION FREEZE LOCK) not supported")); command_aborted(channel, 0xB1); break;
 	case 0xC0: BX_ERROR(("read cmd 0xC0 (CFA ERASE SECTORS) not supported")); command_aborted(channel, 0xC0); break;
-	case 0xC4: BX_ERROR(("read cmd 0xC4 (READ MULTIPLE) not supported")); command_aborted(channel, 0xC4); break;
 	case 0xC5: BX_ERROR(("read cmd 0xC5 (WRITE MULTIPLE) not supported")); command_aborted(channel, 0xC5); break;
 	case 0xC6: BX_ERROR(("read cmd 0xC6 (SET MULTIPLE MODE) not supported")); command_aborted(channel, 0xC6); break;
 	case 0xC7: BX_ERROR(("read cmd 0xC7 (READ DMA QUEUED) not supported")); command_aborted(channel, 0xC7); break;
@@ -1194,15 +1192,17 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
     case 0x00: // 0x1f0
       switch (BX_SELECTED_CONTROLLER(channel).current_command) {
         case 0x30: // WRITE SECTORS
-          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= 512)
-            BX_PANIC(("IO write(0x%04x): buffer_index >= 512", address));
+        case 0xC5: // WRITE MULTIPLE SECTORS
+          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= BX_SELECTED_CONTROLLER(channel).buffer_size)
+            BX_PANIC(("IO write(0x%04x): buffer_index >= %d", address,
+                      BX_SELECTED_CONTROLLER(channel).buffer_size));
 
 #if BX_SupportRepeatSpeedups
           if (DEV_bulk_io_quantum_requested()) {
             unsigned transferLen, quantumsMax;
 
             quantumsMax =
-              (512 - BX_SELECTED_CONTROLLER(channel).buffer_index) / io_len;
+              (BX_SELECTED_CONTROLLER(channel).buffer_size - BX_SELECTED_CONTROLLER(channel).buffer_index) / io_len;
             if ( quantumsMax == 0)
               BX_PANIC(("IO write(0x%04x): not enough space for write", address));
             DEV_bulk_io_quantum_transferred() =
@@ -1232,49 +1232,23 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
           }
 
           /* if buffer completely writtten */
-          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= 512) {
-            off_t logical_sector;
-            off_t ret;
-
-            if (!calculate_logical_address(channel, &logical_sector)) {
-              BX_ERROR(("write reached invalid sector %lu, aborting", (unsigned long)logical_sector));
-              command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
-              return;
-            }
-            ret = BX_SELECTED_DRIVE(channel).hard_drive->lseek(logical_sector * 512, SEEK_SET);
-            if (ret < 0) {
-              BX_ERROR(("could not lseek() hard drive image file at byte %lu", (unsigned long)logical_sector * 512));
-              command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
-              return;
-            }
-            /* set status bar conditions for device */
-            if (!BX_SELECTED_DRIVE(channel).iolight_counter)
-              bx_gui->statusbar_setitem(BX_SELECTED_DRIVE(channel).statusbar_id, 1);
-            BX_SELECTED_DRIVE(channel).iolight_counter = 5;
-            bx_pc_system.activate_timer( BX_HD_THIS iolight_timer_index, 100000, 0 );
-            ret = BX_SELECTED_DRIVE(channel).hard_drive->write((bx_ptr_t) BX_SELECTED_CONTROLLER(channel).buffer, 512);
-            if (ret < 512) {
-              BX_ERROR(("could not write() hard drive image file at byte %lu", (unsigned long)logical_sector*512));
-              command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+          if (BX_SELECTED_CONTROLLER(channel).buffer_index >= BX_SELECTED_CONTROLLER(channel).buffer_size) {
+            /* write the block and update sector count, sector number,
+             * cylinder, drive, head
+             */
+            if (!pio_write_block(channel, BX_SELECTED_CONTROLLER(channel).buffer_size / 512))
               return;
-            }
 
             BX_SELECTED_CONTROLLER(channel).buffer_index = 0;
 
-            /* update sector count, sector number, cylinder,
-             * drive, head, status
-             * if there are more sectors, read next one in...
-             */
-
-            increment_address(channel);
-
             /* When the write is complete, controller clears the DRQ bit and
              * sets the BSY bit.
-             * If at least one more sector is to be written, controller sets DRQ bit,
+             * If at least one more block is to be written, controller sets DRQ bit,
              * clears BSY bit, and issues IRQ 
              */
 
             if (BX_SELECTED_CONTROLLER(channel).sector_count!=0) {
+              BX_SELECTED_CONTROLLER(channel).buffer_size = pio_block_size(channel);
               BX_SELECTED_CONTROLLER(channel).status.busy = 0;
               BX_SELECTED_CONTROLLER(channel).status.drive_ready = 1;
               BX_SELECTED_CONTROLLER(channel).status.drq = 1;
@@ -1981,6 +1955,8 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
         break;
       // Writes to the command register clear the IRQ
       DEV_pic_lower_irq(BX_HD_THIS channels[channel].irq);
+      // and end the lifetime of data read ahead for the previous command
+      BX_HD_THIS channels[channel].prefetch_count = 0;
 
       if (BX_SELECTED_CONTROLLER(channel).status.busy)
         BX_PANIC(("hard disk: command sent, controller BUSY"));
@@ -2019,13 +1995,15 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
           raise_interrupt(channel);
           break;
 
-        case 0x20: // READ MULTIPLE SECTORS, with retries
-        case 0x21: // READ MULTIPLE SECTORS, without retries
+        case 0x20: // READ SECTORS, with retries
+        case 0x21: // READ SECTORS, without retries
+        case 0xC4: // READ MULTIPLE SECTORS
           /* update sector_no, always points to current sector
-           * after each sector is read to buffer, DRQ bit set and issue IRQ 
+           * after each block is read to buffer, DRQ bit set and issue IRQ 
            * if interrupt handler transfers all data words into main memory,
            * and more sectors to read, then set BSY bit again, clear DRQ and
-           * read next sector into buffer
+           * read next block into buffer
+           * a block is one sector, or sectors_per_block for READ MULTIPLE
            * sector count of 0 means 256 sectors
            */
 
@@ -2035,6 +2013,12 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
             command_aborted(channel, value);
             break;
           }
+          if ((value == 0xC4) && (BX_SELECTED_CONTROLLER(channel).sectors_per_block == 0)) {
+            BX_ERROR(("ata%d-%d: read multiple issued with multiple mode disabled",
+              channel, BX_SLAVE_SELECTED(channel)));
+            command_aborted(channel, value);
+            break;
+          }
 
           BX_SELECTED_CONTROLLER(channel).current_command = value;
 
@@ -2049,29 +2033,9 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
             break;
           }
 
-	  if (!calculate_logical_address(channel, &logical_sector)) {
-	    BX_ERROR(("initial read from sector %lu out of bounds, aborting", (unsigned long)logical_sector));
-	    command_aborted(channel, value);
-	    break;
-	  }
-	  ret=BX_SELECTED_DRIVE(channel).hard_drive->lseek(logical_sector * 512, SEEK_SET);
-          if (ret < 0) {
-            BX_ERROR (("could not lseek() hard drive image file, aborting"));
-	    command_aborted(channel, value);
+          BX_SELECTED_CONTROLLER(channel).buffer_size = pio_block_size(channel);
+	  if (!pio_read_block(channel, BX_SELECTED_CONTROLLER(channel).buffer_size / 512))
 	    break;
-	  }
-          /* set status bar conditions for device */
-          if (!BX_SELECTED_DRIVE(channel).iolight_counter)
-            bx_gui->statusbar_setitem(BX_SELECTED_DRIVE(channel).statusbar_id, 1);
-          BX_SELECTED_DRIVE(channel).iolight_counter = 5;
-          bx_pc_system.activate_timer( BX_HD_THIS iolight_timer_index, 100000, 0 );
-	  ret = BX_SELECTED_DRIVE(channel).hard_drive->read((bx_ptr_t) BX_SELECTED_CONTROLLER(channel).buffer, 512);
-          if (ret < 512) {
-            BX_ERROR(("logical sector was %lu", (unsigned long)logical_sector));
-            BX_ERROR(("could not read() hard drive image file at byte %lu", (unsigned long)logical_sector*512));
-	    command_aborted(channel, value);
-	    break;
-	  }
 
           BX_SELECTED_CONTROLLER(channel).error_register = 0;
           BX_SELECTED_CONTROLLER(channel).status.busy  = 0;
@@ -2085,11 +2049,12 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
           break;
 
         case 0x30: /* WRITE SECTORS, with retries */
+        case 0xC5: /* WRITE MULTIPLE SECTORS */
           /* update sector_no, always points to current sector
-           * after each sector is read to buffer, DRQ bit set and issue IRQ 
+           * after each block is read to buffer, DRQ bit set and issue IRQ 
            * if interrupt handler transfers all data words into main memory,
            * and more sectors to read, then set BSY bit again, clear DRQ and
-           * read next sector into buffer
+           * read next block into buffer
            * sector count of 0 means 256 sectors
            */
 
@@ -2105,7 +2070,14 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
             command_aborted(channel, value);
             break;
           }
+          if ((value == 0xC5) && (BX_SELECTED_CONTROLLER(channel).sectors_per_block == 0)) {
+            BX_ERROR(("ata%d-%d: write multiple issued with multiple mode disabled",
+              channel, BX_SLAVE_SELECTED(channel)));
+            command_aborted(channel, value);
+            break;
+          }
           BX_SELECTED_CONTROLLER(channel).current_command = value;
+          BX_SELECTED_CONTROLLER(channel).buffer_size = pio_block_size(channel);
 
           // implicit seek done :^)
           BX_SELECTED_CONTROLLER(channel).error_register = 0;
@@ -2256,14 +2228,14 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
           break;
 
 	case 0xc6: // SET MULTIPLE MODE (mch)
-	      if (BX_SELECTED_CONTROLLER(channel).sector_count != 128 &&
-		  BX_SELECTED_CONTROLLER(channel).sector_count != 64 &&
-		  BX_SELECTED_CONTROLLER(channel).sector_count != 32 &&
-		  BX_SELECTED_CONTROLLER(channel).sector_count != 16 &&
-		  BX_SELECTED_CONTROLLER(channel).sector_count != 8 &&
-		  BX_SELECTED_CONTROLLER(channel).sector_count != 4 &&
-		  BX_SELECTED_CONTROLLER(channel).sector_count != 2)
-		    command_aborted(channel, value);
+	      // block size must be a power of 2 no larger than the one
+	      // reported in identify word 47, 0 disables multiple mode
+	      if ((BX_SELECTED_CONTROLLER(channel).sector_count > BX_MAX_MULTIPLE_SECTORS) ||
+		  (BX_SELECTED_CONTROLLER(channel).sector_count &
+		   (BX_SELECTED_CONTROLLER(channel).sector_count - 1))) {
+		command_aborted(channel, value);
+		break;
+	      }
 
 	      if (!BX_SELECTED_IS_HD(channel))
 		BX_PANIC(("set multiple mode issued to non-disk"));
@@ -2455,8 +2427,6 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
 	case 0xB0: BX_ERROR(("write cmd 0xB0 (SMART commands) not supported"));command_aborted(channel, 0xB0); break;
 	case 0xB1: BX_ERROR(("write cmd 0xB1 (DEVICE CONFIGURATION commands) not supported"));command_aborted(channel, 0xB1); break;
 	case 0xC0: BX_ERROR(("write cmd 0xC0 (CFA ERASE SECTORS) not supported"));command_aborted(channel, 0xC0); break;
-	case 0xC4: BX_ERROR(("write cmd 0xC4 (READ MULTIPLE) not supported"));command_aborted(channel, 0xC4); break;
-	case 0xC5: BX_ERROR(("write cmd 0xC5 (WRITE MULTIPLE) not supported"));command_aborted(channel, 0xC5); break;
 	case 0xC7: BX_ERROR(("write cmd 0xC7 (READ DMA QUEUED) not supported"));command_aborted(channel, 0xC7); break;
 	case 0xC9: BX_ERROR(("write cmd 0xC9 (READ DMA NO RETRY) not supported")); command_aborted(channel, 0xC9); break;
 	case 0xCC: BX_ERROR(("write cmd 0xCC (WRITE DMA QUEUED) not supported"));command_aborted(channel, 0xCC); break;
@@ -2529,7 +2499,7 @@ bx_hard_drive_c::write(Bit32u address, Bit32u value, unsigned io_len)
           BX_CONTROLLER(channel,id).current_command = 0x00;
           BX_CONTROLLER(channel,id).buffer_index = 0;
 
-          BX_CONTROLLER(channel,id).sectors_per_block = 0x80;
+          BX_CONTROLLER(channel,id).sectors_per_block = BX_MAX_MULTIPLE_SECTORS;
           BX_CONTROLLER(channel,id).lba_mode          = 0;
 
           BX_CONTROLLER(channel,id).control.disable_irq = 0;
@@ -2624,6 +2594,185 @@ bx_hard_drive_c::increment_address(Bit8u channel)
   }
 }
 
+// Move 'count' consecutive sectors starting at the current address between
+// the image and 'buffer' with a single lseek() and read() or write().  Only
+// used for images that accept transfers of more than one sector, or with
+// count == 1.
+  bx_bool
+bx_hard_drive_c::transfer_sectors(Bit8u channel, Bit8u *buffer, Bit32u count, bx_bool write)
+{
+  off_t logical_sector;
+  off_t ret;
+  ssize_t len = count * 512;
+
+  if (!calculate_logical_address(channel, &logical_sector)) {
+    BX_ERROR(("multi sector transfer reached invalid sector %lu, aborting", (unsigned long)logical_sector));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  Bit32u sector_count =
+    (Bit32u)BX_SELECTED_DRIVE(channel).hard_drive->cylinders *
+    (Bit32u)BX_SELECTED_DRIVE(channel).hard_drive->heads *
+    (Bit32u)BX_SELECTED_DRIVE(channel).hard_drive->sectors;
+  if ((logical_sector + count) > sector_count) {
+    BX_ERROR(("multi sector transfer of %u sectors at %lu beyond end of disk, aborting",
+              count, (unsigned long)logical_sector));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  ret = BX_SELECTED_DRIVE(channel).hard_drive->lseek(logical_sector * 512, SEEK_SET);
+  if (ret < 0) {
+    BX_ERROR(("could not lseek() hard drive image file"));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  /* set status bar conditions for device */
+  if (!BX_SELECTED_DRIVE(channel).iolight_counter)
+    bx_gui->statusbar_setitem(BX_SELECTED_DRIVE(channel).statusbar_id, 1);
+  BX_SELECTED_DRIVE(channel).iolight_counter = 5;
+  bx_pc_system.activate_timer( BX_HD_THIS iolight_timer_index, 100000, 0 );
+  if (write) {
+    ret = BX_SELECTED_DRIVE(channel).hard_drive->write((bx_ptr_t) buffer, len);
+  } else {
+    ret = BX_SELECTED_DRIVE(channel).hard_drive->read((bx_ptr_t) buffer, len);
+  }
+  if (ret < len) {
+    BX_ERROR(("could not %s() %u sectors of hard drive image file at byte %lu",
+              write ? "write" : "read", count, (unsigned long)logical_sector*512));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  while (count-- > 0)
+    increment_address(channel);
+  return 1;
+}
+
+// Size in bytes of the next data block of a PIO command: one sector for
+// READ/WRITE SECTORS, sectors_per_block (or what is left of the command)
+// for READ/WRITE MULTIPLE.
+  Bit32u
+bx_hard_drive_c::pio_block_size(Bit8u channel)
+{
+  Bit32u remaining = BX_SELECTED_CONTROLLER(channel).sector_count;
+  Bit32u count;
+
+  if (remaining == 0) remaining = 256;
+  switch (BX_SELECTED_CONTROLLER(channel).current_command) {
+    case 0xC4:
+    case 0xC5:
+      count = BX_SELECTED_CONTROLLER(channel).sectors_per_block;
+      if (count > remaining) count = remaining;
+      break;
+    default:
+      count = 1;
+  }
+  return count * 512;
+}
+
+// Fill the controller buffer with 'count' sectors starting at the current
+// address, without advancing it.  For bulk_io images the rest of the
+// command is read from the image at once into the channel read-ahead
+// buffer, so a multi-sector command costs one lseek() and read() no
+// matter how the guest splits it into blocks.
+  bx_bool
+bx_hard_drive_c::pio_read_block(Bit8u channel, Bit32u count)
+{
+  off_t logical_sector;
+  off_t ret;
+  Bit8u *buffer = BX_SELECTED_CONTROLLER(channel).buffer;
+
+  if (!calculate_logical_address(channel, &logical_sector)) {
+    BX_ERROR(("PIO read from sector %lu out of bounds, aborting", (unsigned long)logical_sector));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  /* set status bar conditions for device */
+  if (!BX_SELECTED_DRIVE(channel).iolight_counter)
+    bx_gui->statusbar_setitem(BX_SELECTED_DRIVE(channel).statusbar_id, 1);
+  BX_SELECTED_DRIVE(channel).iolight_counter = 5;
+  bx_pc_system.activate_timer( BX_HD_THIS iolight_timer_index, 100000, 0 );
+
+  if (BX_SELECTED_DRIVE(channel).bulk_io &&
+      (BX_HD_THIS channels[channel].prefetch != NULL)) {
+    if ((BX_HD_THIS channels[channel].prefetch_count == 0) ||
+        (BX_HD_THIS channels[channel].prefetch_drive != BX_HD_THIS channels[channel].drive_select) ||
+        (logical_sector < BX_HD_THIS channels[channel].prefetch_sector) ||
+        ((logical_sector + count) > (BX_HD_THIS channels[channel].prefetch_sector +
+                                     BX_HD_THIS channels[channel].prefetch_count))) {
+      Bit32u disk_sectors =
+        (Bit32u)BX_SELECTED_DRIVE(channel).hard_drive->cylinders *
+        (Bit32u)BX_SELECTED_DRIVE(channel).hard_drive->heads *
+        (Bit32u)BX_SELECTED_DRIVE(channel).hard_drive->sectors;
+      Bit32u total = BX_SELECTED_CONTROLLER(channel).sector_count;
+
+      if (total == 0) total = 256;
+      if (total > BX_HD_PREFETCH_SECTORS) total = BX_HD_PREFETCH_SECTORS;
+      if ((logical_sector + total) > disk_sectors)
+        total = (Bit32u)(disk_sectors - logical_sector);
+      if (total < count) {
+        BX_ERROR(("PIO read of %u sectors at %lu beyond end of disk, aborting",
+                  count, (unsigned long)logical_sector));
+        command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+        return 0;
+      }
+      BX_HD_THIS channels[channel].prefetch_count = 0;
+      ret = BX_SELECTED_DRIVE(channel).hard_drive->lseek(logical_sector * 512, SEEK_SET);
+      if (ret < 0) {
+        BX_ERROR(("could not lseek() hard drive image file"));
+        command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+        return 0;
+      }
+      ret = BX_SELECTED_DRIVE(channel).hard_drive->read((bx_ptr_t) BX_HD_THIS channels[channel].prefetch, total * 512);
+      if (ret < (off_t)(total * 512)) {
+        BX_ERROR(("could not read() %u sectors of hard drive image file at byte %lu",
+                  total, (unsigned long)logical_sector*512));
+        command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+        return 0;
+      }
+      BX_HD_THIS channels[channel].prefetch_drive  = BX_HD_THIS channels[channel].drive_select;
+      BX_HD_THIS channels[channel].prefetch_sector = logical_sector;
+      BX_HD_THIS channels[channel].prefetch_count  = total;
+    }
+    memcpy(buffer, BX_HD_THIS channels[channel].prefetch +
+           (logical_sector - BX_HD_THIS channels[channel].prefetch_sector) * 512,
+           count * 512);
+    return 1;
+  }
+
+  for (Bit32u i = 0; i < count; i++, logical_sector++) {
+    ret = BX_SELECTED_DRIVE(channel).hard_drive->lseek(logical_sector * 512, SEEK_SET);
+    if (ret < 0) {
+      BX_ERROR(("could not lseek() hard drive image file"));
+      command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+      return 0;
+    }
+    ret = BX_SELECTED_DRIVE(channel).hard_drive->read((bx_ptr_t) (buffer + i * 512), 512);
+    if (ret < 512) {
+      BX_ERROR(("logical sector was %lu", (unsigned long)logical_sector));
+      BX_ERROR(("could not read() hard drive image file at byte %lu", (unsigned long)logical_sector*512));
+      command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Write 'count' sectors from the controller buffer and advance the address.
+  bx_bool
+bx_hard_drive_c::pio_write_block(Bit8u channel, Bit32u count)
+{
+  Bit8u *buffer = BX_SELECTED_CONTROLLER(channel).buffer;
+
+  if (BX_SELECTED_DRIVE(channel).bulk_io || (count == 1))
+    return transfer_sectors(channel, buffer, count, 1);
+
+  for (Bit32u i = 0; i < count; i++) {
+    if (!transfer_sectors(channel, buffer + i * 512, 1, 1))
+      return 0;
+  }
+  return 1;
+}
+
   void
 bx_hard_drive_c::identify_ATAPI_drive(Bit8u channel)
 {
@@ -2773,7 +2922,7 @@ bx_hard_drive_c::identify_drive(Bit8u channel)
   }
   BX_ASSERT((27+i) == 47);
 
-  BX_SELECTED_DRIVE(channel).id_drive[47] = 0x8080; // multiple mode identification
+  BX_SELECTED_DRIVE(channel).id_drive[47] = 0x8000 | BX_MAX_MULTIPLE_SECTORS; // multiple mode identification
   BX_SELECTED_DRIVE(channel).id_drive[48] = 0;
   BX_SELECTED_DRIVE(channel).id_drive[49] = 0x0f01;
 
@@ -2789,7 +2938,10 @@ bx_hard_drive_c::identify_drive(Bit8u channel)
 
   BX_SELECTED_DRIVE(channel).id_drive[57] = 0x1e80;
   BX_SELECTED_DRIVE(channel).id_drive[58] = 0x0010;
-  BX_SELECTED_DRIVE(channel).id_drive[59] = 0x0100 | BX_SELECTED_CONTROLLER(channel).sectors_per_block;
+  if (BX_SELECTED_CONTROLLER(channel).sectors_per_block)
+    BX_SELECTED_DRIVE(channel).id_drive[59] = 0x0100 | BX_SELECTED_CONTROLLER(channel).sectors_per_block;
+  else
+    BX_SELECTED_DRIVE(channel).id_drive[59] = 0;
   BX_SELECTED_DRIVE(channel).id_drive[60] = 0x20e0;
   BX_SELECTED_DRIVE(channel).id_drive[61] = 0x0010;
 
@@ -3434,6 +3586,36 @@ bx_hard_drive_c::bmdma_write_sector(Bit8u channel, Bit8u *buffer)
   return 1;
 }
 
+  bx_bool
+bx_hard_drive_c::bmdma_bulk_io(Bit8u channel)
+{
+  return BX_SELECTED_IS_HD(channel) && BX_SELECTED_DRIVE(channel).bulk_io &&
+         ((BX_SELECTED_CONTROLLER(channel).current_command == 0xC8) ||
+          (BX_SELECTED_CONTROLLER(channel).current_command == 0xCA));
+}
+
+  bx_bool
+bx_hard_drive_c::bmdma_read_sectors(Bit8u channel, Bit8u *buffer, Bit32u count)
+{
+  if (BX_SELECTED_CONTROLLER(channel).current_command != 0xC8) {
+    BX_ERROR(("command 0xC8 (READ DMA) not active"));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  return transfer_sectors(channel, buffer, count, 0);
+}
+
+  bx_bool
+bx_hard_drive_c::bmdma_write_sectors(Bit8u channel, Bit8u *buffer, Bit32u count)
+{
+  if (BX_SELECTED_CONTROLLER(channel).current_command != 0xCA) {
+    BX_ERROR(("command 0xCA (WRITE DMA) not active"));
+    command_aborted (channel, BX_SELECTED_CONTROLLER(channel).current_command);
+    return 0;
+  }
+  return transfer_sectors(channel, buffer, count, 1);
+}
+
   void
 bx_hard_drive_c::bmdma_complete(Bit8u channel)
 {
@@ -40,6 +40,12 @@ typedef enum _asc {
 class device_image_t;
 class LOWLEVEL_CDROM;
 
+// largest block size reported in IDENTIFY word 47 and accepted by
+// SET MULTIPLE MODE
+#define BX_MAX_MULTIPLE_SECTORS 16
+// sectors fetched from an image in one go for a PIO read command
+#define BX_HD_PREFETCH_SECTORS  256
+
 typedef struct {
   struct {
     bx_bool busy;
@@ -75,7 +81,7 @@ typedef struct {
     Bit16u   cylinder_no;
     Bit16u   byte_count;
   };
-  Bit8u    buffer[2352];
+  Bit8u    buffer[BX_MAX_MULTIPLE_SECTORS * 512]; // >= 2352 for ATAPI
   Bit32u   buffer_size;
   Bit32u   buffer_index;
   Bit32u   drq_index;
@@ -166,6 +172,9 @@ public:
 #if BX_SUPPORT_PCI
   virtual bx_bool  bmdma_read_sector(Bit8u channel, Bit8u *buffer, Bit32u *sector_size);
   virtual bx_bool  bmdma_write_sector(Bit8u channel, Bit8u *buffer);
+  virtual bx_bool  bmdma_bulk_io(Bit8u channel);
+  virtual bx_bool  bmdma_read_sectors(Bit8u channel, Bit8u *buffer, Bit32u count);
+  virtual bx_bool  bmdma_write_sectors(Bit8u channel, Bit8u *buffer, Bit32u count);
   virtual void     bmdma_complete(Bit8u channel);
 #endif
 
@@ -192,6 +201,10 @@ private:
 
   BX_HD_SMF bx_bool calculate_logical_address(Bit8u channel, off_t *sector) BX_CPP_AttrRegparmN(2);
   BX_HD_SMF void increment_address(Bit8u channel) BX_CPP_AttrRegparmN(1);
+  BX_HD_SMF bx_bool transfer_sectors(Bit8u channel, Bit8u *buffer, Bit32u count, bx_bool write);
+  BX_HD_SMF bx_bool pio_read_block(Bit8u channel, Bit32u count);
+  BX_HD_SMF bx_bool pio_write_block(Bit8u channel, Bit32u count);
+  BX_HD_SMF Bit32u  pio_block_size(Bit8u channel);
   BX_HD_SMF void identify_drive(Bit8u channel);
   BX_HD_SMF void identify_ATAPI_drive(Bit8u channel);
   BX_HD_SMF void command_aborted(Bit8u channel, unsigned command);
@@ -226,6 +239,8 @@ private:
       Bit8u model_no[41];
       int statusbar_id;
       int iolight_counter;
+      // the image accepts read()/write() of several sectors at once
+      bx_bool bulk_io;
       } drives[2];
     unsigned drive_select;
 
@@ -233,6 +248,13 @@ private:
     Bit16u ioaddr2;
     Bit8u  irq;
 
+    // read-ahead for the PIO read command in progress on this channel,
+    // only allocated if one of the drives has a bulk_io image
+    Bit8u *prefetch;
+    unsigned prefetch_drive;
+    off_t  prefetch_sector;
+    Bit32u prefetch_count;
+
     } channels[BX_MAX_ATA_CHANNEL];
 
   int iolight_timer_index;
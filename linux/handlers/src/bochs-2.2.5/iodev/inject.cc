@@ -0,0 +1,179 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+
+// Define BX_PLUGGABLE in files that can be compiled into plugins.  For
+// platforms that require a special tag on exported symbols, BX_PLUGGABLE
+// is used to know when we are exporting symbols and when we are importing.
+#define BX_PLUGGABLE
+
+#include "iodev.h"
+
+#if !defined(WIN32)
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+  Bit32u
+bx_inject_queue_c::put(const Bit8u *data, Bit32u len)
+{
+  Bit32u t = tail;
+  Bit32u room = BX_INJECT_QSIZE - (t - head);
+  if (len > room) len = room;
+  for (Bit32u i = 0; i < len; i++) {
+    buffer[(t + i) & (BX_INJECT_QSIZE - 1)] = data[i];
+  }
+  // the data must be visible before the consumer sees the new tail
+  BX_INJECT_BARRIER();
+  tail = t + len;
+  return len;
+}
+
+  bx_bool
+bx_inject_queue_c::peek(Bit8u *data) const
+{
+  Bit32u h = head;
+  if (h == tail) return 0;
+  BX_INJECT_BARRIER();
+  *data = buffer[h & (BX_INJECT_QSIZE - 1)];
+  return 1;
+}
+
+  bx_bool
+bx_inject_queue_c::get(Bit8u *data)
+{
+  bx_bool replayed = (replay_unit != BX_REPLAY_UNIT_NONE);
+  bx_bool ready = 0;
+
+  // a replayed queue ignores what the host puts into it
+  if ((!replayed || !bx_replay.replaying()) && peek(data)) {
+    // the slot must be read before the producer may reuse it
+    BX_INJECT_BARRIER();
+    head = head + 1;
+    ready = 1;
+  }
+  if (replayed)
+    ready = bx_replay.poll(BX_REPLAY_INJECT_GET, replay_unit, ready, data);
+  return ready;
+}
+
+  bx_bool
+bx_inject_queue_c::empty(void)
+{
+  bx_bool replayed = (replay_unit != BX_REPLAY_UNIT_NONE);
+  bx_bool ready = 0;
+
+  if (!replayed || !bx_replay.replaying())
+    ready = (tail != head);
+  if (replayed)
+    ready = bx_replay.poll(BX_REPLAY_INJECT_AVAIL, replay_unit, ready, NULL);
+  return !ready;
+}
+
+
+#if !defined(WIN32)
+static void *inject_feeder_thread(void *this_ptr)
+{
+  ((bx_inject_feeder_c *) this_ptr)->feeder_thread();
+  return NULL;
+}
+#endif
+
+bx_inject_feeder_c::bx_inject_feeder_c(bx_inject_queue_c *q, int fd)
+{
+  this->queue = q;
+  this->fd = fd;
+  thread_active = 0;
+  thread_quit = 0;
+}
+
+bx_inject_feeder_c::~bx_inject_feeder_c(void)
+{
+  stop();
+}
+
+  bx_bool
+bx_inject_feeder_c::start(void)
+{
+#if !defined(WIN32)
+  if (thread_active || (fd < 0)) return 0;
+  thread_quit = 0;
+  thread_active = 1;
+  if (pthread_create(&thread, NULL, inject_feeder_thread, this) != 0) {
+    thread_active = 0;
+  }
+  return thread_active;
+#else
+  return 0;
+#endif
+}
+
+  void
+bx_inject_feeder_c::stop(void)
+{
+#if !defined(WIN32)
+  if (thread_active) {
+    thread_quit = 1;
+    pthread_join(thread, NULL);
+    thread_active = 0;
+  }
+#endif
+}
+
+// The feeder waits with a timeout so that stop() never has to interrupt
+// a blocking read.  While the queue is full the guest has not consumed
+// the previous input yet; back off and let it catch up.
+  void
+bx_inject_feeder_c::feeder_thread(void)
+{
+#if !defined(WIN32)
+  Bit8u buf[512];
+  struct timeval tval;
+  fd_set fds;
+
+  while (!thread_quit) {
+    tval.tv_sec  = 0;
+    tval.tv_usec = 100000;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    int ret = select(fd + 1, &fds, NULL, NULL, &tval);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    if (ret == 0) continue;
+    ssize_t len = ::read(fd, buf, sizeof(buf));
+    if (len < 0) {
+      if ((errno == EINTR) || (errno == EAGAIN)) continue;
+      break;
+    }
+    if (len == 0) {
+      // end of file or pipe without writer: wait for more data
+      usleep(100000);
+      continue;
+    }
+    Bit32u done = 0;
+    while ((done < (Bit32u) len) && !thread_quit) {
+      done += queue->put(buf + done, len - done);
+      if (done < (Bit32u) len) usleep(1000);
+    }
+  }
+#endif
+}
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Input injection for the keyboard and serial devices.
+//
+// A bx_inject_queue_c is a lock-free byte queue with exactly one producer
+// and exactly one consumer.  The producer is a host thread (a feeder
+// reading a pipe, a socket or a tty, or a GUI/test harness thread) and the
+// consumer is the device model running in the simulation thread.  The
+// device only takes bytes out of the queue when the guest has made room
+// for them in the emulated hardware buffer, so the producer is throttled
+// by guest consumption: put() accepts fewer bytes than offered when the
+// queue is full and the producer simply retries later.
+//
+// What the consumer sees of a queue with a replay unit is host input for
+// the record/replay layer (see replay.h): get() and empty() are logged
+// when recording and answered from the log when replaying.
+
+#ifndef BX_IODEV_INJECT_H
+#define BX_IODEV_INJECT_H
+
+#if !defined(WIN32)
+#include <pthread.h>
+#endif
+
+#define BX_INJECT_QSIZE 4096   // must be a power of 2
+
+#if defined(__GNUC__)
+#  define BX_INJECT_BARRIER() __sync_synchronize()
+#elif defined(_MSC_VER)
+#  define BX_INJECT_BARRIER() MemoryBarrier()
+#else
+#  define BX_INJECT_BARRIER()
+#endif
+
+class bx_inject_queue_c {
+public:
+  bx_inject_queue_c(void) : head(0), tail(0), replay_unit(BX_REPLAY_UNIT_NONE) {}
+  void set_replay_unit(unsigned unit) { replay_unit = unit; }
+
+  // producer side
+  Bit32u put(const Bit8u *data, Bit32u len);
+  Bit32u free_space(void) const { return BX_INJECT_QSIZE - used(); }
+
+  // consumer side
+  Bit32u used(void) const { return tail - head; }
+  bx_bool empty(void);
+  bx_bool peek(Bit8u *data) const;
+  bx_bool get(Bit8u *data);
+  void   flush(void) { head = tail; }
+
+private:
+  Bit8u buffer[BX_INJECT_QSIZE];
+  // Free running counters; only the consumer writes head and only the
+  // producer writes tail.
+  volatile Bit32u head;
+  volatile Bit32u tail;
+  unsigned replay_unit;
+};
+
+// Host thread that copies everything readable from a file descriptor
+// into an injection queue, waiting while the queue is full.
+class bx_inject_feeder_c {
+public:
+  bx_inject_feeder_c(bx_inject_queue_c *q, int fd);
+  ~bx_inject_feeder_c(void);
+  bx_bool start(void);
+  void    stop(void);
+  bx_bool active(void) const { return thread_active; }
+  void    feeder_thread(void);
+
+private:
+  bx_inject_queue_c *queue;
+  int fd;
+  volatile bx_bool thread_active;
+  volatile bx_bool thread_quit;
+#if !defined(WIN32)
+  pthread_t thread;
+#endif
+};
+
+#endif // BX_IODEV_INJECT_H
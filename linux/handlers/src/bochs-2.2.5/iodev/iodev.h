@@ -109,6 +109,10 @@ class BOCHSAPI bx_keyb_stub_c : public bx_devmodel_c {
   virtual void paste_bytes(Bit8u *data, Bit32s length) {
     STUBFUNC(keyboard, paste_bytes);
   }
+  virtual Bit32u inject_bytes(const Bit8u *data, Bit32u length) {
+    STUBFUNC(keyboard, inject_bytes);
+    return 0;
+  }
 };
 
 class BOCHSAPI bx_hard_drive_stub_c : public bx_devmodel_c {
@@ -149,6 +153,15 @@ class BOCHSAPI bx_hard_drive_stub_c : public bx_devmodel_c {
   virtual bx_bool bmdma_write_sector(Bit8u channel, Bit8u *buffer) {
     STUBFUNC(HD, bmdma_write_sector); return 0;
   }
+  virtual bx_bool bmdma_bulk_io(Bit8u channel) {
+    return 0;
+  }
+  virtual bx_bool bmdma_read_sectors(Bit8u channel, Bit8u *buffer, Bit32u count) {
+    STUBFUNC(HD, bmdma_read_sectors); return 0;
+  }
+  virtual bx_bool bmdma_write_sectors(Bit8u channel, Bit8u *buffer, Bit32u count) {
+    STUBFUNC(HD, bmdma_write_sectors); return 0;
+  }
   virtual void bmdma_complete(Bit8u channel) {
     STUBFUNC(HD, bmdma_complete);
   }
@@ -324,6 +337,10 @@ class BOCHSAPI bx_serial_stub_c : public bx_devmodel_c {
   virtual void serial_mouse_enq(int delta_x, int delta_y, int delta_z, unsigned button_state) {
     STUBFUNC(serial, serial_mouse_enq);
   }
+  virtual Bit32u inject_bytes(unsigned port, const Bit8u *data, Bit32u length) {
+    STUBFUNC(serial, inject_bytes);
+    return 0;
+  }
 };
 
 #if BX_SUPPORT_PCIUSB
@@ -398,6 +415,11 @@ public:
   static void timer_handler(void *);
   void timer(void);
 
+#if BX_SUPPORT_STATS
+  void   init_stats(bx_list_c *parent);
+  Bit64u get_io_count(bx_bool write, const char *name);
+#endif
+
   bx_devmodel_c     *pluginBiosDevice;
   bx_ioapic_c       *ioapic;
   bx_pci_stub_c     *pluginPciBridge;
@@ -475,6 +497,9 @@ private:
 	const char *handler_name;  // name of device
 	int usage_count;
 	Bit8u mask;          // io_len mask
+#if BX_SUPPORT_STATS
+	Bit64u count;        // accesses routed to this handler
+#endif
   };
   struct io_handler_struct io_read_handlers;
   struct io_handler_struct io_write_handlers;
@@ -516,6 +541,7 @@ private:
 #include "iodev/pciusb.h"
 #endif
 #endif
+#include "iodev/inject.h"
 #include "iodev/vga.h"
 #if BX_SUPPORT_APIC
 #  include "iodev/ioapic.h"
@@ -86,11 +86,22 @@ bx_keyb_c::bx_keyb_c(void)
   // constructor
   put("KBD");
   settype(KBDLOG);
+  inject_feeder = NULL;
+  inject_fd = -1;
+  inject_q.set_replay_unit(BX_REPLAY_UNIT_KBD);
 }
 
 bx_keyb_c::~bx_keyb_c(void)
 {
   // destructor
+  if (inject_feeder != NULL) {
+    delete inject_feeder;
+    inject_feeder = NULL;
+  }
+  if (inject_fd >= 0) {
+    ::close(inject_fd);
+    inject_fd = -1;
+  }
   BX_DEBUG(("Exit."));
 }
 
@@ -202,6 +213,38 @@ bx_keyb_c::init(void)
   BX_KEY_THIS paste_delay_changed(bx_options.Okeyboard_paste_delay->get());
   BX_KEY_THIS stop_paste = 0;
 
+  // start the input injection feeder (if configured).  A replay takes
+  // the injected characters from the log.
+  if (bx_replay.replaying() &&
+      (strlen(bx_options.Okeyboard_inject->getptr()) > 0)) {
+    if (!bx_keymap.isKeymapLoaded()) {
+      bx_keymap.loadKeymap(NULL);
+    }
+  } else if ((BX_KEY_THIS inject_feeder == NULL) &&
+      (strlen(bx_options.Okeyboard_inject->getptr()) > 0)) {
+#if !defined(WIN32)
+    BX_KEY_THIS inject_fd = ::open(bx_options.Okeyboard_inject->getptr(), O_RDONLY | O_NONBLOCK);
+#endif
+    if (BX_KEY_THIS inject_fd < 0) {
+      BX_PANIC(("could not open keyboard inject file '%s'",
+                bx_options.Okeyboard_inject->getptr()));
+    } else {
+      BX_KEY_THIS inject_feeder = new bx_inject_feeder_c(&BX_KEY_THIS inject_q,
+                                                         BX_KEY_THIS inject_fd);
+      // Characters are translated through the keymap.  Text mode and
+      // headless guis never load it, so do it here.
+      if (!bx_keymap.isKeymapLoaded()) {
+        bx_keymap.loadKeymap(NULL);
+      }
+      if (BX_KEY_THIS inject_feeder->start()) {
+        BX_INFO(("injecting keyboard input from '%s'",
+                 bx_options.Okeyboard_inject->getptr()));
+      } else {
+        BX_ERROR(("could not start keyboard inject feeder"));
+      }
+    }
+  }
+
   // mouse port installed on system board
   DEV_cmos_set_reg(0x14, DEV_cmos_get_reg(0x14) | 0x04);
 
@@ -371,6 +414,7 @@ bx_keyb_c::read(Bit32u   address, unsigned io_len)
         }
 
       DEV_pic_lower_irq(1);
+      BX_KEY_THIS service_inject_q();
       activate_timer();
       BX_DEBUG(("READ(%02x) = %02x", (unsigned) address,
           (unsigned) val));
@@ -704,19 +748,7 @@ bx_keyb_c::service_paste_buf ()
       return;
     // there room in the buffer for a keypress and a key release.
     // send one keypress and a key release.
-    Bit8u byte = BX_KEY_THIS pastebuf[BX_KEY_THIS pastebuf_ptr];
-    BXKeyEntry *entry = bx_keymap.findAsciiChar (byte);
-    if (!entry) {
-      BX_ERROR (("paste character 0x%02x ignored", byte));
-    } else {
-      BX_DEBUG (("pasting character 0x%02x. baseKey is %04x", byte, entry->baseKey));
-      if (entry->modKey != BX_KEYMAP_UNKNOWN)
-        BX_KEY_THIS gen_scancode (entry->modKey);
-      BX_KEY_THIS gen_scancode (entry->baseKey);
-      BX_KEY_THIS gen_scancode (entry->baseKey | BX_KEY_RELEASED);
-      if (entry->modKey != BX_KEYMAP_UNKNOWN)
-        BX_KEY_THIS gen_scancode (entry->modKey | BX_KEY_RELEASED);
-    }
+    BX_KEY_THIS paste_char (BX_KEY_THIS pastebuf[BX_KEY_THIS pastebuf_ptr]);
     BX_KEY_THIS pastebuf_ptr++;
   }
   // reached end of pastebuf.  free the memory it was using.
@@ -725,6 +757,58 @@ bx_keyb_c::service_paste_buf ()
   BX_KEY_THIS stop_paste = 0;
 }
 
+// paste_char() generates the make and break codes for one ASCII char,
+// including the modifier key if the keymap requires one.
+void
+bx_keyb_c::paste_char (Bit8u byte)
+{
+  BXKeyEntry *entry = bx_keymap.findAsciiChar (byte);
+  if (!entry) {
+    BX_ERROR (("paste character 0x%02x ignored", byte));
+  } else {
+    BX_DEBUG (("pasting character 0x%02x. baseKey is %04x", byte, entry->baseKey));
+    if (entry->modKey != BX_KEYMAP_UNKNOWN)
+      BX_KEY_THIS gen_scancode (entry->modKey);
+    BX_KEY_THIS gen_scancode (entry->baseKey);
+    BX_KEY_THIS gen_scancode (entry->baseKey | BX_KEY_RELEASED);
+    if (entry->modKey != BX_KEYMAP_UNKNOWN)
+      BX_KEY_THIS gen_scancode (entry->modKey | BX_KEY_RELEASED);
+  }
+}
+
+// service_inject_q() moves characters from the injection queue to the
+// hardware keyboard buffer.  It is called from the keyboard timer and
+// every time the guest reads a scancode, so the injection rate follows
+// the rate at which the guest consumes keystrokes.  A running paste has
+// priority so that the two streams are not interleaved.
+void
+bx_keyb_c::service_inject_q ()
+{
+  Bit8u byte;
+
+  if (BX_KEY_THIS pastebuf || !BX_KEY_THIS s.kbd_controller.kbd_clock_enabled)
+    return;
+  int fill_threshold = BX_KBD_ELEMENTS - 8;
+  while (BX_KEY_THIS s.kbd_internal_buffer.num_elements < fill_threshold) {
+    if (!BX_KEY_THIS inject_q.get(&byte))
+      return;
+    BX_KEY_THIS paste_char (byte);
+  }
+}
+
+// inject_bytes() may be called from any single host thread.  It copies
+// as many bytes as currently fit into the injection queue and returns
+// that count; the caller retries with the rest once the guest caught up.
+Bit32u
+bx_keyb_c::inject_bytes (const Bit8u *bytes, Bit32u length)
+{
+  if (BX_KEY_THIS inject_feeder != NULL) {
+    // the queue has a single producer, which is the feeder thread
+    return 0;
+  }
+  return BX_KEY_THIS inject_q.put(bytes, length);
+}
+
 // paste_bytes schedules an arbitrary number of ASCII characters to be
 // inserted into the hardware queue as it become available.  Any previous
 // paste which is still in progress will be thrown out.  BYTES is a pointer
@@ -1164,6 +1248,7 @@ bx_keyb_c::periodic( Bit32u   usec_delta )
       BX_KEY_THIS service_paste_buf ();
       count_before_paste=0;
     }
+    BX_KEY_THIS service_inject_q ();
   }
 
   retval = BX_KEY_THIS s.kbd_controller.irq1_requested | (BX_KEY_THIS s.kbd_controller.irq12_requested << 1);
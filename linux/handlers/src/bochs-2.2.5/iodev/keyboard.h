@@ -56,6 +56,7 @@ public:
   // override stubs from bx_keyb_stub_c
   virtual void     gen_scancode(Bit32u key);
   virtual void     paste_bytes(Bit8u *data, Bit32s length);
+  virtual Bit32u   inject_bytes(const Bit8u *data, Bit32u length);
   virtual void     mouse_motion(int delta_x, int delta_y, int delta_z, unsigned button_state);
 
   // runtime options
@@ -66,6 +67,8 @@ public:
 private:
   BX_KEY_SMF Bit8u    get_kbd_enable(void);
   BX_KEY_SMF void     service_paste_buf ();
+  BX_KEY_SMF void     service_inject_q ();
+  BX_KEY_SMF void     paste_char (Bit8u byte);
   BX_KEY_SMF void     create_mouse_packet(bool force_enq);
   BX_KEY_SMF unsigned periodic( Bit32u   usec_delta );
 
@@ -216,6 +219,15 @@ private:
   Bit32u pastedelay;   // count before paste
   bx_bool stop_paste;  // stop the current paste operation on hardware reset
 
+  // The injection queue is the thread-safe sibling of the paste buffer.
+  // Characters are pushed by another host thread (the keyboard_inject
+  // feeder or an embedding application) and moved into the hardware
+  // buffer whenever the guest has drained enough of it, instead of
+  // waiting for the paste delay.
+  bx_inject_queue_c   inject_q;
+  bx_inject_feeder_c *inject_feeder;
+  int                 inject_fd;
+
   BX_KEY_SMF void     resetinternals(bx_bool powerup);
   BX_KEY_SMF void     set_kbd_clock_enable(Bit8u value) BX_CPP_AttrRegparmN(1);
   BX_KEY_SMF void     set_aux_clock_enable(Bit8u value);
@@ -1176,6 +1176,18 @@ bx_ne2k_c::rx_handler(void *arg, const void *buf, unsigned len)
     // BX_DEBUG(("rx_handler with length %d", len));
   bx_ne2k_c *class_ptr = (bx_ne2k_c *) arg;
   
+  if (bx_replay.net_rx(0, buf, len))
+    class_ptr->rx_frame(buf, len);
+}
+
+/*
+ * Callback from the replay log with a recorded frame
+ */
+void
+bx_ne2k_c::replay_rx_handler(void *arg, const void *buf, unsigned len)
+{
+  bx_ne2k_c *class_ptr = (bx_ne2k_c *) arg;
+
   class_ptr->rx_frame(buf, len);
 }
 
@@ -1420,6 +1432,7 @@ bx_ne2k_c::init(void)
     BX_NE2K_THIS s.macaddr[i] = 0x57;
     
   // Attach to the simulated ethernet dev
+  bx_replay.set_rx_handler(0, replay_rx_handler, this);
   char *ethmod = bx_options.ne2k.Oethmod->get_choice(bx_options.ne2k.Oethmod->get());
   BX_NE2K_THIS ethdev = eth_locator_c::create(ethmod,
                                               bx_options.ne2k.Oethdev->getptr (),
@@ -238,6 +238,7 @@ private:
   BX_NE2K_SMF void tx_timer(void);
 
   static void rx_handler(void *arg, const void *buf, unsigned len);
+  static void replay_rx_handler(void *arg, const void *buf, unsigned len);
   BX_NE2K_SMF unsigned mcast_index(const void *dst);
   BX_NE2K_SMF void rx_frame(const void *buf, unsigned io_len);
 
@@ -75,20 +75,21 @@ bx_parallel_c::init(void)
 {
   Bit16u ports[BX_PARPORT_MAXDEV] = {0x0378, 0x0278};
   Bit8u irqs[BX_PARPORT_MAXDEV] = {7, 5};
-  char name[16];
+  // the I/O handlers keep a pointer to the name
+  static char name[BX_N_PARALLEL_PORTS][20];
 
   BX_DEBUG(("Init $Id: parallel.cc,v 1.26 2004/06/19 15:20:13 sshwarts Exp $"));
 
   for (unsigned i=0; i<BX_N_PARALLEL_PORTS; i++) {
     if (bx_options.par[i].Oenabled->get ()) {
-      sprintf(name, "Parallel Port %d", i + 1);
+      sprintf(name[i], "Parallel Port %d", i + 1);
       /* parallel interrupt and i/o ports */
       BX_PAR_THIS s[i].IRQ = irqs[i];
       for (unsigned addr=ports[i]; addr<=(unsigned)(ports[i]+2); addr++) {
-        DEV_register_ioread_handler(this, read_handler, addr, name, 1);
+        DEV_register_ioread_handler(this, read_handler, addr, name[i], 1);
       }
-      DEV_register_iowrite_handler(this, write_handler, ports[i], name, 1);
-      DEV_register_iowrite_handler(this, write_handler, ports[i]+2, name, 1);
+      DEV_register_iowrite_handler(this, write_handler, ports[i], name[i], 1);
+      DEV_register_iowrite_handler(this, write_handler, ports[i]+2, name[i], 1);
       BX_INFO (("parallel port %d at 0x%04x irq %d", i+1, ports[i], irqs[i]));
       /* internal state */
       BX_PAR_THIS s[i].STATUS.error = 1;
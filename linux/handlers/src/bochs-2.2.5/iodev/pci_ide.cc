@@ -167,6 +167,8 @@ bx_pci_ide_c::timer()
   int timer_id, count;
   Bit8u channel;
   Bit32u size, sector_size = 0;
+  Bit8u *host_addr;
+  bx_bool ok;
   struct {
     Bit32u addr;
     Bit32u size;
@@ -187,7 +189,30 @@ bx_pci_ide_c::timer()
   if (size == 0) {
     size = 0x10000;
   }
-  if (BX_PIDE_THIS s.bmdma[channel].cmd_rwcon) {
+  // Zero-copy path: if the whole region is plain RAM and the drive image
+  // can do multi-sector transfers, move the region between the image and
+  // guest memory with one read() or write() and skip the bounce buffer.
+  host_addr = NULL;
+  if (((size & 0x1ff) == 0) &&
+      (BX_PIDE_THIS s.bmdma[channel].buffer_top == BX_PIDE_THIS s.bmdma[channel].buffer_idx) &&
+      DEV_hd_bmdma_bulk_io(channel)) {
+    host_addr = BX_MEM(0)->getDmaHostAddr(prd.addr, size,
+                  BX_PIDE_THIS s.bmdma[channel].cmd_rwcon ? BX_WRITE : BX_READ);
+  }
+  if (host_addr != NULL) {
+    BX_DEBUG(("%s DMA direct addr=0x%08x, size=0x%08x",
+              BX_PIDE_THIS s.bmdma[channel].cmd_rwcon ? "READ" : "WRITE", prd.addr, size));
+    if (BX_PIDE_THIS s.bmdma[channel].cmd_rwcon) {
+      ok = DEV_hd_bmdma_read_sectors(channel, host_addr, size >> 9);
+    } else {
+      ok = DEV_hd_bmdma_write_sectors(channel, host_addr, size >> 9);
+    }
+    if (!ok) {
+      BX_PIDE_THIS s.bmdma[channel].status &= ~0x01;
+      BX_PIDE_THIS s.bmdma[channel].status |= 0x06;
+      return;
+    }
+  } else if (BX_PIDE_THIS s.bmdma[channel].cmd_rwcon) {
     BX_DEBUG(("READ DMA to addr=0x%08x, size=0x%08x", prd.addr, size));
     count = size - (BX_PIDE_THIS s.bmdma[channel].buffer_top - BX_PIDE_THIS s.bmdma[channel].buffer_idx);
     while (count > 0) {
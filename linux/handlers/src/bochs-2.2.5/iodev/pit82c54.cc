@@ -892,6 +892,34 @@ Bit32u pit_82C54::get_next_event_time(void) {
   return out;
 }
 
+// Number of clocks until OUT of counter cnum next goes from 0 to 1.
+// The counter is run ahead over its next state changes and then put
+// back the way it was.  0 means no rising edge in the next
+// MAX_LOOKAHEAD changes, e.g. because the counter is stopped.
+Bit32u pit_82C54::get_next_rise_time(Bit8u cnum) {
+  if(cnum>MAX_COUNTER) {
+    BX_ERROR(("Counter number incorrect in 82C54 get_next_rise_time"));
+    return 0;
+  }
+  counter_type saved=counter[cnum];
+  bool prev_OUT=counter[cnum].OUTpin;
+  Bit32u time=0, rise=0;
+  for(int i=0;i<MAX_LOOKAHEAD;i++) {
+    Bit32u delta=counter[cnum].next_change_time;
+    if(!delta)
+      break;
+    clock_multiple(cnum, delta);
+    time+=delta;
+    if(!prev_OUT && counter[cnum].OUTpin) {
+      rise=time;
+      break;
+    }
+    prev_OUT=counter[cnum].OUTpin;
+  }
+  counter[cnum]=saved;
+  return rise;
+}
+
 Bit16u pit_82C54::get_inlatch(int counternum) {
     return counter[counternum].inlatch;
 }
@@ -36,7 +36,8 @@ private:
     MAX_COUNTER=2,
     MAX_ADDRESS=3,
     CONTROL_ADDRESS=3,
-    MAX_MODE=5
+    MAX_MODE=5,
+    MAX_LOOKAHEAD=8
   };
 
   enum real_RW_status {
@@ -126,6 +127,7 @@ public:
 
   Bit32u get_clock_event_time(Bit8u cnum);
   Bit32u get_next_event_time(void);
+  Bit32u get_next_rise_time(Bit8u cnum);
   Bit16u get_inlatch(int countnum);
 
   void print_cnum(Bit8u cnum);
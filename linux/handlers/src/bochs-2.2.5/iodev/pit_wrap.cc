@@ -126,17 +126,8 @@ bx_pit_c::init( void )
   if (BX_PIT_THIS s.timer_handle[0] == BX_NULL_TIMER_HANDLE) {
     BX_PIT_THIS s.timer_handle[0] = bx_virt_timer.register_timer(this, timer_handler, (unsigned) 100 , 1, 1, "pit_wrap");
   }
-  BX_DEBUG(("pit: RESETting timer."));
-  bx_virt_timer.deactivate_timer(BX_PIT_THIS s.timer_handle[0]);
-  BX_DEBUG(("deactivated timer."));
-  if(BX_PIT_THIS s.timer.get_next_event_time()) {
-    bx_virt_timer.activate_timer(BX_PIT_THIS s.timer_handle[0], 
-				(Bit32u)BX_MAX(1,TICKS_TO_USEC(BX_PIT_THIS s.timer.get_next_event_time())),
-				0);
-    BX_DEBUG(("activated timer."));
-  }
-  BX_PIT_THIS s.last_next_event_time = BX_PIT_THIS s.timer.get_next_event_time();
   BX_PIT_THIS s.last_usec=my_time_usec;
+  arm_timer();
 
   BX_PIT_THIS s.total_ticks=0;
   BX_PIT_THIS s.total_usec=0;
@@ -146,7 +137,6 @@ bx_pit_c::init( void )
   BX_DEBUG(("s.last_usec="FMT_LL"d",BX_PIT_THIS s.last_usec));
   BX_DEBUG(("s.timer_id=%d",BX_PIT_THIS s.timer_handle[0]));
   BX_DEBUG(("s.timer.get_next_event_time=%d",BX_PIT_THIS s.timer.get_next_event_time()));
-  BX_DEBUG(("s.last_next_event_time=%d",BX_PIT_THIS s.last_next_event_time));
 
   return(1);
 }
@@ -165,35 +155,50 @@ bx_pit_c::timer_handler(void *this_ptr) {
 
 void
 bx_pit_c::handle_timer() {
+  BX_DEBUG(("pit: entering timer handler"));
+
+  update_time();
+  arm_timer();
+}
+
+// Run the 8254 up to the current virtual time.  Only the state changes
+// in between are stepped through, never the single clocks.
+  void
+bx_pit_c::update_time(void)
+{
   Bit64u my_time_usec = bx_virt_timer.time_usec();
   Bit64u time_passed = my_time_usec-BX_PIT_THIS s.last_usec;
   Bit32u time_passed32 = (Bit32u)time_passed;
 
-  BX_DEBUG(("pit: entering timer handler"));
-
   if(time_passed32) {
     periodic(time_passed32);
   }
   BX_PIT_THIS s.last_usec=BX_PIT_THIS s.last_usec + time_passed;
-  if(time_passed ||
-     (BX_PIT_THIS s.last_next_event_time
-      != BX_PIT_THIS s.timer.get_next_event_time())
-     ) {
-    BX_DEBUG(("pit: RESETting timer."));
-    bx_virt_timer.deactivate_timer(BX_PIT_THIS s.timer_handle[0]);
-    BX_DEBUG(("deactivated timer."));
-    if(BX_PIT_THIS s.timer.get_next_event_time()) {
-      bx_virt_timer.activate_timer(BX_PIT_THIS s.timer_handle[0], 
-				  (Bit32u)BX_MAX(1,TICKS_TO_USEC(BX_PIT_THIS s.timer.get_next_event_time())),
-				  0);
-      BX_DEBUG(("activated timer."));
-    }
-    BX_PIT_THIS s.last_next_event_time = BX_PIT_THIS s.timer.get_next_event_time();
+}
+
+// The only thing the rest of the machine has to see on time is IRQ0
+// going up, so there is one timer, set for the next rising edge of
+// OUT0.  Counters 1 and 2 and the falling edges are caught up with by
+// update_time() on the next port access or timer expiry.
+  void
+bx_pit_c::arm_timer(void)
+{
+  Bit32u ticks = BX_PIT_THIS s.timer.get_next_rise_time(0);
+
+  if (ticks == 0) {
+    // no edge close enough, look again at the next change of counter 0
+    ticks = BX_PIT_THIS s.timer.get_clock_event_time(0);
+  }
+  bx_virt_timer.deactivate_timer(BX_PIT_THIS s.timer_handle[0]);
+  if (ticks) {
+    // round up, so that the edge is there when the timer fires
+    Bit32u usec = (Bit32u) ((Bit64u(ticks) * USEC_PER_SECOND +
+                             TICKS_PER_SECOND - 1) / TICKS_PER_SECOND);
+    bx_virt_timer.activate_timer(BX_PIT_THIS s.timer_handle[0], usec, 0);
   }
   BX_DEBUG(("s.last_usec="FMT_LL"d",BX_PIT_THIS s.last_usec));
   BX_DEBUG(("s.timer_id=%d",BX_PIT_THIS s.timer_handle[0]));
-  BX_DEBUG(("s.timer.get_next_event_time=%x",BX_PIT_THIS s.timer.get_next_event_time()));
-  BX_DEBUG(("s.last_next_event_time=%d",BX_PIT_THIS s.last_next_event_time));
+  BX_DEBUG(("next OUT0 rise in %u ticks",ticks));
 }
 
 
@@ -218,7 +223,8 @@ bx_pit_c::read( Bit32u   address, unsigned int io_len )
 #endif  // !BX_USE_PIT_SMF
   BX_DEBUG(("pit: entering read handler"));
 
-  handle_timer();
+  // reading does not move the next OUT0 edge, the timer stays as it is
+  update_time();
 
   Bit64u my_time_usec = bx_virt_timer.time_usec();
 
@@ -276,16 +282,10 @@ bx_pit_c::write( Bit32u   address, Bit32u   dvalue,
   UNUSED(this_ptr);
 #endif  // !BX_USE_PIT_SMF
   Bit8u   value;
-  Bit64u my_time_usec = bx_virt_timer.time_usec();
-  Bit64u time_passed = my_time_usec-BX_PIT_THIS s.last_usec;
-  Bit32u time_passed32 = (Bit32u)time_passed;
 
   BX_DEBUG(("pit: entering write handler"));
 
-  if(time_passed32) {
-    periodic(time_passed32);
-  }
-  BX_PIT_THIS s.last_usec=BX_PIT_THIS s.last_usec + time_passed;
+  update_time();
 
   value = (Bit8u  ) dvalue;
 
@@ -336,26 +336,7 @@ bx_pit_c::write( Bit32u   address, Bit32u   dvalue,
     DEV_pic_lower_irq(0);
   }
 
-  if(time_passed ||
-     (BX_PIT_THIS s.last_next_event_time
-      != BX_PIT_THIS s.timer.get_next_event_time())
-     ) {
-    BX_DEBUG(("pit: RESETting timer."));
-    bx_virt_timer.deactivate_timer(BX_PIT_THIS s.timer_handle[0]);
-    BX_DEBUG(("deactivated timer."));
-    if(BX_PIT_THIS s.timer.get_next_event_time()) {
-      bx_virt_timer.activate_timer(BX_PIT_THIS s.timer_handle[0], 
-				  (Bit32u)BX_MAX(1,TICKS_TO_USEC(BX_PIT_THIS s.timer.get_next_event_time())),
-				  0);
-      BX_DEBUG(("activated timer."));
-    }
-    BX_PIT_THIS s.last_next_event_time = BX_PIT_THIS s.timer.get_next_event_time();
-  }
-  BX_DEBUG(("s.last_usec="FMT_LL"d",BX_PIT_THIS s.last_usec));
-  BX_DEBUG(("s.timer_id=%d",BX_PIT_THIS s.timer_handle[0]));
-  BX_DEBUG(("s.timer.get_next_event_time=%x",BX_PIT_THIS s.timer.get_next_event_time()));
-  BX_DEBUG(("s.last_next_event_time=%d",BX_PIT_THIS s.last_next_event_time));
-
+  arm_timer();
 }
 
 
@@ -71,7 +71,6 @@ private:
     bx_bool refresh_clock_div2;
     int  timer_handle[3];
     Bit64u last_usec;
-    Bit32u last_next_event_time;
     Bit64u total_ticks;
     Bit64u usec_per_second;
     Bit64u ticks_per_second;
@@ -88,6 +87,8 @@ private:
 
   static void timer_handler(void *this_ptr);
   BX_PIT_SMF void handle_timer();
+  BX_PIT_SMF void update_time(void);
+  BX_PIT_SMF void arm_timer(void);
 
   BX_PIT_SMF void  write_count_reg( Bit8u   value, unsigned timerid );
   BX_PIT_SMF Bit8u read_counter( unsigned timerid );
@@ -75,12 +75,19 @@ bx_serial_c::bx_serial_c(void)
     s[i].tx_timer_index = BX_NULL_TIMER_HANDLE;
     s[i].rx_timer_index = BX_NULL_TIMER_HANDLE;
     s[i].fifo_timer_index = BX_NULL_TIMER_HANDLE;
+    s[i].inject_q = NULL;
+    s[i].feeder = NULL;
   }
 }
 
 bx_serial_c::~bx_serial_c(void)
 {
   for (int i=0; i<BX_SERIAL_MAXDEV; i++) {
+    // stop the feeder before its file descriptor goes away
+    if (BX_SER_THIS s[i].feeder != NULL) {
+      delete BX_SER_THIS s[i].feeder;
+      BX_SER_THIS s[i].feeder = NULL;
+    }
     if (bx_options.com[i].Oenabled->get ()) {
       switch (BX_SER_THIS s[i].io_mode) {
         case BX_SER_MODE_FILE:
@@ -104,6 +111,10 @@ bx_serial_c::~bx_serial_c(void)
           break;
       }
     }
+    if (BX_SER_THIS s[i].inject_q != NULL) {
+      delete BX_SER_THIS s[i].inject_q;
+      BX_SER_THIS s[i].inject_q = NULL;
+    }
   }
 }
 
@@ -112,7 +123,8 @@ bx_serial_c::~bx_serial_c(void)
 bx_serial_c::init(void)
 {
   Bit16u ports[BX_SERIAL_MAXDEV] = {0x03f8, 0x02f8, 0x03e8, 0x02e8};
-  char name[16];
+  // the I/O handlers keep a pointer to the name
+  static char name[BX_SERIAL_MAXDEV][16];
   unsigned i;
 
   BX_SER_THIS detect_mouse = 0;
@@ -128,11 +140,11 @@ bx_serial_c::init(void)
    */
   for (i=0; i<BX_N_SERIAL_PORTS; i++) {
     if (bx_options.com[i].Oenabled->get ()) {
-      sprintf(name, "Serial Port %d", i + 1);
+      sprintf(name[i], "Serial Port %d", i + 1);
       /* serial interrupt */
       BX_SER_THIS s[i].IRQ = 4 - (i & 1);
       if (i < 2) {
-        DEV_register_irq(BX_SER_THIS s[i].IRQ, name);
+        DEV_register_irq(BX_SER_THIS s[i].IRQ, name[i]);
       }
       /* internal state */
       BX_SER_THIS s[i].ls_ipending = 0;
@@ -223,17 +235,20 @@ bx_serial_c::init(void)
 
       for (unsigned addr=ports[i]; addr<(unsigned)(ports[i]+8); addr++) {
         BX_DEBUG(("com%d initialize register for read/write: 0x%04x",i+1, addr));
-        DEV_register_ioread_handler(this, read_handler, addr, name, 1);
-        DEV_register_iowrite_handler(this, write_handler, addr, name, 1);
+        DEV_register_ioread_handler(this, read_handler, addr, name[i], 1);
+        DEV_register_iowrite_handler(this, write_handler, addr, name[i], 1);
       }
 
       BX_SER_THIS s[i].io_mode = BX_SER_MODE_NULL;
+      BX_SER_THIS s[i].fast_mode = bx_options.com[i].Ofast->get ();
       char *mode = bx_options.com[i].Omode->get_choice(bx_options.com[i].Omode->get());
       if (!strcmp(mode, "file")) {
         if (strlen(bx_options.com[i].Odev->getptr ()) > 0) {
           BX_SER_THIS s[i].output = fopen(bx_options.com[i].Odev->getptr (), "wb");
-          if (BX_SER_THIS s[i].output)
+          if (BX_SER_THIS s[i].output) {
+            setvbuf(BX_SER_THIS s[i].output, NULL, _IOFBF, BX_SER_OUTBUF_SIZE);
             BX_SER_THIS s[i].io_mode = BX_SER_MODE_FILE;
+          }
         }
       } else if (!strcmp(mode, "term")) {
 #if defined(SERIAL_ENABLE) && !defined(WIN32)
@@ -340,6 +355,25 @@ bx_serial_c::init(void)
       } else if (strcmp(mode, "null")) {
         BX_PANIC(("unknown serial i/o mode"));
       }
+      if (BX_SER_THIS s[i].inject_q == NULL) {
+        BX_SER_THIS s[i].inject_q = new bx_inject_queue_c();
+        BX_SER_THIS s[i].inject_q->set_replay_unit(BX_REPLAY_UNIT_COM(i));
+      }
+      // Let a host thread wait for tty/socket input instead of polling
+      // the descriptor from the receive timer.
+      int feeder_fd = -1;
+      if (BX_SER_THIS s[i].io_mode == BX_SER_MODE_TERM) {
+        feeder_fd = BX_SER_THIS s[i].tty_id;
+      } else if (BX_SER_THIS s[i].io_mode == BX_SER_MODE_SOCKET) {
+        feeder_fd = BX_SER_THIS s[i].socket_id;
+      }
+      if ((feeder_fd >= 0) && (BX_SER_THIS s[i].feeder == NULL)) {
+        BX_SER_THIS s[i].feeder = new bx_inject_feeder_c(BX_SER_THIS s[i].inject_q, feeder_fd);
+        if (!BX_SER_THIS s[i].feeder->start()) {
+          delete BX_SER_THIS s[i].feeder;
+          BX_SER_THIS s[i].feeder = NULL;
+        }
+      }
       // simulate device connected
       if (BX_SER_THIS s[i].io_mode != BX_SER_MODE_RAW) {
         BX_SER_THIS s[i].modem_status.cts = 1;
@@ -478,6 +512,9 @@ bx_serial_c::read(Bit32u address, unsigned io_len)
           BX_SER_THIS s[port].rx_ipending = 0;
           lower_interrupt(port);
         }
+        // refill from the injection queue right away instead of waiting
+        // for the next receive poll
+        rx_inject(port);
       }
       break;
 
@@ -676,7 +713,12 @@ bx_serial_c::write(Bit32u address, Bit32u value, unsigned io_len)
         }
       } else {
         Bit8u bitmask = 0xff >> (3 - BX_SER_THIS s[port].line_cntl.wordlen_sel);
-        if (BX_SER_THIS s[port].line_status.thr_empty) {
+        if (BX_SER_THIS s[port].fast_mode && BX_SER_THIS s[port].line_status.tsr_empty) {
+          // fast UART: the character leaves the shift register at once, so
+          // THR and TSR stay empty and the guest never waits for the timer
+          tx_output(port, value & bitmask);
+          raise_interrupt(port, BX_SER_INT_TXHOLD);
+        } else if (BX_SER_THIS s[port].line_status.thr_empty) {
           if (BX_SER_THIS s[port].fifo_cntl.enable) {
             BX_SER_THIS s[port].tx_fifo[BX_SER_THIS s[port].tx_fifo_end++] = value & bitmask;
           } else {
@@ -1060,46 +1102,61 @@ bx_serial_c::rx_fifo_enq(Bit8u port, Bit8u data)
 }
 
 
+// rx_inject() moves as many injected bytes into the receiver as it can
+// hold without an overrun.  The queue is only drained when the guest has
+// read the previous data, which throttles the producer thread.
 void
-bx_serial_c::tx_timer_handler(void *this_ptr)
+bx_serial_c::rx_inject(Bit8u port)
 {
-  bx_serial_c *class_ptr = (bx_serial_c *) this_ptr;
+  Bit8u data;
 
-  class_ptr->tx_timer();
+  if (BX_SER_THIS s[port].modem_cntl.local_loopback) return;
+  if (BX_SER_THIS s[port].fifo_cntl.enable) {
+    while ((BX_SER_THIS s[port].rx_fifo_end < 16) &&
+           BX_SER_THIS s[port].inject_q->get(&data)) {
+      rx_fifo_enq(port, data);
+    }
+  } else if (!BX_SER_THIS s[port].line_status.rxdata_ready &&
+             BX_SER_THIS s[port].inject_q->get(&data)) {
+    rx_fifo_enq(port, data);
+  }
 }
 
 
-void
-bx_serial_c::tx_timer(void)
+// inject_bytes() feeds receive data to a serial port from a host thread.
+// Returns the number of bytes accepted; the rest has to be offered again
+// later.  Ports that have a feeder thread already have their producer.
+Bit32u
+bx_serial_c::inject_bytes(unsigned port, const Bit8u *data, Bit32u length)
 {
-  bx_bool gen_int = 0;
-  Bit8u port = 0;
-  int timer_id;
-
-  timer_id = bx_pc_system.triggeredTimerID();
-  if (timer_id == BX_SER_THIS s[0].tx_timer_index) {
-    port = 0;
-  } else if (timer_id == BX_SER_THIS s[1].tx_timer_index) {
-    port = 1;
-  } else if (timer_id == BX_SER_THIS s[2].tx_timer_index) {
-    port = 2;
-  } else if (timer_id == BX_SER_THIS s[3].tx_timer_index) {
-    port = 3;
+  if ((port >= BX_N_SERIAL_PORTS) || (BX_SER_THIS s[port].inject_q == NULL) ||
+      (BX_SER_THIS s[port].feeder != NULL)) {
+    return 0;
   }
+  return BX_SER_THIS s[port].inject_q->put(data, length);
+}
+
 
+// Send one character from the transmit shift register to the backend.
+// File output is buffered by stdio and only pushed out at the end of a
+// line or when the buffer is full.
+void
+bx_serial_c::tx_output(Bit8u port, Bit8u data)
+{
   if (BX_SER_THIS s[port].modem_cntl.local_loopback) {
-    rx_fifo_enq(port, BX_SER_THIS s[port].tsrbuffer);
+    rx_fifo_enq(port, data);
   } else {
     switch (BX_SER_THIS s[port].io_mode) {
       case BX_SER_MODE_FILE:
-        fputc(BX_SER_THIS s[port].tsrbuffer, BX_SER_THIS s[port].output);
-        fflush(BX_SER_THIS s[port].output);
+        fputc(data, BX_SER_THIS s[port].output);
+        if (data == '\n')
+          fflush(BX_SER_THIS s[port].output);
         break;
       case BX_SER_MODE_TERM:
 #if defined(SERIAL_ENABLE)
-        BX_DEBUG(("com%d: write: '%c'", port+1, BX_SER_THIS s[port].tsrbuffer));
+        BX_DEBUG(("com%d: write: '%c'", port+1, data));
         if (BX_SER_THIS s[port].tty_id >= 0) {
-          write(BX_SER_THIS s[port].tty_id, (bx_ptr_t) & BX_SER_THIS s[port].tsrbuffer, 1);
+          write(BX_SER_THIS s[port].tty_id, (bx_ptr_t) &data, 1);
         }
 #endif
         break;
@@ -1107,25 +1164,56 @@ bx_serial_c::tx_timer(void)
 #if USE_RAW_SERIAL
         if (!BX_SER_THIS s[port].raw->ready_transmit())
           BX_PANIC(("com%d: not ready to transmit", port+1));
-        BX_SER_THIS s[port].raw->transmit(BX_SER_THIS s[port].tsrbuffer);
+        BX_SER_THIS s[port].raw->transmit(data);
 #endif
         break;
       case BX_SER_MODE_MOUSE:
-        BX_INFO(("com%d: write to mouse ignored: 0x%02x", port+1, BX_SER_THIS s[port].tsrbuffer));
+        BX_INFO(("com%d: write to mouse ignored: 0x%02x", port+1, data));
         break;
       case BX_SER_MODE_SOCKET:
         if (BX_SER_THIS s[port].socket_id >= 0) {
 #ifdef WIN32
-          BX_INFO(("attempting to write win32 : %c", BX_SER_THIS s[port].tsrbuffer));
+          BX_INFO(("attempting to write win32 : %c", data));
           ::send(BX_SER_THIS s[port].socket_id,
-                 (const char*) & BX_SER_THIS s[port].tsrbuffer, 1, 0);
+                 (const char*) &data, 1, 0);
 #else
           ::write(BX_SER_THIS s[port].socket_id,
-                  (bx_ptr_t) & BX_SER_THIS s[port].tsrbuffer, 1);
+                  (bx_ptr_t) &data, 1);
 #endif
       }
     }
   }
+}
+
+
+void
+bx_serial_c::tx_timer_handler(void *this_ptr)
+{
+  bx_serial_c *class_ptr = (bx_serial_c *) this_ptr;
+
+  class_ptr->tx_timer();
+}
+
+
+void
+bx_serial_c::tx_timer(void)
+{
+  bx_bool gen_int = 0;
+  Bit8u port = 0;
+  int timer_id;
+
+  timer_id = bx_pc_system.triggeredTimerID();
+  if (timer_id == BX_SER_THIS s[0].tx_timer_index) {
+    port = 0;
+  } else if (timer_id == BX_SER_THIS s[1].tx_timer_index) {
+    port = 1;
+  } else if (timer_id == BX_SER_THIS s[2].tx_timer_index) {
+    port = 2;
+  } else if (timer_id == BX_SER_THIS s[3].tx_timer_index) {
+    port = 3;
+  }
+
+  tx_output(port, BX_SER_THIS s[port].tsrbuffer);
 
   BX_SER_THIS s[port].line_status.tsr_empty = 1;
   if (BX_SER_THIS s[port].fifo_cntl.enable && (BX_SER_THIS s[port].tx_fifo_end > 0)) {
@@ -1185,6 +1273,16 @@ bx_serial_c::rx_timer(void)
   int bdrate = BX_SER_THIS s[port].baudrate / (BX_SER_THIS s[port].line_cntl.wordlen_sel + 5);
   unsigned char chbuf = 0;
 
+  rx_inject(port);
+  if (BX_SER_THIS s[port].feeder != NULL) {
+    // the feeder thread owns the host side, nothing to poll here
+    bx_pc_system.activate_timer(BX_SER_THIS s[port].rx_timer_index,
+                                BX_SER_THIS s[port].inject_q->empty() ?
+                                BX_SER_INJECT_IDLE_POLL : (int) (1000000.0 / bdrate),
+                                0); /* not continuous */
+    return;
+  }
+
   if (BX_SER_THIS s[port].io_mode == BX_SER_MODE_TERM) {
 #if BX_HAVE_SELECT && defined(SERIAL_ENABLE)
     tval.tv_sec  = 0;
@@ -1201,7 +1299,11 @@ bx_serial_c::rx_timer(void)
   }
   if ((BX_SER_THIS s[port].line_status.rxdata_ready == 0) ||
       (BX_SER_THIS s[port].fifo_cntl.enable)) {
-    switch (BX_SER_THIS s[port].io_mode) {
+    // host ports are not polled during a replay, see below
+    unsigned io_mode = BX_SER_THIS s[port].io_mode;
+    if (bx_replay.replaying() && (io_mode != BX_SER_MODE_MOUSE))
+      io_mode = BX_SER_MODE_NULL;
+    switch (io_mode) {
       case BX_SER_MODE_SOCKET:
 #if defined(SERIAL_ENABLE)
         if (BX_SER_THIS s[port].line_status.rxdata_ready == 0) {
@@ -1283,12 +1385,16 @@ bx_serial_c::rx_timer(void)
         }
         break;
     }
+    if (BX_SER_THIS s[port].io_mode != BX_SER_MODE_MOUSE) {
+      data_ready = bx_replay.poll(BX_REPLAY_SERIAL_RX, port, data_ready, &chbuf);
+    }
     if (data_ready) {
       if (!BX_SER_THIS s[port].modem_cntl.local_loopback) {
         rx_fifo_enq(port, chbuf);
       }
     } else {
-      if (!BX_SER_THIS s[port].fifo_cntl.enable) {
+      if (!BX_SER_THIS s[port].fifo_cntl.enable &&
+          BX_SER_THIS s[port].inject_q->empty()) {
         bdrate = (int) (1000000.0 / 100000); // Poll frequency is 100ms
       }
     }
@@ -51,6 +51,14 @@ extern "C" {
 
 #define  BX_PC_CLOCK_XTL   1843200.0
 
+// receive poll interval while the injection queue is empty (usec), the
+// same 100ms a host port without data is polled at
+#define BX_SER_INJECT_IDLE_POLL 100000
+
+// size of the host side output buffer in file mode; the buffer is also
+// flushed whenever the guest transmits a newline
+#define BX_SER_OUTBUF_SIZE 4096
+
 #define  BX_SER_RXIDLE  0
 #define  BX_SER_RXPOLL  1
 #define  BX_SER_RXWAIT  2
@@ -113,10 +121,17 @@ typedef struct {
   int  fifo_timer_index;
 
   int io_mode;
+  bx_bool fast_mode;   /* transmit without the per-character delay */
   int tty_id;
   int socket_id;
   FILE *output;
 
+  // receive side input injection: a host thread (the feeder reading a
+  // tty or socket backend, or a caller of inject_bytes()) fills the
+  // queue and the UART drains it as fast as the guest reads RBR.
+  bx_inject_queue_c  *inject_q;
+  bx_inject_feeder_c *feeder;
+
 #if USE_RAW_SERIAL
   serial_raw* raw;
 #endif
@@ -204,6 +219,7 @@ public:
   virtual void   init(void);
   virtual void   reset(unsigned type);
   virtual void   serial_mouse_enq(int delta_x, int delta_y, int delta_z, unsigned button_state);
+  virtual Bit32u inject_bytes(unsigned port, const Bit8u *data, Bit32u length);
 
 private:
   bx_serial_t s[BX_SERIAL_MAXDEV];
@@ -223,6 +239,8 @@ private:
   static void raise_interrupt(Bit8u port, int type);
 
   static void rx_fifo_enq(Bit8u port, Bit8u data);
+  static void rx_inject(Bit8u port);
+  static void tx_output(Bit8u port, Bit8u data);
 
   static void tx_timer_handler(void *);
   BX_SER_SMF void tx_timer(void);
@@ -525,7 +525,7 @@ logfunctions::ask (int level, const char *prefix, const char *fmt, va_list ap)
       BX_CPU_THIS_PTR stop_reason = STOP_CPU_PANIC;
         bx_guard.special_unwind_stack = 1;
         in_ask_already = 0;
-        longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+        BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
       }
       break;
 #endif
@@ -534,7 +534,7 @@ logfunctions::ask (int level, const char *prefix, const char *fmt, va_list ap)
       // user chose debugger (we're using gdb)
       in_ask_already = 0;
       BX_CPU_THIS_PTR ispanic = 1;
-      longjmp(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
+      BX_LONGJMP(BX_CPU_THIS_PTR jmp_buf_env, 1); // go back to main decode loop
 */
       break;
 #endif
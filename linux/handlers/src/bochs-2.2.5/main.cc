@@ -750,28 +750,52 @@ bx_begin_simulation (int argc, char *argv[])
     // Not a great solution but it works. BBD
     bx_options.Omouse_enabled->set (bx_options.Omouse_enabled->get ());
 
-    if (BX_SMP_PROCESSORS == 1) {
-      // only one processor, run as fast as possible by not messing with
-      // quantums and loops.
-      BX_CPU(0)->cpu_loop(1);
-      // for one processor, the only reason for cpu_loop to return is
-      // that kill_bochs_request was set by the GUI interface.
-    } else {
-      // SMP simulation: do a few instructions on each processor, then switch
-      // to another.  Increasing quantum speeds up overall performance, but
-      // reduces granularity of synchronization between processors.
-      int processor = 0;
-      int quantum = 5;
-      while (1) {
-        // do some instructions in each processor
-        BX_CPU(processor)->cpu_loop(quantum);
-        processor = (processor+1) % BX_SMP_PROCESSORS;
-        if (BX_CPU(0)->kill_bochs_request) 
-          break;
-        if (processor == 0) 
-          BX_TICKN(quantum);
+#if BX_SMP_PROCESSORS == 1
+    // only one processor, run as fast as possible by not messing with
+    // quantums and loops.
+    BX_CPU(0)->cpu_loop(1);
+    // for one processor, the only reason for cpu_loop to return is
+    // that kill_bochs_request was set by the GUI interface.
+#else
+    // SMP simulation: do a few instructions on each processor, then switch
+    // to another.  Increasing quantum speeds up overall performance, but
+    // reduces granularity of synchronization between processors, so it
+    // grows while the processors just compute and drops back as soon as
+    // one of them waits for another (PAUSE) or is woken up from HLT.
+    // Halted processors are skipped; when all of them are halted, time
+    // jumps to the next timer event.
+    int quantum = BX_SMP_QUANTUM_MIN;
+    while (1) {
+      bx_bool ran = 0, sync = 0;
+      for (int processor=0; processor<BX_SMP_PROCESSORS; processor++) {
+        BX_CPU_C *cpu = BX_CPU(processor);
+        if (cpu->is_halted_idle())
+          continue;
+        if (cpu->debug_trap & 0x80000000)
+          sync = 1;
+        // do some instructions in this processor
+        cpu->cpu_loop(quantum);
+        ran = 1;
+        if (cpu->spin_wait) {
+          cpu->spin_wait = 0;
+          sync = 1;
+        }
+      }
+      if (BX_CPU(0)->kill_bochs_request)
+        break;
+      if (ran) {
+        BX_TICKN(quantum);
+        if (sync)
+          quantum = BX_SMP_QUANTUM_MIN;
+        else if (quantum < BX_SMP_QUANTUM_MAX)
+          quantum *= 2;
+      }
+      else {
+        BX_TICKN(bx_pc_system.getNumCpuTicksLeftNextEvent());
+        quantum = BX_SMP_QUANTUM_MIN;
       }
     }
+#endif
   }
 #endif /* ! BX_DEBUGGER */
   BX_INFO (("cpu loop quit, shutting down simulator"));
@@ -927,11 +951,30 @@ int bx_init_hardware()
 #endif
 
 #if BX_DEBUGGER == 0
+  bx_replay.init();
   DEV_init_devices();
   DEV_reset_devices(BX_RESET_HARDWARE);
   bx_gui->init_signal_handlers ();
   bx_pc_system.start_timers();
+#if BX_SUPPORT_STATS
+  bx_stats.init();
+#endif
+#endif
+  bx_profiler.init();
+
+#if BX_SUPPORT_CPU_BENCH
+  if (getenv("BXDECODEBENCH") != NULL) {
+    BX_CPU(0)->decodeBench(getenv("BXDECODEBENCH"));
+    BX_EXIT(0);
+  }
+#if BX_SUPPORT_MMX && (BX_SUPPORT_SSE >= 2)
+  if (getenv("BXSIMDBENCH") != NULL) {
+    BX_CPU(0)->simdBench();
+    BX_EXIT(0);
+  }
+#endif
 #endif
+
   BX_DEBUG(("bx_init_hardware is setting signal handlers"));
 // if not using debugger, then we can take control of SIGINT.
 #if !BX_DEBUGGER
@@ -995,6 +1038,12 @@ int bx_atexit(void)
   // so that the user can see any messages left behind on the console.
   SIM->set_display_mode (DISP_MODE_CONFIG);
 
+  bx_profiler.exit();
+#if BX_SUPPORT_STATS
+  bx_stats.exit();
+#endif
+  bx_replay.exit();
+
 #if BX_PROVIDE_DEVICE_MODELS==1
   bx_pc_system.exit();
 #endif
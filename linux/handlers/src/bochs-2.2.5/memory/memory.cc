@@ -44,16 +44,24 @@ BX_MEM_C::writePhysicalPage(BX_CPU_C *cpu, Bit32u addr, unsigned len, void *data
 
   a20addr = A20ADDR(addr);
   BX_INSTR_PHY_WRITE(cpu->which_cpu(), a20addr, len);
+  BX_CPU_STATS_INC(cpu, phys_writes);
 
 #if BX_DEBUGGER
   // (mch) Check for physical write break points, TODO
   // (bbd) Each breakpoint should have an associated CPU#, TODO
-  for (int i = 0; i < num_write_watchpoints; i++)
+  if (num_write_watchpoints &&
+      BX_DBG_PAGE_FILTER_HIT(write_watchpoint_pages, a20addr >> 12)) {
+    for (int i = 0; i < num_write_watchpoints; i++)
         if (write_watchpoint[i] == a20addr) {
 	      BX_CPU(0)->watchpoint = a20addr;
               BX_CPU(0)->break_point = BREAK_POINT_WRITE;
               break;
         }
+  }
+#endif
+#if BX_GDBSTUB
+  if (bx_gdbstub_nr_watchpoints)
+    bx_gdbstub_check_watch(a20addr, len, BX_WRITE);
 #endif
 
   struct memory_handler_struct *memory_handler = memory_handlers[a20addr >> 20];
@@ -203,16 +211,24 @@ BX_MEM_C::readPhysicalPage(BX_CPU_C *cpu, Bit32u addr, unsigned len, void *data)
  
   a20addr = A20ADDR(addr);
   BX_INSTR_PHY_READ(cpu->which_cpu(), a20addr, len);
+  BX_CPU_STATS_INC(cpu, phys_reads);
 
 #if BX_DEBUGGER
   // (mch) Check for physical read break points, TODO
   // (bbd) Each breakpoint should have an associated CPU#, TODO
-  for (int i = 0; i < num_read_watchpoints; i++)
+  if (num_read_watchpoints &&
+      BX_DBG_PAGE_FILTER_HIT(read_watchpoint_pages, a20addr >> 12)) {
+    for (int i = 0; i < num_read_watchpoints; i++)
         if (read_watchpoint[i] == a20addr) {
 	      BX_CPU(0)->watchpoint = a20addr;
               BX_CPU(0)->break_point = BREAK_POINT_READ;
               break;
         }
+  }
+#endif
+#if BX_GDBSTUB
+  if (bx_gdbstub_nr_watchpoints)
+    bx_gdbstub_check_watch(a20addr, len, BX_READ);
 #endif
 
   struct memory_handler_struct *memory_handler = memory_handlers[a20addr >> 20];
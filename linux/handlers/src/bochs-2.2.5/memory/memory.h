@@ -72,10 +72,26 @@ public:
   Bit8u   *rom;      // 512k BIOS rom space + 128k expansion rom space
   Bit8u   *bogus;    // 4k for unexisting memory
 #if BX_DEBUGGER
+  // Pages written since the last dbg_clear_dirty().  The list holds the
+  // same pages as the flags, in the order they were first written, so
+  // that a check only has to look at the pages that were touched.
   unsigned char dbg_dirty_pages[(BX_MAX_DIRTY_PAGE_TABLE_MEGS * 1024 * 1024) / 4096];
+  Bit32u dbg_dirty_list[(BX_MAX_DIRTY_PAGE_TABLE_MEGS * 1024 * 1024) / 4096];
+  Bit32u dbg_dirty_count;
   Bit32u dbg_count_dirty_pages () {
     return (BX_MAX_DIRTY_PAGE_TABLE_MEGS * 1024 * 1024) / 4096;
   }
+  BX_CPP_INLINE void dbg_mark_dirty(Bit32u page) {
+    if (!dbg_dirty_pages[page]) {
+      dbg_dirty_pages[page] = 1;
+      dbg_dirty_list[dbg_dirty_count++] = page;
+    }
+  }
+  void dbg_clear_dirty(void) {
+    for (Bit32u i=0; i<dbg_dirty_count; i++)
+      dbg_dirty_pages[dbg_dirty_list[i]] = 0;
+    dbg_dirty_count = 0;
+  }
 #endif
 
   BX_MEM_C(void);
@@ -95,6 +111,7 @@ public:
     unsigned long (*f)(unsigned char *buf, int len),
     Bit32u addr1, Bit32u addr2, Bit32u *crc);
   BX_MEM_SMF Bit8u* getHostMemAddr(BX_CPU_C *cpu, Bit32u a20Addr, unsigned op) BX_CPP_AttrRegparmN(3);
+  BX_MEM_SMF Bit8u* getDmaHostAddr(Bit32u addr, unsigned len, unsigned op) BX_CPP_AttrRegparmN(3);
   BX_MEM_SMF bx_bool registerMemoryHandlers(memory_handler_t read_handler, void *read_param, 
 		  memory_handler_t write_handler, void *write_param, 
 		  unsigned long begin_addr, unsigned long end_addr);
@@ -113,7 +130,7 @@ BOCHSAPI extern BX_MEM_C    *bx_mem_array[BX_ADDRESS_SPACES];
 #endif  /* BX_PROVIDE_CPU_MEMORY==1 */
 
 #if BX_DEBUGGER
-#  define BX_DBG_DIRTY_PAGE(page) BX_MEM(0)->dbg_dirty_pages[page] = 1;
+#  define BX_DBG_DIRTY_PAGE(page) BX_MEM(0)->dbg_mark_dirty(page);
 #else
 #  define BX_DBG_DIRTY_PAGE(page)
 #endif
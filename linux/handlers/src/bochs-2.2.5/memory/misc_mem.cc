@@ -51,6 +51,9 @@ BX_MEM_C::BX_MEM_C(void)
   megabytes = 0;
 
   memory_handlers = NULL;
+#if BX_DEBUGGER
+  dbg_dirty_count = 0;
+#endif
 }
 
 void BX_CPP_AttrRegparmN(2)
@@ -519,6 +522,10 @@ BX_MEM_C::dbg_set_mem(Bit32u addr, unsigned len, Bit8u *buf)
     {
       vector[addr] = *buf;
     }
+#if BX_SUPPORT_ICACHE
+    // retire cached decodes and formatted trace lines of this page
+    pageWriteStampTable.decWriteStamp(addr);
+#endif
     buf++;
     addr++;
   }
@@ -550,7 +557,9 @@ BX_MEM_C::dbg_crc32(unsigned long (*f)(unsigned char *buf, int len),
 // code will perform an 'op' operation.  This address will be
 // used for direct access to guest memory as an acceleration by
 // a few instructions, like REP {MOV, INS, OUTS, etc}.
-// Values of 'op' are { BX_READ, BX_WRITE, BX_RW }.
+// Values of 'op' are { BX_READ, BX_WRITE, BX_RW, BX_EXECUTE }.
+// BX_EXECUTE is a BX_READ done by the instruction prefetcher, which
+// must not be vetoed for the sake of data watchpoints.
 //
 // The other assumption is that the calling code _only_ accesses memory
 // directly within the page that encompasses the address requested.
@@ -559,6 +568,12 @@ BX_MEM_C::dbg_crc32(unsigned long (*f)(unsigned char *buf, int len),
   Bit8u * BX_CPP_AttrRegparmN(3)
 BX_MEM_C::getHostMemAddr(BX_CPU_C *cpu, Bit32u a20Addr, unsigned op)
 {
+  if (op == BX_EXECUTE)
+    op = BX_READ;
+#if BX_GDBSTUB
+  else if (bx_gdbstub_nr_watchpoints && bx_gdbstub_watch_veto(a20Addr, op))
+    return(NULL); // Vetoed!  gdb watchpoint on this page
+#endif
 
 #if BX_SUPPORT_APIC
     bx_generic_apic_c *local_apic = &cpu->local_apic;
@@ -667,11 +682,87 @@ BX_MEM_C::getHostMemAddr(BX_CPU_C *cpu, Bit32u a20Addr, unsigned op)
 #if BX_SUPPORT_ICACHE
     pageWriteStampTable.decWriteStamp(a20Addr);
 #endif
+    // the caller writes through the pointer, as long as the TLB keeps it
+    BX_DBG_DIRTY_PAGE(a20Addr >> 12);
 
     return(retAddr);
   }
 }
 
+/*
+ * Resolve a whole guest physical range for a bus master DMA transfer.
+ * Returns a pointer into the memory vector if every byte of the range is
+ * plain RAM, so that a device can move the data with a single host copy
+ * (or a single read()/write() on its image file).  Returns NULL if any
+ * part of the range needs the per-access path: memory handlers, VGA,
+ * ROM and shadow RAM, APIC, A20 wrap or the end of memory.  For BX_WRITE
+ * the iCache write stamp of each page in the range is bumped once.
+ */
+  Bit8u * BX_CPP_AttrRegparmN(3)
+BX_MEM_C::getDmaHostAddr(Bit32u addr, unsigned len, unsigned op)
+{
+  Bit32u end = addr + len - 1;
+  Bit32u page;
+
+  if ((len == 0) || (end < addr) || (end >= BX_MEM_THIS len))
+    return(NULL);
+  if ((A20ADDR(addr) != addr) || (A20ADDR(end) != end))
+    return(NULL);
+  if ((addr < 0x00100000) && (end >= 0x000a0000))
+    return(NULL); // VGA memory, expansion ROMs and BIOS
+#if BX_SUPPORT_IODEBUG
+  return(NULL);   // every access has to be checked
+#endif
+#if BX_DEBUGGER
+  if ((num_write_watchpoints > 0) || (num_read_watchpoints > 0)) {
+    for (page = addr >> 12; page <= (end >> 12); page++) {
+      if (BX_DBG_PAGE_FILTER_HIT(write_watchpoint_pages, page) ||
+          BX_DBG_PAGE_FILTER_HIT(read_watchpoint_pages, page))
+        return(NULL);
+    }
+  }
+#endif
+#if BX_GDBSTUB
+  if (bx_gdbstub_nr_watchpoints) {
+    for (page = addr >> 12; page <= (end >> 12); page++) {
+      if (bx_gdbstub_watch_veto(page << 12, op))
+        return(NULL);
+    }
+  }
+#endif
+#if BX_SUPPORT_APIC
+  bx_generic_apic_c *local_apic = &BX_CPU(0)->local_apic;
+  if ((local_apic->get_base () <= end) && (local_apic->get_base () + 0xfff >= addr))
+    return(NULL);
+  bx_generic_apic_c *ioapic = bx_devices.ioapic;
+  if ((ioapic->get_base () <= end) && (ioapic->get_base () + 0xfff >= addr))
+    return(NULL);
+#endif
+
+  for (page = addr >> 20; page <= (end >> 20); page++) {
+    struct memory_handler_struct *memory_handler = memory_handlers[page];
+    while (memory_handler) {
+      if ((memory_handler->begin <= end) && (memory_handler->end >= addr))
+        return(NULL);
+      memory_handler = memory_handler->next;
+    }
+  }
+
+  if (op == BX_READ) {
+    BX_INSTR_PHY_READ(0, addr, len);
+  } else {
+    BX_INSTR_PHY_WRITE(0, addr, len);
+    for (page = addr >> 12; page <= (end >> 12); page++) {
+#if BX_SUPPORT_ICACHE
+      pageWriteStampTable.decWriteStamp(page << 12);
+#endif
+      BX_DBG_DIRTY_PAGE(page);
+    }
+  }
+
+  return((Bit8u *) & vector[addr]);
+}
+
 /*
  * One needs to provide both a read_handler and a write_handler.
  * XXX: maybe we should check for overlapping memory handlers
@@ -0,0 +1,82 @@
+#!/bin/sh
+#
+# $Id$
+#
+# Record/replay check for network frames.  Records a run of the given
+# bochsrc with an NE2000 on the loopback interface while some broadcast
+# frames are sent to it, replays the run, and compares the frames that
+# reached bx_ne2k_c::rx_frame() in both runs, by tick and length.
+#
+# Needs a Linux host, root (for the packet socket on lo), python and
+# Bochs configured with --enable-ne2000.  The ne2k, log, debug and
+# replay lines of the bochsrc are replaced.
+#
+# usage: replay-netcheck.sh bochs bochsrc [frames]
+
+if [ $# -lt 2 ]; then
+  echo "usage: $0 bochs bochsrc [frames]"
+  exit 2
+fi
+BOCHS=$1
+RC=$2
+FRAMES=${3:-10}
+DIR=`mktemp -d /tmp/bxnet.XXXXXX` || exit 2
+trap 'rm -rf $DIR' 0
+
+# debug messages go through a fifo, only the NE2K receive and the replay
+# messages are kept
+run() {
+  grep -v '^[ 	]*\(ne2k\|log\|debug\|replay\):' $RC > $DIR/$1.rc
+  cat >> $DIR/$1.rc <<EOF
+log: $DIR/log
+debug: action=report
+ne2k: ioaddr=0x240, irq=9, mac=b0:c4:20:00:00:01, ethmod=linux, ethdev=lo
+replay: mode=$1, file=$DIR/net.rpl
+EOF
+  rm -f $DIR/log
+  mkfifo $DIR/log
+  touch $DIR/$1.out
+  grep --line-buffered 'rx_frame with length\|\[RPLY \]' < $DIR/log > $DIR/$1.out &
+  $BOCHS -q -f $DIR/$1.rc > /dev/null 2>&1 &
+  pid=$!
+  if [ $1 = record ]; then
+    sleep 3
+    python -c "
+import socket, time
+s = socket.socket(socket.AF_PACKET, socket.SOCK_RAW)
+s.bind(('lo', 0))
+for n in range($FRAMES):
+  s.send(b'\xff' * 6 + b'\x02\x00\x00\x00\x00\x09\x08\x06' + bytes(bytearray([n] * (60 + n))))
+  time.sleep(0.5)
+" || { kill $pid; exit 2; }
+    sleep 2
+  else
+    # until the log has been consumed, at most two minutes
+    n=0
+    while [ $n -lt 120 ] && ! grep -q 'end of' $DIR/$1.out; do
+      sleep 1
+      n=`expr $n + 1`
+    done
+  fi
+  kill $pid
+  wait
+}
+
+run record
+run replay
+grep 'rx_frame' $DIR/record.out > $DIR/record.rx
+grep 'rx_frame' $DIR/replay.out > $DIR/replay.rx
+recorded=`wc -l < $DIR/record.rx`
+replayed=`wc -l < $DIR/replay.rx`
+echo "frames received: $recorded recorded, $replayed replayed"
+if [ $recorded -eq 0 ]; then
+  echo "FAIL: no frame reached the NE2000 while recording"
+  exit 1
+fi
+if ! cmp -s $DIR/record.rx $DIR/replay.rx; then
+  diff $DIR/record.rx $DIR/replay.rx | head -20
+  echo "FAIL: replayed frames differ"
+  exit 1
+fi
+echo "PASS"
+exit 0
@@ -285,6 +285,9 @@ int bx_pc_system_c::register_timer_ticks(void* this_ptr, bx_timer_handler_t func
   timer[i].this_ptr   = this_ptr;
   strncpy(timer[i].id, id, BxMaxTimerIDLen);
   timer[i].id[BxMaxTimerIDLen-1] = 0; // Null terminate if not already.
+#if BX_SUPPORT_STATS
+  timer[i].fired      = 0;
+#endif
 
   if (active) {
     if (ticks < Bit64u(currCountdown)) {
@@ -364,6 +367,9 @@ void bx_pc_system_c::countdownEvent(void)
     // timer period or deactivate etc.
     if (triggered[i]) {
       triggeredTimer = i;
+#if BX_SUPPORT_STATS
+      timer[i].fired++;
+#endif
       timer[i].funct(timer[i].this_ptr);
       triggeredTimer = 0;
     }
@@ -542,3 +548,42 @@ unsigned bx_pc_system_c::unregisterTimer(int timerIndex)
 
   return(1); // OK
 }
+
+#if BX_SUPPORT_STATS
+static Bit64s timer_stats_handler(bx_param_c *param, int set, Bit64s val)
+{
+  return bx_pc_system.get_timer_count(param->get_name());
+}
+
+// Timer slots are reused after unregisterTimer(), so the parameters are
+// per timer id rather than shadows of the slots.
+void bx_pc_system_c::init_stats(bx_list_c *parent)
+{
+  static char timers_name[] = "timers";
+  bx_list_c *list = new bx_list_c (BXP_NULL, timers_name, "", numTimers);
+  for (unsigned i=0; i < numTimers; i++) {
+    if (!timer[i].inUse) continue;
+    int n;
+    for (n=0; n<list->get_size (); n++) {
+      if (!strcmp(list->get(n)->get_name (), timer[i].id)) break;
+    }
+    if (n == list->get_size ()) {
+      bx_param_num_c *param = new bx_param_num_c (BXP_NULL,
+          timer[i].id, "", 0, BX_MAX_BIT64S, 0);
+      param->set_handler (timer_stats_handler);
+      list->add (param);
+    }
+  }
+  parent->add (list);
+}
+
+Bit64u bx_pc_system_c::get_timer_count(const char *id)
+{
+  Bit64u count = 0;
+  for (unsigned i=0; i < numTimers; i++) {
+    if (timer[i].inUse && !strcmp(timer[i].id, id))
+      count += timer[i].fired;
+  }
+  return count;
+}
+#endif
@@ -58,6 +58,9 @@ private:
                                //   has to be stored as well.
 #define BxMaxTimerIDLen 32
     char id[BxMaxTimerIDLen]; // String ID of timer.
+#if BX_SUPPORT_STATS
+    Bit64u  fired;      // Number of callbacks since registration.
+#endif
   } timer[BX_MAX_TIMERS];
 
   unsigned   numTimers;  // Number of currently allocated timers.
@@ -137,6 +140,10 @@ public:
 #if BX_DEBUGGER
   static void timebp_handler(void* this_ptr);
 #endif
+#if BX_SUPPORT_STATS
+  void   init_stats(bx_list_c *parent);
+  Bit64u get_timer_count(const char *id);
+#endif
 
 
   // ===========================
@@ -105,14 +105,17 @@ extern "C" {
 #define DEV_cmos_present() (bx_devices.pluginCmosDevice != &bx_devices.stubCmos)
 
 ///////// keyboard macros
+// host input from the guis goes through the record/replay layer
 #define DEV_mouse_motion(dx, dy, state) \
-    (bx_devices.pluginKeyboard->mouse_motion(dx, dy, 0, state))
+    (bx_replay.mouse_motion(dx, dy, 0, state))
 #define DEV_mouse_motion_ext(dx, dy, dz, state) \
-    (bx_devices.pluginKeyboard->mouse_motion(dx, dy, dz, state))
+    (bx_replay.mouse_motion(dx, dy, dz, state))
 #define DEV_kbd_gen_scancode(key) \
-    (bx_devices.pluginKeyboard->gen_scancode(key))
+    (bx_replay.gen_scancode(key))
 #define DEV_kbd_paste_bytes(bytes, count) \
-    (bx_devices.pluginKeyboard->paste_bytes(bytes,count))
+    (bx_replay.paste_bytes(bytes,count))
+#define DEV_kbd_inject_bytes(bytes, count) \
+    (bx_devices.pluginKeyboard->inject_bytes(bytes,count))
 
 ///////// hard drive macros
 #define DEV_hd_read_handler(a, b, c) \
@@ -131,6 +134,9 @@ extern "C" {
 #define DEV_hd_present() (bx_devices.pluginHardDrive != &bx_devices.stubHardDrive)
 #define DEV_hd_bmdma_read_sector(a,b,c) bx_devices.pluginHardDrive->bmdma_read_sector(a,b,c)
 #define DEV_hd_bmdma_write_sector(a,b) bx_devices.pluginHardDrive->bmdma_write_sector(a,b)
+#define DEV_hd_bmdma_bulk_io(a) bx_devices.pluginHardDrive->bmdma_bulk_io(a)
+#define DEV_hd_bmdma_read_sectors(a,b,c) bx_devices.pluginHardDrive->bmdma_read_sectors(a,b,c)
+#define DEV_hd_bmdma_write_sectors(a,b,c) bx_devices.pluginHardDrive->bmdma_write_sectors(a,b,c)
 #define DEV_hd_bmdma_complete(a) bx_devices.pluginHardDrive->bmdma_complete(a)
 
 #define DEV_bulk_io_quantum_requested() (bx_devices.bulkIOQuantumsRequested)
@@ -198,9 +204,11 @@ extern "C" {
 #define DEV_speaker_beep_on(frequency) bx_devices.pluginSpeaker->beep_on(frequency)
 #define DEV_speaker_beep_off() bx_devices.pluginSpeaker->beep_off()
 
-///////// Serial macro
+///////// Serial macros
 #define DEV_serial_mouse_enq(dx, dy, dz, state) \
     (bx_devices.pluginSerialDevice->serial_mouse_enq(dx, dy, dz, state))
+#define DEV_serial_inject_bytes(port, bytes, count) \
+    (bx_devices.pluginSerialDevice->inject_bytes(port, bytes, count))
 
 ///////// BUS mouse macro
 #define DEV_bus_mouse_enq(dx, dy, dz, state) \
@@ -0,0 +1,223 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+
+#include "bochs.h"
+#define LOG_THIS bx_profiler.
+
+bx_profiler_c bx_profiler;
+
+#define BX_PROF_INITIAL_SIZE  4096
+#define BX_PROF_NAME_LEN      128
+#define BX_PROF_TOP           10
+
+#define BX_PROF_HASH(eip, cr3, cpl) \
+  ((Bit32u)(eip) * 2654435761u ^ (Bit32u)((cr3) >> 12) ^ (cpl))
+
+bx_profiler_c::bx_profiler_c(void)
+{
+  put("PROF");
+  timer_id = BX_NULL_TIMER_HANDLE;
+  table = NULL;
+  table_size = table_used = 0;
+  total_samples = 0;
+}
+
+bx_profiler_c::~bx_profiler_c(void)
+{
+  delete [] table;
+}
+
+  void
+bx_profiler_c::init(void)
+{
+  if (!bx_options.profile.Oenabled->get ()) return;
+
+  const char *symfile = bx_options.profile.Osymbols->getptr ();
+  if (symfile[0]) {
+    int count = bx_symbol_context(0, 1)->load(symfile, 0);
+    if (count < 0)
+      BX_ERROR(("can not read symbols from '%s'", symfile));
+    else
+      BX_INFO(("%d symbols loaded from '%s'", count, symfile));
+  }
+
+  period = bx_options.profile.Operiod->get ();
+  if (period < 100) period = 100;
+  seed = 1;
+  table_size = BX_PROF_INITIAL_SIZE;
+  table = new bx_prof_sample_t[table_size];
+  memset(table, 0, table_size * sizeof(bx_prof_sample_t));
+  timer_id = bx_pc_system.register_timer_ticks(this, timer_handler,
+      next_period(), 0, 1, "profiler");
+  BX_INFO(("sampling guest every %u instructions", period));
+}
+
+  void
+bx_profiler_c::exit(void)
+{
+  if (table == NULL) return;
+  if (timer_id != BX_NULL_TIMER_HANDLE) {
+    bx_pc_system.deactivate_timer(timer_id);
+  }
+  write_report(bx_options.profile.Ofile->getptr ());
+  delete [] table;
+  table = NULL;
+}
+
+// Uniformly distributed in [period/2, 3*period/2), so the mean sampling
+// interval stays at 'period'.
+  Bit32u
+bx_profiler_c::next_period(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return period / 2 + (seed >> 8) % period;
+}
+
+  void
+bx_profiler_c::timer_handler(void *this_ptr)
+{
+  bx_profiler_c *class_ptr = (bx_profiler_c *) this_ptr;
+
+  for (unsigned cpu=0; cpu<BX_SMP_PROCESSORS; cpu++) {
+    class_ptr->sample(cpu);
+  }
+  bx_pc_system.activate_timer_ticks(class_ptr->timer_id,
+      class_ptr->next_period(), 0);
+}
+
+  void
+bx_profiler_c::sample(unsigned cpu)
+{
+  bx_address eip = BX_CPU(cpu)->get_linear_ip();
+  Bit32u cpl = BX_CPU(cpu)->get_CPL();
+#if BX_CPU_LEVEL >= 3
+  bx_address cr3 = BX_CPU(cpu)->cr3;
+#else
+  bx_address cr3 = 0;
+#endif
+
+  Bit32u mask = table_size - 1;
+  Bit32u i = BX_PROF_HASH(eip, cr3, cpl) & mask;
+  while (table[i].count) {
+    if (table[i].eip == eip && table[i].cr3 == cr3 && table[i].cpl == cpl) {
+      table[i].count++;
+      total_samples++;
+      return;
+    }
+    i = (i + 1) & mask;
+  }
+  table[i].eip = eip;
+  table[i].cr3 = cr3;
+  table[i].cpl = cpl;
+  table[i].count = 1;
+  total_samples++;
+  if (++table_used > table_size / 4 * 3) grow();
+}
+
+  void
+bx_profiler_c::grow(void)
+{
+  bx_prof_sample_t *old = table;
+  Bit32u old_size = table_size;
+
+  table_size *= 2;
+  table = new bx_prof_sample_t[table_size];
+  memset(table, 0, table_size * sizeof(bx_prof_sample_t));
+  Bit32u mask = table_size - 1;
+  for (Bit32u n=0; n<old_size; n++) {
+    if (old[n].count == 0) continue;
+    Bit32u i = BX_PROF_HASH(old[n].eip, old[n].cr3, old[n].cpl) & mask;
+    while (table[i].count) i = (i + 1) & mask;
+    table[i] = old[n];
+  }
+  delete [] old;
+}
+
+typedef struct {
+  char   name[BX_PROF_NAME_LEN];
+  Bit64u count;
+} bx_prof_line_t;
+
+static int prof_cmp_name(const void *a, const void *b)
+{
+  return strcmp(((const bx_prof_line_t *) a)->name,
+                ((const bx_prof_line_t *) b)->name);
+}
+
+static int prof_cmp_count(const void *a, const void *b)
+{
+  Bit64u ca = ((const bx_prof_line_t *) a)->count;
+  Bit64u cb = ((const bx_prof_line_t *) b)->count;
+  return (ca < cb) ? 1 : (ca > cb) ? -1 : 0;
+}
+
+// Samples that resolve to the same function are merged, so the report has
+// one line per function and address space.  Without symbols every EIP
+// gets its own line.
+  void
+bx_profiler_c::write_report(const char *fname)
+{
+  bx_prof_line_t *lines = new bx_prof_line_t[table_used + 1];
+  Bit32u nlines = 0, n;
+
+  for (n=0; n<table_size; n++) {
+    bx_prof_sample_t *s = &table[n];
+    if (s->count == 0) continue;
+    Bit32u offset;
+    const char *sym = bx_symbol_lookup((Bit32u)(s->cr3 >> 12), (Bit32u) s->eip, &offset);
+    if (sym) {
+      snprintf(lines[nlines].name, BX_PROF_NAME_LEN, "cpl%u;cr3_%08x;%s",
+        s->cpl, (Bit32u) s->cr3, sym);
+    } else {
+      snprintf(lines[nlines].name, BX_PROF_NAME_LEN, "cpl%u;cr3_%08x;0x%08x",
+        s->cpl, (Bit32u) s->cr3, (Bit32u) s->eip);
+    }
+    lines[nlines].count = s->count;
+    nlines++;
+  }
+
+  qsort(lines, nlines, sizeof(bx_prof_line_t), prof_cmp_name);
+  Bit32u merged = 0;
+  for (n=0; n<nlines; n++) {
+    if (merged > 0 && !strcmp(lines[merged-1].name, lines[n].name)) {
+      lines[merged-1].count += lines[n].count;
+    } else {
+      lines[merged++] = lines[n];
+    }
+  }
+  nlines = merged;
+
+  FILE *fp = fopen(fname, "w");
+  if (fp == NULL) {
+    BX_ERROR(("can not write profile to '%s'", fname));
+  } else {
+    for (n=0; n<nlines; n++) {
+      fprintf(fp, "%s " FMT_LL "u\n", lines[n].name, lines[n].count);
+    }
+    fclose(fp);
+    BX_INFO(("wrote " FMT_LL "u samples in %u lines to '%s'",
+      total_samples, nlines, fname));
+  }
+
+  qsort(lines, nlines, sizeof(bx_prof_line_t), prof_cmp_count);
+  for (n=0; n<nlines && n<BX_PROF_TOP; n++) {
+    BX_INFO(("%5.1f%% %s", 100.0 * lines[n].count / total_samples, lines[n].name));
+  }
+  delete [] lines;
+}
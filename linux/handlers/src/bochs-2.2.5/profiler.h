@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Sampling profiler for guest code.
+//
+// A one-shot system timer fires about every 'period' ticks (with some
+// jitter, so that the samples do not lock onto periodic guest activity
+// such as the timer interrupt) and records EIP, CPL and CR3 of every CPU
+// in a hash table.  On exit the samples are resolved to symbols (see
+// symbols.h; loaded from the 'symbols' option or with the debugger's
+// ldsym command) and written in the folded stack format used by
+// flamegraph.pl:
+//
+//   cpl0;cr3_00000000;sys_read 1234
+
+#ifndef BX_PROFILER_H
+#define BX_PROFILER_H
+
+typedef struct {
+  bx_address eip;           // linear address
+  bx_address cr3;
+  Bit32u     cpl;
+  Bit32u     count;         // 0 marks a free slot
+} bx_prof_sample_t;
+
+class BOCHSAPI bx_profiler_c : private logfunctions {
+public:
+  bx_profiler_c(void);
+  ~bx_profiler_c(void);
+
+  void init(void);
+  void exit(void);
+
+private:
+  static void timer_handler(void *this_ptr);
+  void   sample(unsigned cpu);
+  void   grow(void);
+  Bit32u next_period(void);
+  void   write_report(const char *fname);
+
+  int     timer_id;
+  Bit32u  period;
+  Bit32u  seed;             // jitter generator state
+
+  bx_prof_sample_t *table;
+  Bit32u  table_size;       // power of 2
+  Bit32u  table_used;
+  Bit64u  total_samples;
+};
+
+extern bx_profiler_c bx_profiler;
+
+#endif // BX_PROFILER_H
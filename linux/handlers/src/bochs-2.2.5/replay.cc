@@ -0,0 +1,437 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+
+#include "bochs.h"
+#include "iodev/iodev.h"
+#define LOG_THIS bx_replay.
+
+bx_replay_c bx_replay;
+
+static const char replay_magic[8] = { 'B', 'X', 'R', 'P', 'L', 'Y', '0', '1' };
+
+static const char *replay_type_name[BX_REPLAY_NTYPES] = {
+  "?", "time0", "key", "mouse", "paste", "inject", "inject_avail",
+  "serial_rx", "net_rx", "end"
+};
+
+// Little endian base 128 numbers, 7 bits per byte.
+static unsigned replay_put_varint(Bit8u *buf, Bit64u val)
+{
+  unsigned n = 0;
+  while (val >= 0x80) {
+    buf[n++] = (Bit8u) (val | 0x80);
+    val >>= 7;
+  }
+  buf[n++] = (Bit8u) val;
+  return n;
+}
+
+static Bit64u replay_get_varint(const Bit8u **p, const Bit8u *end)
+{
+  Bit64u val = 0;
+  unsigned shift = 0;
+  while (*p < end && shift < 64) {
+    Bit8u byte = *(*p)++;
+    val |= (Bit64u) (byte & 0x7f) << shift;
+    if (!(byte & 0x80)) break;
+    shift += 7;
+  }
+  return val;
+}
+
+static bx_bool replay_read_varint(FILE *fp, Bit64u *val)
+{
+  unsigned shift = 0;
+  int byte;
+  *val = 0;
+  do {
+    if ((byte = getc(fp)) == EOF || shift >= 64) return 0;
+    *val |= (Bit64u) (byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return 1;
+}
+
+#define ZIGZAG(v)   (((Bit32u) (v) << 1) ^ (Bit32u) ((Bit32s) (v) >> 31))
+#define UNZIGZAG(v) ((Bit32s) (((Bit32u) (v) >> 1) ^ (0 - ((Bit32u) (v) & 1))))
+
+bx_replay_c::bx_replay_c(void)
+{
+  put("RPLY");
+  mode = BX_REPLAY_MODE_NONE;
+  fp = NULL;
+  timer_id = BX_NULL_TIMER_HANDLE;
+  records = flushed = 0;
+  gui_polls = 0;
+  memset(polls, 0, sizeof(polls));
+  memset(last, 0, sizeof(last));
+  memset(&next, 0, sizeof(next));
+  memset(rx_handler, 0, sizeof(rx_handler));
+}
+
+bx_replay_c::~bx_replay_c(void)
+{
+  delete [] next.data;
+}
+
+// Called before the devices are initialized, so that the CMOS start time
+// and the clock synchronisation are already covered.
+  void
+bx_replay_c::init(void)
+{
+  unsigned m = bx_options.replay.Omode->get ();
+  char *fname = bx_options.replay.Ofile->getptr ();
+
+  if (m == BX_REPLAY_MODE_NONE) return;
+
+  if (bx_options.clock.Osync->get () == BX_CLOCK_SYNC_REALTIME ||
+      bx_options.clock.Osync->get () == BX_CLOCK_SYNC_BOTH) {
+    BX_ERROR(("clock sync=realtime is not deterministic, disabled for %s",
+      m == BX_REPLAY_MODE_RECORD ? "recording" : "replay"));
+    bx_options.clock.Osync->set (
+      bx_options.clock.Osync->get () == BX_CLOCK_SYNC_BOTH ?
+      BX_CLOCK_SYNC_SLOWDOWN : BX_CLOCK_SYNC_NONE);
+  }
+
+  if (m == BX_REPLAY_MODE_RECORD) {
+    fp = fopen(fname, "wb");
+    if (fp == NULL) {
+      BX_PANIC(("can not create replay log '%s'", fname));
+      return;
+    }
+    fwrite(replay_magic, 1, sizeof(replay_magic), fp);
+    BX_INFO(("recording host input to '%s'", fname));
+  } else {
+    char magic[sizeof(replay_magic)];
+    fp = fopen(fname, "rb");
+    if (fp == NULL) {
+      BX_PANIC(("can not open replay log '%s'", fname));
+      return;
+    }
+    if (fread(magic, 1, sizeof(magic), fp) != sizeof(magic) ||
+        memcmp(magic, replay_magic, sizeof(magic))) {
+      BX_PANIC(("'%s' is not a replay log", fname));
+      fclose(fp);
+      fp = NULL;
+      return;
+    }
+    timer_id = bx_pc_system.register_timer_ticks(this, timer_handler,
+        1, 0, 0, "replay");
+    BX_INFO(("replaying host input from '%s'", fname));
+  }
+  mode = m;
+  if (replaying()) {
+    read_record();
+    arm_timer();
+  }
+}
+
+  void
+bx_replay_c::exit(void)
+{
+  if (recording()) {
+    put_record(BX_REPLAY_END, 0, bx_pc_system.time_ticks(), NULL, 0);
+    BX_INFO(("recorded " FMT_LL "u inputs in " FMT_LL "u ticks",
+      records - 1, bx_pc_system.time_ticks()));
+  } else if (replaying()) {
+    if (next.valid && next.type == BX_REPLAY_END) {
+      BX_INFO(("replay stopped at tick " FMT_LL "u, the recorded run ended at tick " FMT_LL "u",
+        bx_pc_system.time_ticks(), next.count));
+    } else {
+      BX_INFO(("replay stopped at tick " FMT_LL "u after " FMT_LL "u inputs",
+        bx_pc_system.time_ticks(), records));
+    }
+  }
+  if (fp != NULL) {
+    fclose(fp);
+    fp = NULL;
+  }
+  mode = BX_REPLAY_MODE_NONE;
+}
+
+// The rest of the run is driven by the host again.
+  void
+bx_replay_c::finish(const char *why)
+{
+  BX_INFO(("%s at tick " FMT_LL "u after " FMT_LL "u inputs, continuing with host input",
+    why, bx_pc_system.time_ticks(), records));
+  if (timer_id != BX_NULL_TIMER_HANDLE)
+    bx_pc_system.deactivate_timer(timer_id);
+  fclose(fp);
+  fp = NULL;
+  next.valid = 0;
+  mode = BX_REPLAY_MODE_NONE;
+}
+
+  void
+bx_replay_c::put_record(unsigned type, unsigned unit, Bit64u count,
+                        const Bit8u *data, unsigned len)
+{
+  Bit8u hdr[2 + 10 + 5];
+  unsigned n = 0;
+
+  hdr[n++] = type;
+  hdr[n++] = unit;
+  n += replay_put_varint(hdr + n, count - last[type][unit]);
+  n += replay_put_varint(hdr + n, len);
+  last[type][unit] = count;
+  fwrite(hdr, 1, n, fp);
+  if (len > 0) fwrite(data, 1, len, fp);
+  records++;
+}
+
+  void
+bx_replay_c::read_record(void)
+{
+  Bit64u delta, len;
+  int type, unit;
+
+  next.valid = 0;
+  if ((type = getc(fp)) == EOF) return;
+  if ((unit = getc(fp)) == EOF || !replay_read_varint(fp, &delta) ||
+      !replay_read_varint(fp, &len)) {
+    BX_ERROR(("replay log is truncated"));
+    return;
+  }
+  if (type == 0 || type >= BX_REPLAY_NTYPES || unit >= BX_REPLAY_NUNITS ||
+      len > 0x1000000) {
+    BX_PANIC(("replay log is corrupt (type %d unit %d length " FMT_LL "u)",
+      type, unit, len));
+    return;
+  }
+  if (len > next.size) {
+    delete [] next.data;
+    next.size = (unsigned) len;
+    next.data = new Bit8u[next.size];
+  }
+  if (fread(next.data, 1, (size_t) len, fp) != len) {
+    BX_ERROR(("replay log is truncated"));
+    return;
+  }
+  next.type = type;
+  next.unit = unit;
+  next.count = last[type][unit] += delta;
+  next.len = (unsigned) len;
+  next.valid = 1;
+}
+
+// Is the next logged record the one for this point of the run?  Input is
+// logged and consumed in the same order, so a record of the same kind
+// with a smaller count means that the run has diverged.
+  bx_bool
+bx_replay_c::match(unsigned type, unsigned unit, Bit64u count)
+{
+  if (!next.valid || next.type != type || next.unit != unit)
+    return 0;
+  if (next.count < count) {
+    BX_PANIC(("replay diverged: %s input %u of unit %u was not consumed at tick " FMT_LL "u",
+      replay_type_name[type], (unsigned) next.count, unit, bx_pc_system.time_ticks()));
+    finish("replay diverged");
+    return 0;
+  }
+  return next.count == count;
+}
+
+  bx_bool
+bx_replay_c::poll_logged(unsigned type, unsigned unit, bx_bool ready, Bit8u *data)
+{
+  Bit64u count = polls[type][unit]++;
+
+  if (recording()) {
+    if (ready) put_record(type, unit, count, data, data ? 1 : 0);
+    return ready;
+  }
+  if (!match(type, unit, count)) return 0;
+  if (data != NULL && next.len > 0) *data = next.data[0];
+  records++;
+  read_record();
+  arm_timer();
+  if (!next.valid) finish("end of replay log");
+  return 1;
+}
+
+  Bit64u
+bx_replay_c::time0(Bit64u host_time)
+{
+  Bit8u buf[8];
+
+  if (recording()) {
+    for (unsigned n=0; n<8; n++) buf[n] = (Bit8u) (host_time >> (n * 8));
+    put_record(BX_REPLAY_TIME0, 0, 0, buf, 8);
+  } else if (replaying()) {
+    if (!match(BX_REPLAY_TIME0, 0, 0) || next.len != 8) {
+      BX_PANIC(("replay log does not start with the CMOS time"));
+      return host_time;
+    }
+    host_time = 0;
+    for (unsigned n=0; n<8; n++) host_time |= (Bit64u) next.data[n] << (n * 8);
+    records++;
+    read_record();
+    arm_timer();
+  }
+  return host_time;
+}
+
+  void
+bx_replay_c::gen_scancode(Bit32u key)
+{
+  if (recording()) {
+    Bit8u buf[10];
+    put_record(BX_REPLAY_KEY, 0, gui_polls, buf, replay_put_varint(buf, key));
+  } else if (replaying()) {
+    return;
+  }
+  bx_devices.pluginKeyboard->gen_scancode(key);
+}
+
+  void
+bx_replay_c::mouse_motion(int delta_x, int delta_y, int delta_z, unsigned button_state)
+{
+  if (recording()) {
+    Bit8u buf[4 * 10];
+    unsigned n = 0;
+    n += replay_put_varint(buf + n, ZIGZAG(delta_x));
+    n += replay_put_varint(buf + n, ZIGZAG(delta_y));
+    n += replay_put_varint(buf + n, ZIGZAG(delta_z));
+    n += replay_put_varint(buf + n, button_state);
+    put_record(BX_REPLAY_MOUSE, 0, gui_polls, buf, n);
+  } else if (replaying()) {
+    return;
+  }
+  bx_devices.pluginKeyboard->mouse_motion(delta_x, delta_y, delta_z, button_state);
+}
+
+  void
+bx_replay_c::paste_bytes(Bit8u *bytes, Bit32s length)
+{
+  if (recording()) {
+    put_record(BX_REPLAY_PASTE, 0, gui_polls, bytes, length);
+  } else if (replaying()) {
+    delete [] bytes;
+    return;
+  }
+  bx_devices.pluginKeyboard->paste_bytes(bytes, length);
+}
+
+// Gui input is delivered where the gui is polled for it, with the input
+// logged during the n-th poll replayed right before the n-th poll.
+  void
+bx_replay_c::gui_poll(void)
+{
+  gui_polls++;
+  if (recording()) {
+    // keep the log usable if Bochs gets killed
+    if (records != flushed) {
+      fflush(fp);
+      flushed = records;
+    }
+    return;
+  }
+  if (!replaying()) return;
+
+  while (next.valid && next.count <= gui_polls &&
+         (next.type == BX_REPLAY_KEY || next.type == BX_REPLAY_MOUSE ||
+          next.type == BX_REPLAY_PASTE)) {
+    const Bit8u *p = next.data, *end = next.data + next.len;
+    switch (next.type) {
+      case BX_REPLAY_KEY:
+        bx_devices.pluginKeyboard->gen_scancode((Bit32u) replay_get_varint(&p, end));
+        break;
+      case BX_REPLAY_MOUSE:
+        {
+          int dx = UNZIGZAG(replay_get_varint(&p, end));
+          int dy = UNZIGZAG(replay_get_varint(&p, end));
+          int dz = UNZIGZAG(replay_get_varint(&p, end));
+          unsigned state = (unsigned) replay_get_varint(&p, end);
+          bx_devices.pluginKeyboard->mouse_motion(dx, dy, dz, state);
+        }
+        break;
+      case BX_REPLAY_PASTE:
+        {
+          // the keyboard deletes the paste buffer when done
+          Bit8u *bytes = new Bit8u[next.len];
+          memcpy(bytes, next.data, next.len);
+          bx_devices.pluginKeyboard->paste_bytes(bytes, next.len);
+        }
+        break;
+    }
+    records++;
+    read_record();
+  }
+  arm_timer();
+  if (!next.valid) finish("end of replay log");
+}
+
+  void
+bx_replay_c::set_rx_handler(unsigned unit, bx_replay_rx_handler_t rx, void *arg)
+{
+  if (unit >= BX_REPLAY_NUNITS) return;
+  rx_handler[unit].rx = rx;
+  rx_handler[unit].arg = arg;
+}
+
+  bx_bool
+bx_replay_c::net_rx(unsigned unit, const void *buf, unsigned len)
+{
+  if (recording()) {
+    put_record(BX_REPLAY_NET_RX, unit, bx_pc_system.time_ticks(),
+      (const Bit8u *) buf, len);
+  }
+  return !replaying();
+}
+
+// Frames and the end of the run are delivered by tick count, with a
+// one-shot timer armed for the next such record.
+  void
+bx_replay_c::arm_timer(void)
+{
+  if (!next.valid || timer_id == BX_NULL_TIMER_HANDLE) return;
+  if (next.type != BX_REPLAY_NET_RX && next.type != BX_REPLAY_END) return;
+
+  Bit64u now = bx_pc_system.time_ticks();
+  bx_pc_system.activate_timer_ticks(timer_id,
+    (next.count > now) ? next.count - now : 1, 0);
+}
+
+  void
+bx_replay_c::timer_handler(void *this_ptr)
+{
+  bx_replay_c *class_ptr = (bx_replay_c *) this_ptr;
+  Bit64u now = bx_pc_system.time_ticks();
+
+  while (class_ptr->replaying() && class_ptr->next.valid &&
+         class_ptr->next.count <= now) {
+    if (class_ptr->next.type == BX_REPLAY_END) {
+      class_ptr->finish("end of the recorded run");
+      return;
+    }
+    if (class_ptr->next.type != BX_REPLAY_NET_RX) break;
+    unsigned unit = class_ptr->next.unit;
+    if (class_ptr->rx_handler[unit].rx != NULL) {
+      class_ptr->rx_handler[unit].rx(class_ptr->rx_handler[unit].arg,
+        class_ptr->next.data, class_ptr->next.len);
+    }
+    class_ptr->records++;
+    class_ptr->read_record();
+  }
+  if (class_ptr->replaying()) {
+    class_ptr->arm_timer();
+    if (!class_ptr->next.valid) class_ptr->finish("end of replay log");
+  }
+}
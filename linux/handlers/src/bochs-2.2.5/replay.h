@@ -0,0 +1,138 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Record/replay of host input.
+//
+// The device models are driven by the emulated clock only, so a run is
+// fully determined by the configuration, the disk images and the input
+// that comes from the host: keys, mouse moves and pastes from the gui,
+// bytes taken from the keyboard and serial injection queues, bytes read
+// from serial host ports, frames from the network packet mover and the
+// initial CMOS time.  In record mode these inputs are appended to a log.
+// In replay mode the host input is dropped and the devices get the logged
+// input at the same point of the emulation instead, so the run repeats
+// instruction by instruction.  Interrupts, disk completions and timer
+// ticks are not logged, they follow from the device models.
+//
+// Input that a device polls (injection queues, serial ports) is matched
+// by the number of times that poll site has been reached, gui input by
+// the number of gui event polls and network frames by the tick count.
+// Host time synchronisation (clock: sync=realtime) is turned off while
+// recording or replaying.
+//
+// The log starts with an 8 byte magic, followed by records of
+//
+//   Bit8u type, Bit8u unit, varint count delta, varint length, data
+//
+// where the count is relative to the previous record of the same type
+// and unit.
+
+#ifndef BX_REPLAY_H
+#define BX_REPLAY_H
+
+#define BX_REPLAY_TIME0         1   // initial CMOS time, 8 bytes
+#define BX_REPLAY_KEY           2   // gen_scancode(), varint key
+#define BX_REPLAY_MOUSE         3   // mouse_motion(), 4 varints
+#define BX_REPLAY_PASTE         4   // paste_bytes(), the bytes
+#define BX_REPLAY_INJECT_GET    5   // byte taken from an injection queue
+#define BX_REPLAY_INJECT_AVAIL  6   // injection queue was found not empty
+#define BX_REPLAY_SERIAL_RX     7   // byte read from a serial host port
+#define BX_REPLAY_NET_RX        8   // frame from the packet mover
+#define BX_REPLAY_END           9   // end of the recorded run
+#define BX_REPLAY_NTYPES        10
+#define BX_REPLAY_NUNITS        8
+
+// units of the injection queues
+#define BX_REPLAY_UNIT_KBD      0
+#define BX_REPLAY_UNIT_COM(n)   (1 + (n))
+#define BX_REPLAY_UNIT_NONE     0xff
+
+typedef void (*bx_replay_rx_handler_t)(void *arg, const void *buf, unsigned len);
+
+class BOCHSAPI bx_replay_c : private logfunctions {
+public:
+  bx_replay_c(void);
+  ~bx_replay_c(void);
+
+  void init(void);
+  void exit(void);
+
+  bx_bool active(void) const { return mode != BX_REPLAY_MODE_NONE; }
+  bx_bool recording(void) const { return mode == BX_REPLAY_MODE_RECORD; }
+  bx_bool replaying(void) const { return mode == BX_REPLAY_MODE_REPLAY; }
+
+  // Polled input.  'ready' and 'data' are the result of polling the host,
+  // which is logged when recording.  When replaying the host must not be
+  // polled; the logged result for this poll is returned instead.
+  BX_CPP_INLINE bx_bool poll(unsigned type, unsigned unit, bx_bool ready, Bit8u *data) {
+    if (mode == BX_REPLAY_MODE_NONE) return ready;
+    return poll_logged(type, unit, ready, data);
+  }
+  Bit64u time0(Bit64u host_time);
+
+  // Gui input, forwarded to the keyboard unless replaying.
+  void gen_scancode(Bit32u key);
+  void mouse_motion(int delta_x, int delta_y, int delta_z, unsigned button_state);
+  void paste_bytes(Bit8u *bytes, Bit32s length);
+  // called before every bx_gui->handle_events()
+  void gui_poll(void);
+
+  // Network frames: net_rx() returns 1 if the caller should deliver the
+  // host frame.  Replayed frames go to the handler set for the unit,
+  // which must hand them to the NIC itself, without asking net_rx().
+  void set_rx_handler(unsigned unit, bx_replay_rx_handler_t rx, void *arg);
+  bx_bool net_rx(unsigned unit, const void *buf, unsigned len);
+
+private:
+  bx_bool poll_logged(unsigned type, unsigned unit, bx_bool ready, Bit8u *data);
+  void    put_record(unsigned type, unsigned unit, Bit64u count,
+                     const Bit8u *data, unsigned len);
+  void    read_record(void);
+  bx_bool match(unsigned type, unsigned unit, Bit64u count);
+  void    arm_timer(void);
+  void    finish(const char *why);
+  static void timer_handler(void *this_ptr);
+
+  unsigned mode;
+  FILE    *fp;
+  int      timer_id;
+  Bit64u   records;
+  Bit64u   flushed;         // records at the last fflush()
+  Bit64u   gui_polls;
+  Bit64u   polls[BX_REPLAY_NTYPES][BX_REPLAY_NUNITS];
+  Bit64u   last[BX_REPLAY_NTYPES][BX_REPLAY_NUNITS];
+
+  // the next record when replaying
+  struct {
+    bx_bool  valid;
+    unsigned type, unit;
+    Bit64u   count;
+    unsigned len;
+    Bit8u   *data;
+    unsigned size;
+  } next;
+
+  struct {
+    bx_replay_rx_handler_t rx;
+    void *arg;
+  } rx_handler[BX_REPLAY_NUNITS];
+};
+
+extern bx_replay_c bx_replay;
+
+#endif // BX_REPLAY_H
@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+
+#include "bochs.h"
+#include "iodev/iodev.h"
+#define LOG_THIS bx_stats.
+
+#if BX_SUPPORT_STATS
+
+bx_stats_c bx_stats;
+
+static const char *exception_name[32] = {
+  "DE", "DB", "NMI", "BP", "OF", "BR", "UD", "NM",
+  "DF", "CSO", "TS", "NP", "SS", "GP", "PF", "15",
+  "MF", "AC", "MC", "XM", "20", "21", "22", "23",
+  "24", "25", "26", "27", "28", "29", "30", "31"
+};
+
+bx_stats_c::bx_stats_c(void)
+{
+  put("STAT");
+  timer_id = BX_NULL_TIMER_HANDLE;
+  fp = NULL;
+}
+
+  void
+bx_stats_c::init(void)
+{
+  bx_list_c *root = new bx_list_c (BXP_STATS, "stats",
+      "Self-profiling counters", BX_SMP_PROCESSORS + 3);
+
+  for (unsigned n=0; n<BX_SMP_PROCESSORS; n++) {
+    bx_cpu_stats_t *s = &BX_CPU(n)->stats;
+    char name[16];
+
+    sprintf(name, "cpu%u", n);
+    bx_list_c *cpu = new bx_list_c (BXP_NULL, strdup(name), "", 6);
+    bx_list_c *list = new bx_list_c (BXP_NULL, "icache", "", 2);
+    list->add (new bx_shadow_num_c (BXP_NULL, "hits", "", &s->icache_hits));
+    list->add (new bx_shadow_num_c (BXP_NULL, "misses", "", &s->icache_misses));
+    cpu->add (list);
+    list = new bx_list_c (BXP_NULL, "tlb", "", 4);
+    list->add (new bx_shadow_num_c (BXP_NULL, "hits", "", &s->tlb_hits));
+    list->add (new bx_shadow_num_c (BXP_NULL, "misses", "", &s->tlb_misses));
+    list->add (new bx_shadow_num_c (BXP_NULL, "flushes", "", &s->tlb_flushes));
+    list->add (new bx_shadow_num_c (BXP_NULL, "invlpg", "", &s->tlb_invlpg));
+    cpu->add (list);
+    cpu->add (new bx_shadow_num_c (BXP_NULL, "phys_reads", "", &s->phys_reads));
+    cpu->add (new bx_shadow_num_c (BXP_NULL, "phys_writes", "", &s->phys_writes));
+    cpu->add (new bx_shadow_num_c (BXP_NULL, "async_events", "", &s->async_events));
+    list = new bx_list_c (BXP_NULL, "exceptions", "", 32);
+    for (unsigned v=0; v<32; v++) {
+      list->add (new bx_shadow_num_c (BXP_NULL, (char *) exception_name[v], "",
+          &s->exceptions[v]));
+    }
+    cpu->add (list);
+    root->add (cpu);
+  }
+  bx_devices.init_stats (root);
+  bx_pc_system.init_stats (root);
+
+  if (!bx_options.stats.Oenabled->get ()) return;
+
+  char *fname = bx_options.stats.Ofile->getptr ();
+  fp = fopen(fname, "w");
+  if (fp == NULL) {
+    BX_ERROR(("can not write stats to '%s'", fname));
+    return;
+  }
+  Bit32u period = bx_options.stats.Operiod->get ();
+  if (period > 0) {
+    timer_id = bx_pc_system.register_timer_ticks(this, timer_handler,
+        period, 1, 1, "stats");
+  }
+  BX_INFO(("writing stats to '%s'", fname));
+}
+
+  void
+bx_stats_c::exit(void)
+{
+  if (fp == NULL) return;
+  if (timer_id != BX_NULL_TIMER_HANDLE) {
+    bx_pc_system.deactivate_timer(timer_id);
+  }
+  dump();
+  fclose(fp);
+  fp = NULL;
+}
+
+  void
+bx_stats_c::timer_handler(void *this_ptr)
+{
+  ((bx_stats_c *) this_ptr)->dump();
+}
+
+// One JSON object per line, so that a running dump can be followed
+// with 'tail -f' and every line parsed on its own.
+  void
+bx_stats_c::dump(void)
+{
+  if (fp == NULL) return;
+  fprintf(fp, "{\"ticks\":" FMT_LL "u,\"stats\":", bx_pc_system.time_ticks());
+  write_list((bx_list_c *) SIM->get_param (BXP_STATS));
+  fputs("}\n", fp);
+  fflush(fp);
+}
+
+  void
+bx_stats_c::write_list(bx_list_c *list)
+{
+  fputc('{', fp);
+  for (int i=0; i<list->get_size (); i++) {
+    bx_param_c *param = list->get (i);
+    fprintf(fp, "%s\"%s\":", i ? "," : "", param->get_name ());
+    if (param->get_type () == BXT_LIST) {
+      write_list((bx_list_c *) param);
+    } else {
+      fprintf(fp, FMT_LL "u", ((bx_param_num_c *) param)->get64 ());
+    }
+  }
+  fputc('}', fp);
+}
+
+#endif
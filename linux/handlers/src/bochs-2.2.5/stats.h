@@ -0,0 +1,59 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Self-profiling counters.
+//
+// The counters themselves live next to the code they count: per CPU in
+// BX_CPU_C::stats (iCache, TLB, physical memory slow path, exceptions,
+// async events), per I/O handler in bx_devices_c and per timer in
+// bx_pc_system_c.  This module publishes all of them as a parameter tree
+// under BXP_STATS:
+//
+//   stats.cpu0.icache.hits ... stats.cpu0.exceptions.PF
+//   stats.io_read.<device>, stats.io_write.<device>
+//   stats.timers.<timer id>
+//
+// and, if the 'stats' option is enabled, appends the whole tree as one
+// JSON object per line to a file every 'period' ticks and at exit.
+
+#ifndef BX_STATS_H
+#define BX_STATS_H
+
+#if BX_SUPPORT_STATS
+
+class BOCHSAPI bx_stats_c : private logfunctions {
+public:
+  bx_stats_c(void);
+
+  void init(void);
+  void exit(void);
+  void dump(void);
+
+private:
+  static void timer_handler(void *this_ptr);
+  void   write_list(bx_list_c *list);
+
+  int     timer_id;
+  FILE   *fp;
+};
+
+extern bx_stats_c bx_stats;
+
+#endif
+
+#endif // BX_STATS_H
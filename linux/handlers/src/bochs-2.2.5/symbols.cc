@@ -0,0 +1,252 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "osdep.h"
+#include "symbols.h"
+
+#define BX_SYM_INITIAL_SYMS   1024
+#define BX_SYM_INITIAL_POOL   16384
+#define BX_SYM_MAX_CONTEXTS   64
+
+static bx_symbol_table_c *contexts[BX_SYM_MAX_CONTEXTS];
+static unsigned ncontexts = 0;
+
+bx_symbol_table_c::bx_symbol_table_c(Bit32u _context)
+{
+  context = _context;
+  syms = NULL;
+  nsyms = maxsyms = 0;
+  sorted = 1;
+  last = 0;
+  names = NULL;
+  pool = NULL;
+  pool_used = pool_size = 0;
+}
+
+bx_symbol_table_c::~bx_symbol_table_c()
+{
+  free(syms);
+  free(names);
+  free(pool);
+}
+
+  void
+bx_symbol_table_c::add(Bit32u start, const char *name)
+{
+  Bit32u len = strlen(name) + 1;
+
+  if (nsyms == maxsyms) {
+    maxsyms = maxsyms ? maxsyms * 2 : BX_SYM_INITIAL_SYMS;
+    syms = (bx_symbol_t *) realloc(syms, maxsyms * sizeof(bx_symbol_t));
+  }
+  if (pool_used + len > pool_size) {
+    if (pool_size == 0) pool_size = BX_SYM_INITIAL_POOL;
+    while (pool_used + len > pool_size) pool_size *= 2;
+    pool = (char *) realloc(pool, pool_size);
+  }
+  memcpy(pool + pool_used, name, len);
+  syms[nsyms].start = start;
+  syms[nsyms].name = pool_used;
+  pool_used += len;
+  if (nsyms > 0 && start < syms[nsyms-1].start) sorted = 0;
+  nsyms++;
+  free(names);
+  names = NULL;
+}
+
+  int
+bx_symbol_table_c::load(const char *fname, Bit32u offset)
+{
+  FILE *fp = fopen(fname, "rt"); // 't' is need for win32, unixes simply ignore it
+  if (fp == NULL) return -1;
+
+  char buf[512];
+  int count = 0;
+  while (fgets(buf, sizeof(buf), fp)) {
+    char *p = buf, *end;
+    Bit32u addr = strtoul(p, &end, 16);
+    // lines without an address, like undefined symbols in nm output
+    if (end == p || (*end != ' ' && *end != '\t')) continue;
+    p = end;
+    while (*p == ' ' || *p == '\t') p++;
+    // skip the symbol type of nm and System.map lines
+    if (p[0] && (p[1] == ' ' || p[1] == '\t')) {
+      p += 2;
+      while (*p == ' ' || *p == '\t') p++;
+    }
+    end = p + strlen(p);
+    while (end > p && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' '))
+      *--end = 0;
+    if (*p == 0) continue;
+    add(addr + offset, p);
+    count++;
+  }
+  fclose(fp);
+  return count;
+}
+
+static int sym_cmp_start(const void *a, const void *b)
+{
+  const bx_symbol_t *s1 = (const bx_symbol_t *) a;
+  const bx_symbol_t *s2 = (const bx_symbol_t *) b;
+  if (s1->start != s2->start) return (s1->start < s2->start) ? -1 : 1;
+  // keep symbols at the same address in the order they were added
+  return (s1->name < s2->name) ? -1 : (s1->name > s2->name);
+}
+
+static int sym_cmp_name(const void *a, const void *b)
+{
+  return strcmp(((const bx_symbol_name_t *) a)->name,
+                ((const bx_symbol_name_t *) b)->name);
+}
+
+  void
+bx_symbol_table_c::sort(void)
+{
+  if (sorted) return;
+  qsort(syms, nsyms, sizeof(bx_symbol_t), sym_cmp_start);
+  sorted = 1;
+  last = 0;
+}
+
+  void
+bx_symbol_table_c::sort_names(void)
+{
+  if (names) return;
+  names = (bx_symbol_name_t *) malloc((nsyms + 1) * sizeof(bx_symbol_name_t));
+  for (unsigned n=0; n<nsyms; n++) {
+    names[n].name = pool + syms[n].name;
+    names[n].start = syms[n].start;
+  }
+  qsort(names, nsyms, sizeof(bx_symbol_name_t), sym_cmp_name);
+}
+
+  const char *
+bx_symbol_table_c::lookup(Bit32u addr, Bit32u *offset)
+{
+  unsigned lo, hi;
+
+  sort();
+  // Consecutive lookups tend to hit the same function.
+  if (last + 1 < nsyms && syms[last].start <= addr && addr < syms[last+1].start) {
+    *offset = addr - syms[last].start;
+    return pool + syms[last].name;
+  }
+  // find the first symbol above addr
+  lo = 0;
+  hi = nsyms;
+  while (lo < hi) {
+    unsigned mid = (lo + hi) / 2;
+    if (syms[mid].start <= addr) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo == 0 || lo == nsyms) return NULL;
+  last = lo - 1;
+  *offset = addr - syms[last].start;
+  return pool + syms[last].name;
+}
+
+  bx_bool
+bx_symbol_table_c::find(const char *name, Bit32u *addr)
+{
+  int n = first_with_prefix(name);
+  if (n < 0 || strcmp(names[n].name, name)) return 0;
+  *addr = names[n].start;
+  return 1;
+}
+
+  unsigned
+bx_symbol_table_c::size(void)
+{
+  sort();
+  return nsyms;
+}
+
+  const char *
+bx_symbol_table_c::get(unsigned n, Bit32u *start)
+{
+  sort();
+  if (n >= nsyms) return NULL;
+  *start = syms[n].start;
+  return pool + syms[n].name;
+}
+
+  int
+bx_symbol_table_c::first_with_prefix(const char *prefix)
+{
+  size_t len = strlen(prefix);
+  unsigned lo = 0, hi = nsyms;
+
+  sort_names();
+  while (lo < hi) {
+    unsigned mid = (lo + hi) / 2;
+    if (strcmp(names[mid].name, prefix) < 0) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo == nsyms || strncmp(names[lo].name, prefix, len)) return -1;
+  return lo;
+}
+
+  const char *
+bx_symbol_table_c::get_by_name(unsigned n, Bit32u *start)
+{
+  sort_names();
+  if (n >= nsyms) return NULL;
+  *start = names[n].start;
+  return names[n].name;
+}
+
+  bx_symbol_table_c *
+bx_symbol_context(Bit32u context, bx_bool create)
+{
+  static unsigned last = 0;
+
+  if (last < ncontexts && contexts[last]->get_context() == context)
+    return contexts[last];
+  for (unsigned n=0; n<ncontexts; n++) {
+    if (contexts[n]->get_context() == context) {
+      last = n;
+      return contexts[n];
+    }
+  }
+  if (!create || ncontexts == BX_SYM_MAX_CONTEXTS) return NULL;
+  contexts[ncontexts] = new bx_symbol_table_c(context);
+  last = ncontexts;
+  return contexts[ncontexts++];
+}
+
+  const char *
+bx_symbol_lookup(Bit32u context, Bit32u addr, Bit32u *offset)
+{
+  bx_symbol_table_c *table = bx_symbol_context(context, 0);
+  const char *name = NULL;
+
+  if (table)
+    name = table->lookup(addr, offset);
+  if (name == NULL && context != 0) {
+    table = bx_symbol_context(0, 0);
+    if (table)
+      name = table->lookup(addr, offset);
+  }
+  return name;
+}
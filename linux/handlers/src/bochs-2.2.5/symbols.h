@@ -0,0 +1,83 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+// Guest symbol tables, shared by the debugger, the profiler and the
+// offline trace decoder.  This file and symbols.cc only depend on
+// config.h and osdep.h, so that tools outside of bochs can use them.
+//
+// Symbols are kept per context (page directory base >> 12, 0 for the
+// global context) in a flat array sorted by address.  A symbol covers
+// the interval from its address up to the next symbol; addresses
+// behind the last symbol have no symbol.  Names live in one string
+// pool, so loading a System.map is one allocation per few thousand
+// symbols and a single sort.
+
+#ifndef BX_SYMBOLS_H
+#define BX_SYMBOLS_H
+
+typedef struct {
+  Bit32u start;
+  Bit32u name;          // offset into the string pool
+} bx_symbol_t;
+
+typedef struct {
+  const char *name;
+  Bit32u start;
+} bx_symbol_name_t;
+
+class BOCHSAPI bx_symbol_table_c {
+public:
+  bx_symbol_table_c(Bit32u context);
+  ~bx_symbol_table_c();
+
+  Bit32u get_context(void) const { return context; }
+  void   add(Bit32u start, const char *name);
+  // Reads 'address name' lines as well as nm and System.map output
+  // ('address type name').  Returns the number of symbols or -1.
+  int    load(const char *fname, Bit32u offset);
+
+  const char *lookup(Bit32u addr, Bit32u *offset);
+  bx_bool find(const char *name, Bit32u *addr);
+
+  // in address order
+  unsigned size(void);
+  const char *get(unsigned n, Bit32u *start);
+  // in name order; first_with_prefix() returns -1 if there is no match
+  int    first_with_prefix(const char *prefix);
+  const char *get_by_name(unsigned n, Bit32u *start);
+
+private:
+  void   sort(void);
+  void   sort_names(void);
+
+  Bit32u context;
+  bx_symbol_t *syms;
+  unsigned nsyms, maxsyms;
+  bx_bool sorted;
+  unsigned last;        // index of the last lookup() hit
+  bx_symbol_name_t *names;  // built on demand
+  char  *pool;
+  Bit32u pool_used, pool_size;
+};
+
+// Returns the table for a context, creating it if requested.
+BOCHSAPI extern bx_symbol_table_c *bx_symbol_context(Bit32u context, bx_bool create);
+// Looks in the given context first and then in the global one.
+BOCHSAPI extern const char *bx_symbol_lookup(Bit32u context, Bit32u addr, Bit32u *offset);
+
+#endif // BX_SYMBOLS_H